@@ -6,6 +6,8 @@
 #include "BehaviorTree/BlackboardComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/Character.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
 
 UBTService_DetectPlayer::UBTService_DetectPlayer()
 {
@@ -48,8 +50,20 @@ void UBTService_DetectPlayer::TickNode(UBehaviorTreeComponent& OwnerComp, uint8*
 	FVector PlayerLocation = PlayerCharacter->GetActorLocation();
 	float Distance = FVector::Dist(AILocation, PlayerLocation);
 
-	// 检查玩家是否在索敌范围内
-	if (Distance <= DetectionRadius)
+	// 检查玩家是否在索敌范围内，且没有被墙挡住
+	bool bDetected = Distance <= DetectionRadius;
+	if (bDetected && bRequireLineOfSight)
+	{
+		if (AGridManager* GridMgr = UGridTacticsWorldSubsystem::GetGridManagerFor(GetWorld()))
+		{
+			const FIntPoint AIGrid = GridMgr->WorldToGrid(AILocation);
+			const FIntPoint PlayerGrid = GridMgr->WorldToGrid(PlayerLocation);
+			const int32 RadiusGrids = FMath::CeilToInt(DetectionRadius / 100.0f);
+			bDetected = GridMgr->IsGridInFieldOfView(AIGrid, RadiusGrids, PlayerGrid);
+		}
+	}
+
+	if (bDetected)
 	{
 		BlackboardComp->SetValueAsObject(TargetActorKey.SelectedKeyName, PlayerCharacter);
 		
@@ -64,7 +78,7 @@ void UBTService_DetectPlayer::TickNode(UBehaviorTreeComponent& OwnerComp, uint8*
 	{
 		BlackboardComp->ClearValue(TargetActorKey.SelectedKeyName);
 		
-		UE_LOG(LogTemp, Verbose, TEXT("BTService_DetectPlayer: Player out of range. Distance: %.1f / %.1f"), 
+		UE_LOG(LogTemp, Verbose, TEXT("BTService_DetectPlayer: Player out of range or hidden. Distance: %.1f / %.1f"), 
 			Distance, DetectionRadius);
 	}
 }
\ No newline at end of file
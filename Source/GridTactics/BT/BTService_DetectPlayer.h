@@ -24,6 +24,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "AI")
 	float DetectionRadius = 1000.0f;
 
+	// ҪҰɼ㷢֣ǽڵʹ GridManager ĻҰ
+	UPROPERTY(EditAnywhere, Category = "AI")
+	bool bRequireLineOfSight = true;
+
 	// ڱ༭ҪдĿڰ
 	UPROPERTY(EditAnywhere, Category = "AI")
 	FBlackboardKeySelector TargetActorKey;
@@ -6,6 +6,8 @@
 #include "GridTactics/EnemyCharacter.h"
 #include "GridTactics/GridMovement/GridMovementComponent.h"
 #include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridTopology.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
 #include "GridTactics/AttributesComponent.h"
 #include "Kismet/GameplayStatics.h"
 
@@ -56,9 +58,7 @@ EBTNodeResult::Type UBTTask_CalculateKitingPosition::ExecuteTask(UBehaviorTreeCo
 	UE_LOG(LogTemp, Log, TEXT("BTTask_CalculateKitingPosition: Target = %s"), *TargetPlayer->GetName());
 
 	// 获取 GridManager
-	AGridManager* GridMgr = Cast<AGridManager>(
-		UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass())
-	);
+	AGridManager* GridMgr = UGridTacticsWorldSubsystem::GetGridManagerFor(GetWorld());
 	if (!GridMgr)
 	{
 		UE_LOG(LogTemp, Error, TEXT("BTTask_CalculateKitingPosition: No GridManager in world!"));
@@ -155,11 +155,19 @@ EBTNodeResult::Type UBTTask_CalculateKitingPosition::ExecuteTask(UBehaviorTreeCo
 			TowardDirection.X = 0;
 		}
 		
-		// 生成接近候选点
-		for (int32 Step = 1; Step <= MaxMoveSteps; ++Step)
+		// 生成接近候选点：优先沿玩家所在格的共享流场前进（绕开墙体），流场走不通时退回直线方向
+		FIntPoint FlowGrid = EnemyGrid;
+		for (int32 Step = 1; Step <= MaxMoveSteps && GridMgr->GetFlowFieldStep(FlowGrid, PlayerGrid, FlowGrid); ++Step)
 		{
-			FIntPoint Candidate = EnemyGrid + (TowardDirection * Step);
-			CandidatePositions.Add(Candidate);
+			CandidatePositions.Add(FlowGrid);
+		}
+		if (CandidatePositions.Num() == 0)
+		{
+			for (int32 Step = 1; Step <= MaxMoveSteps; ++Step)
+			{
+				FIntPoint Candidate = EnemyGrid + (TowardDirection * Step);
+				CandidatePositions.Add(Candidate);
+			}
 		}
 	}
 	else
@@ -186,25 +194,35 @@ EBTNodeResult::Type UBTTask_CalculateKitingPosition::ExecuteTask(UBehaviorTreeCo
 		}
 		
 		// 添加一些随机偏移（增加不可预测性）
-		TArray<FIntPoint> RandomOffsets = {
-			FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1)
-		};
-		for (const FIntPoint& Offset : RandomOffsets)
+		FGridTopology4::ForEachNeighbor(EnemyGrid, [&CandidatePositions](FIntPoint Neighbor, int32)
 		{
-			CandidatePositions.Add(EnemyGrid + Offset);
-		}
+			CandidatePositions.Add(Neighbor);
+		});
 	}
 
-	// 过滤有效候选点
+	// 过滤有效候选点（与自身不连通的格子走不过去，直接剔除）
 	TArray<FIntPoint> ValidPositions;
 	for (const FIntPoint& Candidate : CandidatePositions)
 	{
-		if (IsPositionValid(GridMgr, Candidate, EnemyChar))
+		if (IsPositionValid(GridMgr, Candidate, EnemyChar) && GridMgr->AreConnected(EnemyGrid, Candidate))
 		{
 			ValidPositions.Add(Candidate);
 		}
 	}
 
+	// 远程 AI：优先保留能看到玩家的位置，全部被挡住时退回原候选
+	if (bRequireLineOfSight)
+	{
+		TArray<FIntPoint> VisiblePositions = ValidPositions.FilterByPredicate([GridMgr, PlayerGrid](const FIntPoint& Candidate)
+		{
+			return GridMgr->HasLineOfSight(Candidate, PlayerGrid, (int32)EGridSightBlocker::Walls);
+		});
+		if (VisiblePositions.Num() > 0)
+		{
+			ValidPositions = MoveTemp(VisiblePositions);
+		}
+	}
+
 	if (ValidPositions.Num() == 0)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("AI: No valid kiting positions found"));
@@ -45,6 +45,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Kiting", meta = (ClampMin = "1", ClampMax = "10"))
 	int32 MaxMoveSteps = 3;
 
+	/** 只选择能看到玩家的位置（墙体遮挡视线） */
+	UPROPERTY(EditAnywhere, Category = "Kiting")
+	bool bRequireLineOfSight = true;
+
 private:
 	/** 检查位置是否可行走 */
 	bool IsPositionValid(class AGridManager* GridMgr, FIntPoint GridPos, AActor* SelfActor) const;
@@ -4,6 +4,11 @@
 #include "AIController.h"
 #include "GridTactics/EnemyCharacter.h"
 #include "GridTactics/GridMovement/GridMovementComponent.h"
+#include "GridTactics/GridMovement/GridTopology.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/PathPlanner.h"
+#include "GridTactics/GridMovement/GridPathService.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
 #include "GridTactics/AttributesComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "GameFramework/Actor.h"
@@ -64,6 +69,7 @@ EBTNodeResult::Type UBTTask_MoveToGrid::ExecuteTask(UBehaviorTreeComponent& Owne
 
 	FVector TargetLocation;
 	bool bHasValidTarget = false;
+	AActor* ChaseTarget = nullptr;
 
 	// ✅ 修复：直接检查黑板键名是否有效，而不是使用 IsSet()
 	if (TargetLocationKey.SelectedKeyName != NAME_None)
@@ -97,6 +103,7 @@ EBTNodeResult::Type UBTTask_MoveToGrid::ExecuteTask(UBehaviorTreeComponent& Owne
 		{
 			TargetLocation = TargetActor->GetActorLocation();
 			bHasValidTarget = true;
+			ChaseTarget = TargetActor;
 			UE_LOG(LogTemp, Log, TEXT("BTTask_MoveToGrid: Got target from TargetActorKey: %s at %s"), 
 				*TargetActor->GetName(), *TargetLocation.ToString());
 		}
@@ -145,20 +152,68 @@ EBTNodeResult::Type UBTTask_MoveToGrid::ExecuteTask(UBehaviorTreeComponent& Owne
 	FVector DirectionToTarget = (TargetLocation - EnemyLocation).GetSafeNormal();
 	UE_LOG(LogTemp, Log, TEXT("BTTask_MoveToGrid: Direction = %s"), *DirectionToTarget.ToString());
 
-	int32 DeltaX = 0;
-	int32 DeltaY = 0;
-
 	// 四方向离散化
-	if (FMath::Abs(DirectionToTarget.X) > FMath::Abs(DirectionToTarget.Y))
-	{
-		DeltaX = (DirectionToTarget.X > 0) ? 1 : -1;
-		DeltaY = 0;
-	}
-	else
+	FIntPoint Delta = FGridTopology4::GetDirection(FGridTopology4::DirectionIndexFromYaw(DirectionToTarget.Rotation().Yaw));
+
+	// 寻路：取路径的第一步，找不到路径时保留直线方向
+	AGridManager* GridManager = UGridTacticsWorldSubsystem::GetGridManagerFor(EnemyChar);
+	if (bUsePathfinding && GridManager)
 	{
-		DeltaY = (DirectionToTarget.Y > 0) ? 1 : -1;
-		DeltaX = 0;
+		FGridPathConstraints Constraints;
+		Constraints.IgnoreActor = EnemyChar;
+		Constraints.MaxExpandedNodes = MaxPathSearchNodes;
+		Constraints.bAvoidOccupied = bAvoidOccupiedCells;
+
+		const FIntPoint StartGrid = GridManager->GetActorCurrentGrid(EnemyChar);
+		const FIntPoint GoalGrid = GridManager->WorldToGrid(TargetLocation);
+		const int32 GoalDistance = FMath::Abs(GoalGrid.X - StartGrid.X) + FMath::Abs(GoalGrid.Y - StartGrid.Y);
+		UGridPathService* PathService = bUseAsyncPathService ? UGridPathService::Get(EnemyChar) : nullptr;
+		const bool bSingleCell = GridMovementComp->GetFootprintSize() == 1;
+		FBTMoveToGridMemory* Memory = CastInstanceNodeMemory<FBTMoveToGridMemory>(NodeMemory);
+		FIntPoint NextGrid;
+		if (bUseFlowFieldForActorTarget && ChaseTarget && bSingleCell
+			&& GridManager->GetFlowFieldStep(StartGrid, GridManager->GetActorCurrentGrid(ChaseTarget), NextGrid))
+		{
+			// 追击目标：流场按目标所在格缓存，只在目标换格或地图变化时重建
+			Delta = NextGrid - StartGrid;
+			UE_LOG(LogTemp, Log, TEXT("BTTask_MoveToGrid: Flow field step to %s"), *NextGrid.ToString());
+		}
+		else if (HierarchicalPathDistance > 0 && GoalDistance >= HierarchicalPathDistance && bSingleCell
+			&& GetHierarchicalNextGrid(GridManager, *Memory, StartGrid, GoalGrid, Constraints, NextGrid))
+		{
+			// 远距离：沿保留的分层路径走，逐段细化
+			Delta = NextGrid - StartGrid;
+			UE_LOG(LogTemp, Log, TEXT("BTTask_MoveToGrid: Hierarchical step to %s (%d/%d refined, segment %d/%d)"),
+				*NextGrid.ToString(), Memory->HierarchicalStep, Memory->HierarchicalPath.Path.Num() - 1,
+				Memory->HierarchicalPath.NextSegment, Memory->HierarchicalPath.AbstractPath.Num() - 1);
+		}
+		else if (PathService && StartGrid != GoalGrid)
+		{
+			// 异步：提交请求后保持 InProgress，TickTask 拿到结果再走这一步
+			PathService->CancelRequest(Memory->PendingPath);
+			Memory->PendingPath = PathService->RequestPath(StartGrid, GoalGrid, Constraints, AsyncPathPriority);
+			Memory->FallbackDelta = Delta;
+			UE_LOG(LogTemp, Log, TEXT("BTTask_MoveToGrid: Async path request %d submitted"), Memory->PendingPath.Id);
+			return EBTNodeResult::InProgress;
+		}
+		else if (const FGridPathResult PathResult = UPathPlanner::FindPath(GridManager, StartGrid, GoalGrid, Constraints);
+			PathResult.bFound && PathResult.Path.Num() >= 2)
+		{
+			Delta = PathResult.Path[1] - PathResult.Path[0];
+			UE_LOG(LogTemp, Log, TEXT("BTTask_MoveToGrid: Path found, %d steps, cost %d, expanded %d"),
+				PathResult.Path.Num() - 1, PathResult.Cost, PathResult.ExpandedNodes);
+		}
+		else if (StartGrid == GoalGrid)
+		{
+			Delta = FIntPoint::ZeroValue;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BTTask_MoveToGrid: No path to %s, falling back to direct step"), *GoalGrid.ToString());
+		}
 	}
+	const int32 DeltaX = Delta.X;
+	const int32 DeltaY = Delta.Y;
 
 	UE_LOG(LogTemp, Log, TEXT("BTTask_MoveToGrid: Delta = (%d, %d)"), DeltaX, DeltaY);
 
@@ -215,6 +270,43 @@ void UBTTask_MoveToGrid::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* Node
 		return;
 	}
 
+	// 等待异步寻路结果，到达后再迈出这一步
+	FBTMoveToGridMemory* Memory = CastInstanceNodeMemory<FBTMoveToGridMemory>(NodeMemory);
+	if (Memory->PendingPath.IsValid())
+	{
+		UGridPathService* PathService = UGridPathService::Get(EnemyChar);
+		if (PathService && PathService->IsRequestPending(Memory->PendingPath))
+		{
+			return;
+		}
+
+		FIntPoint Delta = Memory->FallbackDelta;
+		FGridPathResult PathResult;
+		if (PathService && PathService->TryGetResult(Memory->PendingPath, PathResult) && PathResult.bFound && PathResult.Path.Num() >= 2)
+		{
+			Delta = PathResult.Path[1] - PathResult.Path[0];
+			UE_LOG(LogTemp, Log, TEXT("BTTask_MoveToGrid (Tick): Async path found, %d steps, cost %d, expanded %d"),
+				PathResult.Path.Num() - 1, PathResult.Cost, PathResult.ExpandedNodes);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BTTask_MoveToGrid (Tick): No async path, falling back to direct step"));
+		}
+		Memory->PendingPath.Invalidate();
+
+		if (!GridMovementComp->TryMoveOneStep(Delta.X, Delta.Y))
+		{
+			UE_LOG(LogTemp, Error, TEXT("BTTask_MoveToGrid (Tick): Move FAILED after async path"));
+			UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
+			if (BlackboardComp && TargetLocationKey.IsSet())
+			{
+				BlackboardComp->ClearValue(TargetLocationKey.SelectedKeyName);
+			}
+			FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		}
+		return;
+	}
+
 	// 每帧检查移动组件是否还在移动
 	if (!GridMovementComp->IsMoving())
 	{
@@ -226,5 +318,64 @@ void UBTTask_MoveToGrid::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* Node
 EBTNodeResult::Type UBTTask_MoveToGrid::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
 	UE_LOG(LogTemp, Warning, TEXT("BTTask_MoveToGrid: Aborted by Behavior Tree"));
+
+	FBTMoveToGridMemory* Memory = CastInstanceNodeMemory<FBTMoveToGridMemory>(NodeMemory);
+	if (Memory->PendingPath.IsValid())
+	{
+		if (UGridPathService* PathService = UGridPathService::Get(OwnerComp.GetOwner()))
+		{
+			PathService->CancelRequest(Memory->PendingPath);
+		}
+		Memory->PendingPath.Invalidate();
+	}
 	return EBTNodeResult::Aborted;
+}
+
+bool UBTTask_MoveToGrid::GetHierarchicalNextGrid(AGridManager* GridManager, FBTMoveToGridMemory& Memory, FIntPoint StartGrid, FIntPoint GoalGrid,
+	const FGridPathConstraints& Constraints, FIntPoint& OutNextGrid) const
+{
+	FGridHierarchicalPath& Path = Memory.HierarchicalPath;
+
+	// 目标未换格且角色仍在路径上时沿用上次的路径
+	const bool bReusable = Path.bFound && Path.AbstractPath.Num() > 0 && Path.AbstractPath.Last() == GoalGrid
+		&& Path.Path.IsValidIndex(Memory.HierarchicalStep) && Path.Path[Memory.HierarchicalStep] == StartGrid;
+	if (!bReusable)
+	{
+		Path = UPathPlanner::FindHierarchicalPath(GridManager, StartGrid, GoalGrid, Constraints, 1);
+		Memory.HierarchicalStep = 0;
+		UE_LOG(LogTemp, Log, TEXT("BTTask_MoveToGrid: Hierarchical path planned, %d steps, %d entrances, expanded %d"),
+			Path.Cost, FMath::Max(Path.AbstractPath.Num() - 2, 0), Path.ExpandedNodes);
+	}
+
+	// 已细化的逐格路径走完时再细化下一段
+	if (Path.bFound && Memory.HierarchicalStep + 1 >= Path.Path.Num())
+	{
+		UPathPlanner::RefineHierarchicalPath(GridManager, Path, Constraints, 1);
+	}
+
+	// 细化后的格子可能已被角色占据，与 A* 用同一规则检查
+	const int32 NextStep = Memory.HierarchicalStep + 1;
+	if (!Path.bFound || !Path.Path.IsValidIndex(NextStep)
+		|| UPathPlanner::GetPathEnterCost(GridManager, Path.Path[NextStep], GoalGrid, Constraints, 1) <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BTTask_MoveToGrid: No hierarchical step to %s, falling back to A*"), *GoalGrid.ToString());
+		Path = FGridHierarchicalPath();
+		Memory.HierarchicalStep = 0;
+		return false;
+	}
+
+	// 移动失败时角色不在 Path[HierarchicalStep] 上，下次会重新规划
+	Memory.HierarchicalStep = NextStep;
+	OutNextGrid = Path.Path[NextStep];
+	return true;
+}
+
+void UBTTask_MoveToGrid::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTMoveToGridMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_MoveToGrid::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTMoveToGridMemory>(NodeMemory, CleanupType);
 }
\ No newline at end of file
@@ -4,8 +4,24 @@
 
 #include "CoreMinimal.h"
 #include "BehaviorTree/BTTaskNode.h"
+#include "GridTactics/GridMovement/GridPathTypes.h"
 #include "BTTask_MoveToGrid.generated.h"
 
+struct FBTMoveToGridMemory
+{
+	// ȴ첽Ѱ·ʱЧ
+	FGridPathRequestHandle PendingPath;
+
+	// û·ʱ˻صֱ߷
+	FIntPoint FallbackDelta = FIntPoint::ZeroValue;
+
+	// ԶĿķֲ· ExecuteTask ·ʱϸһΣĿ껻ƫ·ʱ¹滮
+	FGridHierarchicalPath HierarchicalPath;
+
+	// ɫǰڸ HierarchicalPath.Path е±
+	int32 HierarchicalStep = 0;
+};
+
 /**
  * 
  */
@@ -27,6 +43,14 @@ protected:
 	// Ϊֹʱ
 	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
 
+	virtual uint16 GetInstanceMemorySize() const override { return sizeof(FBTMoveToGridMemory); }
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+
+	// ؽڵڴеķֲ·ȡһҪʱ¹滮ϸһΣһѲɽҲ·ʱ false
+	bool GetHierarchicalNextGrid(class AGridManager* GridManager, FBTMoveToGridMemory& Memory, FIntPoint StartGrid, FIntPoint GoalGrid,
+		const FGridPathConstraints& Constraints, FIntPoint& OutNextGrid) const;
+
 
 	// ڱ༭ѡڰеĿActorң
 	UPROPERTY(EditAnywhere, Category = "Blackboard")
@@ -35,4 +59,34 @@ protected:
 	// ڱ༭ѡڰеĿλãѲߵ㣩
 	UPROPERTY(EditAnywhere, Category = "Blackboard")
 	FBlackboardKeySelector TargetLocationKey;
+
+	//  A* Ѱ·һƿǽɫرʱֱӳĿ귽һ
+	UPROPERTY(EditAnywhere, Category = "Pathfinding")
+	bool bUsePathfinding = true;
+
+	// Ѱ·չĽڵʱ˻ֱ߷
+	UPROPERTY(EditAnywhere, Category = "Pathfinding", meta = (EditCondition = "bUsePathfinding", ClampMin = "0"))
+	int32 MaxPathSearchNodes = 4096;
+
+	// Ѱ·ʱɫռݵĸΪϰرպֻΣͼƶȫΪ 1 ʱ FindPath  JPS+ɫסһƶʧܣ
+	UPROPERTY(EditAnywhere, Category = "Pathfinding", meta = (EditCondition = "bUsePathfinding"))
+	bool bAvoidOccupiedCells = true;
+
+	// Ŀپﵽֵʱ÷ֲѰ· 1x1 ɫ·ֻβڽڵڴУϸʱ A* һƶĺռλ
+	// Ҳֲ·һռʱ˻ A*0 = ʼʹ A*
+	UPROPERTY(EditAnywhere, Category = "Pathfinding", meta = (EditCondition = "bUsePathfinding", ClampMin = "0"))
+	int32 HierarchicalPathDistance = 48;
+
+	// Ŀ TargetActorKey ʱĿڸĹߣ׷ͬһĿĵ˹һųÿ O(1)
+	UPROPERTY(EditAnywhere, Category = "Pathfinding", meta = (EditCondition = "bUsePathfinding"))
+	bool bUseFlowFieldForActorTarget = true;
+
+	// ͨ첽Ѱ· A* ·һ֡ȴڼ񱣳 InProgressرʱڱ֡ͬѰ·
+	// ֻͬ A* һ׷ TargetActorKeyֲѰ· >= HierarchicalPathDistanceȣ
+	// Ĭֻ TargetLocationKey ҾϽĿ첽
+	UPROPERTY(EditAnywhere, Category = "Pathfinding", meta = (EditCondition = "bUsePathfinding"))
+	bool bUseAsyncPathService = false;
+
+	UPROPERTY(EditAnywhere, Category = "Pathfinding", meta = (EditCondition = "bUseAsyncPathService"))
+	EGridPathPriority AsyncPathPriority = EGridPathPriority::Normal;
 };
\ No newline at end of file
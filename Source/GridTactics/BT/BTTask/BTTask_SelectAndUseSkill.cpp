@@ -7,6 +7,7 @@
 #include "GridTactics/Skills/SkillComponent.h"
 #include "GridTactics/Skills/SkillDataAsset.h"
 #include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
 #include "GridTactics/AttributesComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
@@ -274,9 +275,7 @@ bool UBTTask_SelectAndUseSkill::IsSkillUsable(USkillComponent* SkillComp, int32
 	}
 
 	// 检查目标是否在范围内
-	AGridManager* GridMgr = Cast<AGridManager>(
-		UGameplayStatics::GetActorOfClass(Self->GetWorld(), AGridManager::StaticClass())
-	);
+	AGridManager* GridMgr = UGridTacticsWorldSubsystem::GetGridManagerFor(Self->GetWorld());
 	if (!GridMgr)
 	{
 		UE_LOG(LogTemp, Error, TEXT("  IsSkillUsable[%d]: No GridManager!"), SkillIndex);
@@ -292,14 +291,13 @@ bool UBTTask_SelectAndUseSkill::IsSkillUsable(USkillComponent* SkillComp, int32
 	// 计算相对位置
 	FIntPoint RelativePos = TargetGrid - SelfGrid;
 
-	// 获取角色朝向，将相对位置旋转到局部坐标系
-	FRotator SelfRotation = Self->GetActorRotation();
-	FVector RelativeVec(RelativePos.X, RelativePos.Y, 0);
-	FVector LocalVec = SelfRotation.UnrotateVector(RelativeVec);
-	FIntPoint LocalPos(FMath::RoundToInt(LocalVec.X), FMath::RoundToInt(LocalVec.Y));
+	// 获取角色朝向（对齐到四方向），将相对位置旋转到局部坐标系
+	const float SelfYaw = Self->GetActorRotation().Yaw;
+	const int32 QuarterTurns = FGridPatternMask::YawToQuarterTurns(SelfYaw);
+	FIntPoint LocalPos = FGridPatternMask::UnrotateOffset(RelativePos, QuarterTurns);
 
 	UE_LOG(LogTemp, Log, TEXT("  IsSkillUsable[%d]: RelativePos=%s, Rotation=%.1f, LocalPos=%s"), 
-		SkillIndex, *RelativePos.ToString(), SelfRotation.Yaw, *LocalPos.ToString());
+		SkillIndex, *RelativePos.ToString(), SelfYaw, *LocalPos.ToString());
 
 	// 检查 RangePattern
 	if (SkillData->RangePattern.Num() == 0)
@@ -309,18 +307,12 @@ bool UBTTask_SelectAndUseSkill::IsSkillUsable(USkillComponent* SkillComp, int32
 		return false;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("  IsSkillUsable[%d]: Checking against %d range points..."), 
-		SkillIndex, SkillData->RangePattern.Num());
-
-	// 检查是否在 RangePattern 中
-	for (const FIntPoint& RangePoint : SkillData->RangePattern)
+	// 查 RangePattern 位掩码，替代逐点比较
+	if (SkillData->GetRangePatternMask().Contains(LocalPos))
 	{
-		if (LocalPos == RangePoint)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("  IsSkillUsable[%d]: Target IS in range! (matched %s)"), 
-				SkillIndex, *RangePoint.ToString());
-			return true;
-		}
+		UE_LOG(LogTemp, Warning, TEXT("  IsSkillUsable[%d]: Target IS in range! (matched %s)"), 
+			SkillIndex, *LocalPos.ToString());
+		return true;
 	}
 
 	UE_LOG(LogTemp, Log, TEXT("  IsSkillUsable[%d]: Target NOT in range"), SkillIndex);
@@ -5,6 +5,8 @@
 #include "GridTactics/GridTacticsPlayerController.h"
 #include "GridTactics/HeroCharacter.h"
 #include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridSpawnPlacement.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
 #include "GridTactics/Skills/SkillComponent.h"
 #include "GridTactics/Skills/SkillDataAsset.h"
 #include "GridTactics/AttributesComponent.h"
@@ -102,9 +104,7 @@ void AGridTacticsGameMode::OnPlayerReady()
 void AGridTacticsGameMode::SpawnPlayer()
 {
     // 获取 GridManager
-    AGridManager* GridMgr = Cast<AGridManager>(
-        UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass())
-    );
+    AGridManager* GridMgr = UGridTacticsWorldSubsystem::GetGridManagerFor(GetWorld());
 
     if (!GridMgr)
     {
@@ -112,16 +112,6 @@ void AGridTacticsGameMode::SpawnPlayer()
         return;
     }
 
-    // 计算生成位置
-    FVector SpawnLocation = GridMgr->GridToWorld(PlayerSpawnGrid);
-    SpawnLocation.Z = 50.0f;  // 略微抬高避免穿模
-
-    FRotator SpawnRotation = FRotator::ZeroRotator;
-
-    // 生成玩家角色
-    FActorSpawnParameters SpawnParams;
-    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-
     // 修改：使用配置的蓝图类
     if (!PlayerCharacterClass)
     {
@@ -129,12 +119,13 @@ void AGridTacticsGameMode::SpawnPlayer()
         return;
     }
 
-    PlayerCharacter = GetWorld()->SpawnActor<AHeroCharacter>(
-        PlayerCharacterClass,  // 使用蓝图类
-        SpawnLocation,
-        SpawnRotation,
-        SpawnParams
-    );
+    // 生成玩家角色（出生格被占用时就近放置）
+    FGridSpawnRequest SpawnRequest;
+    SpawnRequest.ActorClass = PlayerCharacterClass;
+    SpawnRequest.PreferredGrid = PlayerSpawnGrid;
+    SpawnRequest.HeightOffset = 50.0f;  // 略微抬高避免穿模
+
+    PlayerCharacter = Cast<AHeroCharacter>(UGridSpawnPlacement::SpawnAtGrid(this, SpawnRequest));
 
     if (PlayerCharacter)
     {
@@ -268,9 +259,7 @@ void AGridTacticsGameMode::StartNextWave()
 
 void AGridTacticsGameMode::SpawnEnemies(const FWaveConfig& WaveConfig)
 {
-    AGridManager* GridMgr = Cast<AGridManager>(
-        UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass())
-    );
+    AGridManager* GridMgr = UGridTacticsWorldSubsystem::GetGridManagerFor(GetWorld());
 
     if (!GridMgr)
     {
@@ -279,6 +268,8 @@ void AGridTacticsGameMode::SpawnEnemies(const FWaveConfig& WaveConfig)
 
     CurrentWaveEnemies.Empty();
 
+    // 整波一次性放置，同一波敌人不会挤在同一格
+    TArray<FGridSpawnRequest> SpawnRequests;
     for (const FEnemySpawnConfig& EnemyConfig : WaveConfig.Enemies)
     {
         if (!EnemyConfig.EnemyClass)
@@ -286,24 +277,18 @@ void AGridTacticsGameMode::SpawnEnemies(const FWaveConfig& WaveConfig)
             continue;
         }
 
-        // 计算生成位置
-        FVector SpawnLocation = GridMgr->GridToWorld(EnemyConfig.SpawnGrid);
-        SpawnLocation.Z = 100.0f;
-
-        FRotator SpawnRotation = FRotator::ZeroRotator;
-
-        // 生成敌人
-        FActorSpawnParameters SpawnParams;
-        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+        FGridSpawnRequest& SpawnRequest = SpawnRequests.AddDefaulted_GetRef();
+        SpawnRequest.ActorClass = EnemyConfig.EnemyClass;
+        SpawnRequest.PreferredGrid = EnemyConfig.SpawnGrid;
+        SpawnRequest.HeightOffset = 100.0f;
+    }
 
-        ACharacter* Enemy = GetWorld()->SpawnActor<ACharacter>(
-            EnemyConfig.EnemyClass,
-            SpawnLocation,
-            SpawnRotation,
-            SpawnParams
-        );
+    TArray<AActor*> SpawnedActors;
+    UGridSpawnPlacement::SpawnWave(this, SpawnRequests, SpawnedActors);
 
-        if (Enemy)
+    for (int32 Index = 0; Index < SpawnedActors.Num(); ++Index)
+    {
+        if (ACharacter* Enemy = Cast<ACharacter>(SpawnedActors[Index]))
         {
             // 绑定敌人死亡事件
             if (UAttributesComponent* Attrs = Enemy->FindComponentByClass<UAttributesComponent>())
@@ -313,8 +298,9 @@ void AGridTacticsGameMode::SpawnEnemies(const FWaveConfig& WaveConfig)
 
             CurrentWaveEnemies.Add(Enemy);
 
+            const FIntPoint SpawnedGrid = GridMgr->WorldToGrid(Enemy->GetActorLocation());
             UE_LOG(LogTemp, Log, TEXT("GameMode: Spawned enemy at grid (%d, %d)"),
-                EnemyConfig.SpawnGrid.X, EnemyConfig.SpawnGrid.Y);
+                SpawnedGrid.X, SpawnedGrid.Y);
         }
     }
 
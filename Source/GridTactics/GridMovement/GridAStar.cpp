@@ -0,0 +1,47 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridAStar.h"
+
+FGridAStar& FGridAStar::Get()
+{
+    static thread_local FGridAStar Instance;
+    return Instance;
+}
+
+void FGridAStar::BeginSearch(int32 NumNodes)
+{
+    if (SeenGeneration.Num() < NumNodes)
+    {
+        SeenGeneration.SetNumZeroed(NumNodes);
+        ClosedGeneration.SetNumZeroed(NumNodes);
+        GCost.SetNumUninitialized(NumNodes);
+        ParentIndex.SetNumUninitialized(NumNodes);
+    }
+
+    // 代数回绕到 0 时旧标记可能与新代数相同，整表清零
+    if (++Generation == 0)
+    {
+        FMemory::Memzero(SeenGeneration.GetData(), SeenGeneration.Num() * sizeof(uint32));
+        FMemory::Memzero(ClosedGeneration.GetData(), ClosedGeneration.Num() * sizeof(uint32));
+        Generation = 1;
+    }
+
+    OpenHeap.Reset();
+}
+
+void FGridAStar::Trim(SIZE_T MaxRetainedBytes)
+{
+    if (GetAllocatedSize() <= MaxRetainedBytes)
+    {
+        return;
+    }
+
+    // 重新分配时整表清零，代数从头开始即可
+    SeenGeneration.Empty();
+    ClosedGeneration.Empty();
+    GCost.Empty();
+    ParentIndex.Empty();
+    OpenHeap.Empty();
+    PathIndices.Empty();
+    Generation = 0;
+}
\ No newline at end of file
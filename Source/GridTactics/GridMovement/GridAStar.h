@@ -0,0 +1,240 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridTopology.h"
+#include "Algo/Reverse.h"
+
+/**
+ * 四方向 A*：节点数组按搜索区域分配并跨查询复用，用代数（generation）标记代替每次清空，预热后单次查询不再分配内存
+ * 代价函数返回进入格子的消耗（>= 1），小于等于 0 表示不可通行；启发式为曼哈顿距离
+ */
+struct GRIDTACTICS_API FGridAStar
+{
+    // 在 [BoundsMin, BoundsMin + BoundsSize) 内搜索，OutPath 包含起点与终点
+    template<typename EnterCostFuncType>
+    bool FindPath(FIntPoint BoundsMin, FIntPoint BoundsSize, FIntPoint Start, FIntPoint Goal,
+        EnterCostFuncType&& GetEnterCost, TArray<FIntPoint>& OutPath, int32& OutCost, int32 MaxExpandedNodes = 0);
+
+    // 自定义后继的搜索（JPS+ 等跳跃式扩展）：Expand(Grid, ParentGrid, AddSuccessor) 对每个后继调用 AddSuccessor(Next, StepCost)
+    // 起点的 ParentGrid 等于自身；OutNodes 为依次经过的节点（相邻节点之间可能相隔多格）
+    template<typename ExpandFuncType>
+    bool Search(FIntPoint BoundsMin, FIntPoint BoundsSize, FIntPoint Start, FIntPoint Goal,
+        ExpandFuncType&& Expand, TArray<FIntPoint>& OutNodes, int32& OutCost, int32 MaxExpandedNodes = 0);
+
+    // 一般图上的搜索（HPA* 抽象图等）：节点为 [0, NumNodes) 的下标，节点数组只按 NumNodes 分配
+    // Expand(Index, ParentIndex, AddSuccessor) 对每个后继调用 AddSuccessor(NextIndex, StepCost, NextHeuristic)，起点的 ParentIndex 为 INDEX_NONE
+    template<typename ExpandFuncType>
+    bool SearchGraph(int32 NumNodes, int32 StartIndex, int32 GoalIndex, int32 StartHeuristic,
+        ExpandFuncType&& Expand, TArray<int32>& OutNodes, int32& OutCost, int32 MaxExpandedNodes = 0);
+
+    int32 GetExpandedCount() const { return ExpandedCount; }
+
+    // 复用的节点数组占用的内存
+    SIZE_T GetAllocatedSize() const
+    {
+        return SeenGeneration.GetAllocatedSize() + ClosedGeneration.GetAllocatedSize() + GCost.GetAllocatedSize()
+            + ParentIndex.GetAllocatedSize() + OpenHeap.GetAllocatedSize() + PathIndices.GetAllocatedSize();
+    }
+
+    // 复用的节点数组超过 MaxRetainedBytes 时整体释放，下次查询重新分配
+    void Trim(SIZE_T MaxRetainedBytes = 0);
+
+    // 工作线程求解后保留的节点数组上限（约 25 万格），超出则由调用方 Trim，避免每个工作线程常驻一份整图节点数组
+    static constexpr SIZE_T WorkerRetainedBytes = 4 * 1024 * 1024;
+
+    // 当前线程的搜索实例（游戏线程与工作线程各自一份）
+    static FGridAStar& Get();
+
+private:
+    struct FOpenNode
+    {
+        int32 F;
+        int32 G;
+        int32 Index;
+    };
+
+    // 小顶堆：F 小的优先，F 相同时 G 大的（离终点近的）优先
+    struct FOpenNodePredicate
+    {
+        bool operator()(const FOpenNode& A, const FOpenNode& B) const
+        {
+            return A.F < B.F || (A.F == B.F && A.G > B.G);
+        }
+    };
+
+    // 开始一次查询：必要时扩容节点数组，代数 +1（回绕时整表清零）
+    void BeginSearch(int32 NumNodes);
+
+    // == Generation 表示本次查询已访问（GCost、ParentIndex 有效）/ 已出队扩展
+    TArray<uint32> SeenGeneration;
+    TArray<uint32> ClosedGeneration;
+    TArray<int32> GCost;
+    TArray<int32> ParentIndex;
+
+    // 过期条目不删除，出队时按 G 值跳过
+    TArray<FOpenNode> OpenHeap;
+
+    // 网格搜索回溯出的节点下标，复用以免每次查询分配
+    TArray<int32> PathIndices;
+
+    uint32 Generation = 0;
+    int32 ExpandedCount = 0;
+};
+
+template<typename EnterCostFuncType>
+bool FGridAStar::FindPath(FIntPoint BoundsMin, FIntPoint BoundsSize, FIntPoint Start, FIntPoint Goal,
+    EnterCostFuncType&& GetEnterCost, TArray<FIntPoint>& OutPath, int32& OutCost, int32 MaxExpandedNodes)
+{
+    auto ExpandNeighbors = [&GetEnterCost](FIntPoint Grid, FIntPoint ParentGrid, auto&& AddSuccessor)
+    {
+        for (int32 Dir = 0; Dir < FGridTopology4::NumDirections; ++Dir)
+        {
+            const FIntPoint Next(Grid.X + FGridTopology4::DirectionX[Dir], Grid.Y + FGridTopology4::DirectionY[Dir]);
+            if (Next == ParentGrid)
+            {
+                continue;
+            }
+            const int32 StepCost = GetEnterCost(Next);
+            if (StepCost > 0)
+            {
+                AddSuccessor(Next, StepCost);
+            }
+        }
+    };
+    return Search(BoundsMin, BoundsSize, Start, Goal, ExpandNeighbors, OutPath, OutCost, MaxExpandedNodes);
+}
+
+template<typename ExpandFuncType>
+bool FGridAStar::Search(FIntPoint BoundsMin, FIntPoint BoundsSize, FIntPoint Start, FIntPoint Goal,
+    ExpandFuncType&& Expand, TArray<FIntPoint>& OutNodes, int32& OutCost, int32 MaxExpandedNodes)
+{
+    OutNodes.Reset();
+    OutCost = 0;
+    ExpandedCount = 0;
+
+    auto ToIndex = [BoundsMin, BoundsSize](FIntPoint Grid)
+    {
+        const FIntPoint Local = Grid - BoundsMin;
+        if (Local.X < 0 || Local.Y < 0 || Local.X >= BoundsSize.X || Local.Y >= BoundsSize.Y)
+        {
+            return (int32)INDEX_NONE;
+        }
+        return Local.Y * BoundsSize.X + Local.X;
+    };
+    auto ToGrid = [BoundsMin, BoundsSize](int32 Index)
+    {
+        return BoundsMin + FIntPoint(Index % BoundsSize.X, Index / BoundsSize.X);
+    };
+    auto Heuristic = [Goal](FIntPoint Grid)
+    {
+        return FMath::Abs(Grid.X - Goal.X) + FMath::Abs(Grid.Y - Goal.Y);
+    };
+
+    const int32 StartIndex = ToIndex(Start);
+    const int32 GoalIndex = ToIndex(Goal);
+    if (StartIndex == INDEX_NONE || GoalIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    auto ExpandGrid = [&](int32 Index, int32 Parent, auto&& AddSuccessor)
+    {
+        const FIntPoint Grid = ToGrid(Index);
+        Expand(Grid, Parent != INDEX_NONE ? ToGrid(Parent) : Grid, [&](FIntPoint Next, int32 StepCost)
+        {
+            const int32 NextIndex = ToIndex(Next);
+            if (NextIndex != INDEX_NONE)
+            {
+                AddSuccessor(NextIndex, StepCost, Heuristic(Next));
+            }
+        });
+    };
+    if (!SearchGraph(BoundsSize.X * BoundsSize.Y, StartIndex, GoalIndex, Heuristic(Start), ExpandGrid, PathIndices, OutCost, MaxExpandedNodes))
+    {
+        return false;
+    }
+
+    OutNodes.Reserve(PathIndices.Num());
+    for (const int32 Index : PathIndices)
+    {
+        OutNodes.Add(ToGrid(Index));
+    }
+    return true;
+}
+
+template<typename ExpandFuncType>
+bool FGridAStar::SearchGraph(int32 NumNodes, int32 StartIndex, int32 GoalIndex, int32 StartHeuristic,
+    ExpandFuncType&& Expand, TArray<int32>& OutNodes, int32& OutCost, int32 MaxExpandedNodes)
+{
+    OutNodes.Reset();
+    OutCost = 0;
+    ExpandedCount = 0;
+
+    if (!ensure(StartIndex >= 0 && StartIndex < NumNodes && GoalIndex >= 0 && GoalIndex < NumNodes))
+    {
+        return false;
+    }
+    if (StartIndex == GoalIndex)
+    {
+        OutNodes.Add(StartIndex);
+        return true;
+    }
+
+    BeginSearch(NumNodes);
+
+    SeenGeneration[StartIndex] = Generation;
+    GCost[StartIndex] = 0;
+    ParentIndex[StartIndex] = INDEX_NONE;
+    OpenHeap.HeapPush(FOpenNode{ StartHeuristic, 0, StartIndex }, FOpenNodePredicate());
+
+    while (OpenHeap.Num() > 0)
+    {
+        FOpenNode Node;
+        OpenHeap.HeapPop(Node, FOpenNodePredicate(), EAllowShrinking::No);
+        if (ClosedGeneration[Node.Index] == Generation || Node.G != GCost[Node.Index])
+        {
+            continue;
+        }
+        ClosedGeneration[Node.Index] = Generation;
+
+        if (Node.Index == GoalIndex)
+        {
+            OutCost = Node.G;
+            for (int32 Index = GoalIndex; Index != INDEX_NONE; Index = ParentIndex[Index])
+            {
+                OutNodes.Add(Index);
+            }
+            Algo::Reverse(OutNodes);
+            return true;
+        }
+
+        if (MaxExpandedNodes > 0 && ExpandedCount >= MaxExpandedNodes)
+        {
+            break;
+        }
+        ++ExpandedCount;
+
+        auto AddSuccessor = [&](int32 NextIndex, int32 StepCost, int32 NextHeuristic)
+        {
+            if (ClosedGeneration[NextIndex] == Generation)
+            {
+                return;
+            }
+
+            const int32 NewG = Node.G + StepCost;
+            if (SeenGeneration[NextIndex] == Generation && NewG >= GCost[NextIndex])
+            {
+                return;
+            }
+            SeenGeneration[NextIndex] = Generation;
+            GCost[NextIndex] = NewG;
+            ParentIndex[NextIndex] = Node.Index;
+            OpenHeap.HeapPush(FOpenNode{ NewG + NextHeuristic, NewG, NextIndex }, FOpenNodePredicate());
+        };
+        Expand(Node.Index, ParentIndex[Node.Index], AddSuccessor);
+    }
+
+    return false;
+}
\ No newline at end of file
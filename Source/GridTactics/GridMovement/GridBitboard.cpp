@@ -0,0 +1,174 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridBitboard.h"
+
+// --- FGridBitboard ---
+
+void FGridBitboard::Init(FIntPoint InMin, FIntPoint InSize)
+{
+    Min = InMin;
+    Size = FIntPoint(FMath::Max(0, InSize.X), FMath::Max(0, InSize.Y));
+    WordsPerRow = (Size.X + 63) / 64;
+
+    Words.Reset();
+    Words.SetNumZeroed(WordsPerRow * Size.Y);
+}
+
+void FGridBitboard::Reset()
+{
+    FMemory::Memzero(Words.GetData(), Words.Num() * sizeof(uint64));
+}
+
+void FGridBitboard::SetBit(FIntPoint Grid, bool bValue)
+{
+    const int32 LocalX = Grid.X - Min.X;
+    const int32 LocalY = Grid.Y - Min.Y;
+    if (LocalX < 0 || LocalY < 0 || LocalX >= Size.X || LocalY >= Size.Y)
+    {
+        return;
+    }
+
+    uint64& Word = Words[LocalY * WordsPerRow + (LocalX >> 6)];
+    const uint64 Bit = uint64(1) << (LocalX & 63);
+    Word = bValue ? (Word | Bit) : (Word & ~Bit);
+}
+
+bool FGridBitboard::TestBit(FIntPoint Grid) const
+{
+    const int32 LocalX = Grid.X - Min.X;
+    const int32 LocalY = Grid.Y - Min.Y;
+    if (LocalX < 0 || LocalY < 0 || LocalX >= Size.X || LocalY >= Size.Y)
+    {
+        return false;
+    }
+    return (Words[LocalY * WordsPerRow + (LocalX >> 6)] >> (LocalX & 63)) & 1;
+}
+
+uint64 FGridBitboard::ExtractBits(int32 LocalX, int32 LocalY) const
+{
+    if (LocalY < 0 || LocalY >= Size.Y || LocalX >= Size.X || LocalX <= -64)
+    {
+        return 0;
+    }
+
+    const uint64* Row = Words.GetData() + LocalY * WordsPerRow;
+    if (LocalX < 0)
+    {
+        // 负列全部为 0，只有第一个字的低位会落入窗口
+        return Row[0] << (-LocalX);
+    }
+
+    const int32 WordIndex = LocalX >> 6;
+    const int32 Shift = LocalX & 63;
+    uint64 Bits = Row[WordIndex] >> Shift;
+    if (Shift != 0 && WordIndex + 1 < WordsPerRow)
+    {
+        Bits |= Row[WordIndex + 1] << (64 - Shift);
+    }
+    return Bits;
+}
+
+bool FGridBitboard::IntersectsPattern(FIntPoint Origin, const FGridPatternMask& Mask) const
+{
+    // 模板左下角在本位图中的局部坐标
+    const FIntPoint Base = Origin + Mask.Min - Min;
+
+    for (int32 Row = 0; Row < Mask.Size.Y; ++Row)
+    {
+        for (int32 Word = 0; Word < Mask.WordsPerRow; ++Word)
+        {
+            const uint64 PatternBits = Mask.Words[Row * Mask.WordsPerRow + Word];
+            if (PatternBits && (ExtractBits(Base.X + Word * 64, Base.Y + Row) & PatternBits))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void FGridBitboard::GetPatternHits(FIntPoint Origin, const FGridPatternMask& Mask, TArray<FIntPoint>& OutGrids,
+    const FGridBitboard* Exclude) const
+{
+    OutGrids.Reset();
+
+    const FIntPoint Base = Origin + Mask.Min - Min;
+    const bool bUseExclude = Exclude && Exclude->Min == Min && Exclude->Size == Size;
+
+    for (int32 Row = 0; Row < Mask.Size.Y; ++Row)
+    {
+        for (int32 Word = 0; Word < Mask.WordsPerRow; ++Word)
+        {
+            const uint64 PatternBits = Mask.Words[Row * Mask.WordsPerRow + Word];
+            if (!PatternBits)
+            {
+                continue;
+            }
+
+            const int32 LocalX = Base.X + Word * 64;
+            uint64 Bits = ExtractBits(LocalX, Base.Y + Row) & PatternBits;
+            if (bUseExclude)
+            {
+                Bits &= ~Exclude->ExtractBits(LocalX, Base.Y + Row);
+            }
+
+            // 逐个取出最低置位
+            while (Bits)
+            {
+                const int32 BitIndex = (int32)FMath::CountTrailingZeros64(Bits);
+                OutGrids.Add(FIntPoint(Min.X + LocalX + BitIndex, Min.Y + Base.Y + Row));
+                Bits &= Bits - 1;
+            }
+        }
+    }
+}
+
+// --- FGridPatternMask ---
+
+FGridPatternMask FGridPatternMask::Build(const TArray<FIntPoint>& Pattern, int32 QuarterTurns)
+{
+    FGridPatternMask Mask;
+    if (Pattern.Num() == 0)
+    {
+        return Mask;
+    }
+
+    TArray<FIntPoint, TInlineAllocator<32>> Rotated;
+    Rotated.Reserve(Pattern.Num());
+
+    FIntPoint PatternMin(MAX_int32, MAX_int32);
+    FIntPoint PatternMax(MIN_int32, MIN_int32);
+    for (const FIntPoint& Offset : Pattern)
+    {
+        const FIntPoint RotatedOffset = RotateOffset(Offset, QuarterTurns);
+        Rotated.Add(RotatedOffset);
+
+        PatternMin = FIntPoint(FMath::Min(PatternMin.X, RotatedOffset.X), FMath::Min(PatternMin.Y, RotatedOffset.Y));
+        PatternMax = FIntPoint(FMath::Max(PatternMax.X, RotatedOffset.X), FMath::Max(PatternMax.Y, RotatedOffset.Y));
+    }
+
+    Mask.Min = PatternMin;
+    Mask.Size = PatternMax - PatternMin + FIntPoint(1, 1);
+    Mask.WordsPerRow = (Mask.Size.X + 63) / 64;
+    Mask.Words.SetNumZeroed(Mask.WordsPerRow * Mask.Size.Y);
+
+    for (const FIntPoint& Offset : Rotated)
+    {
+        const int32 LocalX = Offset.X - PatternMin.X;
+        const int32 LocalY = Offset.Y - PatternMin.Y;
+        Mask.Words[LocalY * Mask.WordsPerRow + (LocalX >> 6)] |= uint64(1) << (LocalX & 63);
+    }
+    return Mask;
+}
+
+bool FGridPatternMask::Contains(FIntPoint Offset) const
+{
+    const int32 LocalX = Offset.X - Min.X;
+    const int32 LocalY = Offset.Y - Min.Y;
+    if (LocalX < 0 || LocalY < 0 || LocalX >= Size.X || LocalY >= Size.Y)
+    {
+        return false;
+    }
+    return (Words[LocalY * WordsPerRow + (LocalX >> 6)] >> (LocalX & 63)) & 1;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridTopology.h"
+
+struct FGridPatternMask;
+
+/**
+ * 按格子存储包围盒排列的位图，每行若干个 64 位字，bit i 对应本行第 (字下标 * 64 + i) 列
+ * 用于可行走/占位/阵营等布尔层，范围判定只需对整字做移位与按位与
+ */
+struct GRIDTACTICS_API FGridBitboard
+{
+    // 按包围盒分配并清零
+    void Init(FIntPoint InMin, FIntPoint InSize);
+    void Reset();
+
+    void SetBit(FIntPoint Grid, bool bValue);
+    bool TestBit(FIntPoint Grid) const;
+
+    // 取出第 LocalY 行从第 LocalX 列开始的 64 列（越界的列为 0，LocalX 可以为负）
+    uint64 ExtractBits(int32 LocalX, int32 LocalY) const;
+
+    // 以 Origin 为原点放置模板，是否有任意一格置位
+    bool IntersectsPattern(FIntPoint Origin, const FGridPatternMask& Mask) const;
+
+    // 收集模板内置位的格子（世界坐标）；Exclude 非空时剔除其中置位的格子，两者包围盒须一致
+    void GetPatternHits(FIntPoint Origin, const FGridPatternMask& Mask, TArray<FIntPoint>& OutGrids,
+        const FGridBitboard* Exclude = nullptr) const;
+
+    FIntPoint GetMin() const { return Min; }
+    FIntPoint GetSize() const { return Size; }
+
+private:
+    FIntPoint Min = FIntPoint::ZeroValue;
+    FIntPoint Size = FIntPoint::ZeroValue;
+    int32 WordsPerRow = 0;
+    TArray<uint64> Words;
+};
+
+/**
+ * 技能范围模板的位掩码（已按朝向旋转），与 FGridBitboard 使用相同的行/字布局
+ * 原点为施法者（或目标点），Min 为模板包围盒相对原点的最小偏移
+ */
+struct GRIDTACTICS_API FGridPatternMask
+{
+    FIntPoint Min = FIntPoint::ZeroValue;
+    FIntPoint Size = FIntPoint::ZeroValue;
+    int32 WordsPerRow = 0;
+    TArray<uint64, TInlineAllocator<8>> Words;
+
+    // 由模板（基于面向 X+）构建，QuarterTurns 为逆时针旋转的 90° 次数
+    static FGridPatternMask Build(const TArray<FIntPoint>& Pattern, int32 QuarterTurns = 0);
+
+    // 偏移是否在模板内
+    bool Contains(FIntPoint Offset) const;
+    bool IsEmpty() const { return Words.Num() == 0; }
+
+    // 朝向 -> 90° 旋转次数，分界与 UGridMovementComponent::SnapRotationToFourDirections 一致
+    static int32 YawToQuarterTurns(float Yaw) { return FGridTopology4::RotationTurnsFromYaw(Yaw); }
+
+    // 四向整数旋转（位图模板只支持方格拓扑）
+    static FIntPoint RotateOffset(FIntPoint Offset, int32 QuarterTurns) { return FGridTopology4::Rotate(Offset, QuarterTurns); }
+    static FIntPoint UnrotateOffset(FIntPoint Offset, int32 QuarterTurns) { return FGridTopology4::UnrotateOffset(Offset, QuarterTurns); }
+};
\ No newline at end of file
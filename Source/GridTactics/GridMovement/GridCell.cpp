@@ -10,8 +10,8 @@
 // Sets default values
 AGridCell::AGridCell()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// ݴҪ Tick
+	PrimaryActorTick.bCanEverTick = false;
 
     // ײУ100x100x10 cm
     CollisionBox = CreateDefaultSubobject<UBoxComponent>(TEXT("CollisionBox"));
@@ -33,20 +33,21 @@ void AGridCell::BeginPlay()
     FVector WorldPos = GetActorLocation();
     GridCoordinate.X = FMath::RoundToInt(WorldPos.X / GridSizeCM);
     GridCoordinate.Y = FMath::RoundToInt(WorldPos.Y / GridSizeCM);
-
-    UE_LOG(LogTemp, Log, TEXT("GridCell at %s"), *GridCoordinate.ToString());
 }
 
-// Called every frame
-void AGridCell::Tick(float DeltaTime)
+bool AGridCell::IsWalkable() const
 {
-	Super::Tick(DeltaTime);
-
+    return CellType == EGridCellType::Walkable;
 }
 
-bool AGridCell::IsWalkable() const
+FGridCellAttributes AGridCell::GetCellAttributes() const
 {
-    return CellType == EGridCellType::Walkable;
+    FGridCellAttributes Attributes;
+    Attributes.MoveCost = FMath::Max<uint8>(MoveCost, 1);
+    Attributes.Height = (int16)FMath::Clamp(FMath::RoundToInt(GetActorLocation().Z), (int32)MIN_int16, (int32)MAX_int16);
+    Attributes.Faction = Faction;
+    Attributes.Hazard = HazardId;
+    return Attributes;
 }
 
 #if WITH_EDITOR
@@ -6,6 +6,10 @@
 #include "GameFramework/Actor.h"
 #include "GridType.h"
 #include "GridCell.generated.h"
+/**
+ * ӵı༭ڷŴʱ GridManager Ӵ洢ϲ GridRenderer ʵУ
+ * ϲᱻ٣ AGridManager::bMergeCellProxies
+ */
 UCLASS()
 class GRIDTACTICS_API AGridCell : public AActor
 {
@@ -23,6 +27,29 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
     FIntPoint GridCoordinate;
 
+    // --- Բ㣨߶ȡ Actor  Z ꣩ ---
+
+    // ƶģѰ·Ȩأ
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid|Layers", meta = (ClampMin = "1"))
+    uint8 MoveCost = 1;
+
+    // ʼӪ/Ʒ0 = 
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid|Layers")
+    uint8 Faction = 0;
+
+    // Σ ID0 = ޣ綾ȳ˺
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid|Layers")
+    uint8 HazardId = 0;
+
+    // ΪԲȡֵ
+    FGridCellAttributes GetCellAttributes() const;
+
+    // Ѻ決 GridMapAsset GridMapBake ã決ؿʱΪ༭ר Actor ޳
+    UPROPERTY(VisibleAnywhere, AdvancedDisplay, Category = "Grid")
+    bool bBakedToGridMap = false;
+
+    virtual bool IsEditorOnly() const override { return bBakedToGridMap || Super::IsEditorOnly(); }
+
     // ߴ磨ף
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
     float GridSizeCM = 100.0f;
@@ -31,6 +58,9 @@ public:
     UFUNCTION(BlueprintPure, Category = "Grid")
     bool IsWalkable() const;
 
+    //  GridRenderer ɼۣ塢ʡԱ任
+    class UStaticMeshComponent* GetVisualMesh() const { return VisualMesh; }
+
     // ӻڱ༭иʾͬɫ
 #if WITH_EDITOR
     virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -48,9 +78,4 @@ protected:
     // ڿӻ
     UPROPERTY(VisibleDefaultsOnly, Category = "Components")
     class UStaticMeshComponent* VisualMesh;
-
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 };
@@ -0,0 +1,169 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridType.h"
+#include "GridMorton.h"
+#include <atomic>
+
+// 区块内格子排列方式：0 = 行优先，1 = Morton（Z 序），可在 Build.cs 的 PublicDefinitions 中覆盖
+#ifndef GRIDTACTICS_MORTON_CELL_LAYOUT
+#define GRIDTACTICS_MORTON_CELL_LAYOUT 0
+#endif
+
+// 单格上的角色列表（绝大多数格子同时最多 1~2 个角色）
+using FGridOccupantList = TArray<TWeakObjectPtr<AActor>, TInlineAllocator<2>>;
+
+/**
+ * 稀疏格子存储的固定大小区块（32x32），只有范围内存在 GridCell 时才分配
+ * 区块内默认按行优先排列：下标 = (Y & 31) * 32 + (X & 31)；开启 GRIDTACTICS_MORTON_CELL_LAYOUT 后按 Z 序排列
+ * 区块内下标只能通过 GetLocalIndex / GetLocalCoord 换算
+ */
+struct FGridCellChunk
+{
+    static constexpr int32 SizeLog2 = 5;
+    static constexpr int32 Size = 1 << SizeLog2;
+    static constexpr int32 LocalMask = Size - 1;
+    static constexpr int32 NumCells = Size * Size;
+    static constexpr bool bMortonLayout = GRIDTACTICS_MORTON_CELL_LAYOUT != 0;
+
+    TStaticArray<FGridCellRecord, NumCells> Cells;
+    TStaticArray<FGridOccupantList, NumCells> Occupants;
+
+    // 每格最后一次变化时的 GridManager 全局版本号（0 = 加载后未变化）
+    TStaticArray<int32, NumCells> Versions;
+
+    // SoA 属性层（见 EGridCellLayer），每层连续存放，可按行整段读取
+    TStaticArray<uint8, NumCells> MoveCost;
+    TStaticArray<int16, NumCells> Height;
+    TStaticArray<uint8, NumCells> Faction;
+    TStaticArray<uint8, NumCells> Hazard;
+
+    // 连通区域编号（0 = 不可行走），经 AGridManager::RegionRoots 映射到合并后的区域
+    TStaticArray<int32, NumCells> RegionLabels;
+
+    // 格子预定：0 = 空闲，否则为打包的角色句柄（UObject 下标 + 序列号，见 AGridManager::MakeReservationHandle）
+    // 预定只通过原子操作读写，可在工作线程并发调用；区块本身只在游戏线程分配与释放
+    TStaticArray<std::atomic<uint64>, NumCells> Reservations;
+
+    // 有效格子数量，降到 0 时区块被释放
+    int32 NumValidCells = 0;
+
+    FGridCellChunk()
+    {
+        FMemory::Memzero(Versions.GetData(), sizeof(int32) * NumCells);
+        FMemory::Memzero(MoveCost.GetData(), sizeof(uint8) * NumCells);
+        FMemory::Memzero(Height.GetData(), sizeof(int16) * NumCells);
+        FMemory::Memzero(Faction.GetData(), sizeof(uint8) * NumCells);
+        FMemory::Memzero(Hazard.GetData(), sizeof(uint8) * NumCells);
+        FMemory::Memzero(RegionLabels.GetData(), sizeof(int32) * NumCells);
+        for (std::atomic<uint64>& Reservation : Reservations)
+        {
+            Reservation.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void SetAttributes(int32 LocalIndex, const FGridCellAttributes& Attributes)
+    {
+        MoveCost[LocalIndex] = Attributes.MoveCost;
+        Height[LocalIndex] = Attributes.Height;
+        Faction[LocalIndex] = Attributes.Faction;
+        Hazard[LocalIndex] = Attributes.Hazard;
+    }
+
+    FGridCellAttributes GetAttributes(int32 LocalIndex) const
+    {
+        FGridCellAttributes Attributes;
+        Attributes.MoveCost = MoveCost[LocalIndex];
+        Attributes.Height = Height[LocalIndex];
+        Attributes.Faction = Faction[LocalIndex];
+        Attributes.Hazard = Hazard[LocalIndex];
+        return Attributes;
+    }
+
+    int32 GetLayerValue(int32 LocalIndex, EGridCellLayer Layer) const
+    {
+        switch (Layer)
+        {
+        case EGridCellLayer::MoveCost:  return MoveCost[LocalIndex];
+        case EGridCellLayer::Height:    return Height[LocalIndex];
+        case EGridCellLayer::Faction:   return Faction[LocalIndex];
+        case EGridCellLayer::Hazard:    return Hazard[LocalIndex];
+        default:                        return 0;
+        }
+    }
+
+    // 写入并裁剪到该层的取值范围，返回值是否变化
+    bool SetLayerValue(int32 LocalIndex, EGridCellLayer Layer, int32 Value)
+    {
+        switch (Layer)
+        {
+        case EGridCellLayer::MoveCost:  return Exchange(MoveCost[LocalIndex], (uint8)FMath::Clamp(Value, 1, 255));
+        case EGridCellLayer::Height:    return Exchange(Height[LocalIndex], (int16)FMath::Clamp(Value, (int32)MIN_int16, (int32)MAX_int16));
+        case EGridCellLayer::Faction:   return Exchange(Faction[LocalIndex], (uint8)FMath::Clamp(Value, 0, 255));
+        case EGridCellLayer::Hazard:    return Exchange(Hazard[LocalIndex], (uint8)FMath::Clamp(Value, 0, 255));
+        default:                        return false;
+        }
+    }
+
+    // 格子坐标 -> 区块坐标（算术右移，负坐标向下取整）
+    static FIntPoint GridToChunk(FIntPoint Grid) { return FIntPoint(Grid.X >> SizeLog2, Grid.Y >> SizeLog2); }
+
+    // 区块坐标 -> 区块左下角的格子坐标
+    static FIntPoint ChunkToGrid(FIntPoint Chunk) { return FIntPoint(Chunk.X * Size, Chunk.Y * Size); }
+
+    static int32 GetLocalIndex(FIntPoint Grid)
+    {
+        if constexpr (bMortonLayout)
+        {
+            return (int32)FGridMorton::EncodeLocal(Grid.X & LocalMask, Grid.Y & LocalMask);
+        }
+        else
+        {
+            return ((Grid.Y & LocalMask) << SizeLog2) | (Grid.X & LocalMask);
+        }
+    }
+
+    // 区块内下标 -> 区块内坐标
+    static FIntPoint GetLocalCoord(int32 LocalIndex)
+    {
+        if constexpr (bMortonLayout)
+        {
+            return FIntPoint((int32)FGridMorton::DecodeX(LocalIndex), (int32)FGridMorton::DecodeY(LocalIndex));
+        }
+        else
+        {
+            return FIntPoint(LocalIndex & LocalMask, LocalIndex >> SizeLog2);
+        }
+    }
+
+    // 按存储顺序遍历矩形 [Min, Max]（含边界）内的格子：行优先布局逐行，Morton 布局按 Z 序
+    template<typename FunctorType>
+    static void ForEachGridInRect(FIntPoint Min, FIntPoint Max, FunctorType&& Visitor)
+    {
+        if constexpr (bMortonLayout)
+        {
+            FGridMorton::ForEachInRect(Min, Max, Forward<FunctorType>(Visitor));
+        }
+        else
+        {
+            for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+            {
+                for (int32 X = Min.X; X <= Max.X; ++X)
+                {
+                    Visitor(FIntPoint(X, Y));
+                }
+            }
+        }
+    }
+
+private:
+    template<typename T>
+    static bool Exchange(T& Slot, T NewValue)
+    {
+        const bool bChanged = Slot != NewValue;
+        Slot = NewValue;
+        return bChanged;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridClearanceMap.h"
+#include "GridBitboard.h"
+
+void FGridClearanceMap::Init(FIntPoint InMin, FIntPoint InSize)
+{
+    Min = InMin;
+    Size = FIntPoint(FMath::Max(InSize.X, 0), FMath::Max(InSize.Y, 0));
+    Clearance.SetNumZeroed(Size.X * Size.Y);
+    DirtyMin = FIntPoint::ZeroValue;
+    DirtyMax = Size - FIntPoint(1, 1);
+}
+
+void FGridClearanceMap::MarkDirty(FIntPoint Grid)
+{
+    const FIntPoint Local = Grid - Min;
+    if (Local.X < 0 || Local.Y < 0 || Local.X >= Size.X || Local.Y >= Size.Y)
+    {
+        return;
+    }
+    DirtyMin = FIntPoint(FMath::Min(DirtyMin.X, Local.X), FMath::Min(DirtyMin.Y, Local.Y));
+    DirtyMax = FIntPoint(FMath::Max(DirtyMax.X, Local.X), FMath::Max(DirtyMax.Y, Local.Y));
+}
+
+void FGridClearanceMap::Update(const FGridBitboard& Walkable)
+{
+    if (!IsDirty())
+    {
+        return;
+    }
+
+    // 净空只依赖右上方（X+、Y+）的三个邻格：从脏区右上角向左下逆序重算，范围向左下扩展 MaxClearance - 1
+    const int32 X0 = FMath::Max(DirtyMin.X - (MaxClearance - 1), 0);
+    const int32 Y0 = FMath::Max(DirtyMin.Y - (MaxClearance - 1), 0);
+    for (int32 Y = DirtyMax.Y; Y >= Y0; --Y)
+    {
+        for (int32 X = DirtyMax.X; X >= X0; --X)
+        {
+            int32 Value = 0;
+            if (Walkable.TestBit(Min + FIntPoint(X, Y)))
+            {
+                Value = FMath::Min(1 + FMath::Min3(At(X + 1, Y), At(X, Y + 1), At(X + 1, Y + 1)), MaxClearance);
+            }
+            Clearance[Y * Size.X + X] = (uint8)Value;
+        }
+    }
+
+    DirtyMin = FIntPoint(MAX_int32, MAX_int32);
+    DirtyMax = FIntPoint(MIN_int32, MIN_int32);
+}
+
+int32 FGridClearanceMap::GetClearance(FIntPoint Grid) const
+{
+    checkSlow(!IsDirty());
+
+    const FIntPoint Local = Grid - Min;
+    if (Local.X < 0 || Local.Y < 0)
+    {
+        return 0;
+    }
+    return At(Local.X, Local.Y);
+}
\ No newline at end of file
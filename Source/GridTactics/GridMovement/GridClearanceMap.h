@@ -0,0 +1,45 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FGridBitboard;
+
+/**
+ * 通行净空图：每格记录以该格为最小角（X、Y 最小）的最大全可行走正方形边长，K x K 角色能否站在某处 O(1) 判断
+ * 取值截断到 MaxClearance，因此一个格子变化只影响其左下方 MaxClearance x MaxClearance 范围，Update 时只重算这一块
+ */
+struct GRIDTACTICS_API FGridClearanceMap
+{
+    // 支持的最大占地边长
+    static constexpr int32 MaxClearance = 8;
+
+    // 按包围盒分配，整表标记为脏
+    void Init(FIntPoint InMin, FIntPoint InSize);
+
+    void MarkDirty(FIntPoint Grid);
+    bool IsDirty() const { return DirtyMin.X <= DirtyMax.X && DirtyMin.Y <= DirtyMax.Y; }
+
+    // 从可行走位图重算脏区
+    void Update(const FGridBitboard& Walkable);
+
+    // 以 Grid 为最小角的净空边长，包围盒外返回 0；调用前需 Update
+    int32 GetClearance(FIntPoint Grid) const;
+
+private:
+    FIntPoint Min = FIntPoint::ZeroValue;
+    FIntPoint Size = FIntPoint::ZeroValue;
+
+    // 行优先
+    TArray<uint8> Clearance;
+
+    // 变化格子的包围盒（局部坐标），无脏区时 Min > Max
+    FIntPoint DirtyMin = FIntPoint(MAX_int32, MAX_int32);
+    FIntPoint DirtyMax = FIntPoint(MIN_int32, MIN_int32);
+
+    int32 At(int32 X, int32 Y) const
+    {
+        return (X < Size.X && Y < Size.Y) ? Clearance[Y * Size.X + X] : 0;
+    }
+};
\ No newline at end of file
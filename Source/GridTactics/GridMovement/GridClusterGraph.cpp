@@ -0,0 +1,367 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridClusterGraph.h"
+#include "GridBitboard.h"
+#include "GridTopology.h"
+
+void FGridClusterGraph::Init(FIntPoint InMin, FIntPoint InSize, int32 InClusterSize)
+{
+    Min = InMin;
+    Size = FIntPoint(FMath::Max(InSize.X, 0), FMath::Max(InSize.Y, 0));
+    ClusterSize = FMath::Clamp(InClusterSize, 4, 64);
+    ClusterCount = FIntPoint(FMath::DivideAndRoundUp(Size.X, ClusterSize), FMath::DivideAndRoundUp(Size.Y, ClusterSize));
+
+    Clusters.Reset();
+    Clusters.SetNum(ClusterCount.X * ClusterCount.Y);
+    for (int32 ClusterY = 0; ClusterY < ClusterCount.Y; ++ClusterY)
+    {
+        for (int32 ClusterX = 0; ClusterX < ClusterCount.X; ++ClusterX)
+        {
+            FCluster& Cluster = Clusters[ClusterY * ClusterCount.X + ClusterX];
+            Cluster.Min = FIntPoint(ClusterX * ClusterSize, ClusterY * ClusterSize);
+            Cluster.Size = FIntPoint(FMath::Min(ClusterSize, Size.X - Cluster.Min.X), FMath::Min(ClusterSize, Size.Y - Cluster.Min.Y));
+        }
+    }
+
+    NodeClusters.Reset();
+    NumNodes = 0;
+
+    WalkableBits.Init(false, Size.X * Size.Y);
+    DirtyClusters.Init(true, Clusters.Num());
+    bAnyDirty = Clusters.Num() > 0;
+}
+
+void FGridClusterGraph::MarkDirty(FIntPoint Grid)
+{
+    const FIntPoint Local = Grid - Min;
+    const int32 ClusterIndex = GetClusterIndex(Local);
+    if (ClusterIndex == INDEX_NONE)
+    {
+        return;
+    }
+    DirtyClusters[ClusterIndex] = true;
+    bAnyDirty = true;
+
+    // 边缘格子同时属于相邻簇的入口
+    const FCluster& Cluster = Clusters[ClusterIndex];
+    const FIntPoint InCluster = Local - Cluster.Min;
+    const int32 ClusterX = ClusterIndex % ClusterCount.X;
+    const int32 ClusterY = ClusterIndex / ClusterCount.X;
+    if (InCluster.X == 0 && ClusterX > 0)
+    {
+        DirtyClusters[ClusterIndex - 1] = true;
+    }
+    if (InCluster.X == Cluster.Size.X - 1 && ClusterX + 1 < ClusterCount.X)
+    {
+        DirtyClusters[ClusterIndex + 1] = true;
+    }
+    if (InCluster.Y == 0 && ClusterY > 0)
+    {
+        DirtyClusters[ClusterIndex - ClusterCount.X] = true;
+    }
+    if (InCluster.Y == Cluster.Size.Y - 1 && ClusterY + 1 < ClusterCount.Y)
+    {
+        DirtyClusters[ClusterIndex + ClusterCount.X] = true;
+    }
+}
+
+void FGridClusterGraph::Update(const FGridBitboard& Walkable)
+{
+    if (!bAnyDirty)
+    {
+        return;
+    }
+
+    // 先刷新所有脏簇的可行走位：扫描入口时会读到相邻簇的边缘格
+    for (TConstSetBitIterator<> It(DirtyClusters); It; ++It)
+    {
+        const FCluster& Cluster = Clusters[It.GetIndex()];
+        for (int32 Y = Cluster.Min.Y; Y < Cluster.Min.Y + Cluster.Size.Y; ++Y)
+        {
+            for (int32 X = Cluster.Min.X; X < Cluster.Min.X + Cluster.Size.X; ++X)
+            {
+                WalkableBits[Y * Size.X + X] = Walkable.TestBit(Min + FIntPoint(X, Y));
+            }
+        }
+    }
+
+    for (TConstSetBitIterator<> It(DirtyClusters); It; ++It)
+    {
+        RebuildCluster(It.GetIndex());
+    }
+
+    // 重建过的簇节点数可能变化，重新编号（只按簇遍历一次）
+    NumNodes = 0;
+    for (FCluster& Cluster : Clusters)
+    {
+        Cluster.FirstNode = NumNodes;
+        NumNodes += Cluster.Nodes.Num();
+    }
+    NodeClusters.SetNumUninitialized(NumNodes);
+    for (int32 ClusterIndex = 0; ClusterIndex < Clusters.Num(); ++ClusterIndex)
+    {
+        const FCluster& Cluster = Clusters[ClusterIndex];
+        for (int32 NodeIndex = 0; NodeIndex < Cluster.Nodes.Num(); ++NodeIndex)
+        {
+            NodeClusters[Cluster.FirstNode + NodeIndex] = ClusterIndex;
+        }
+    }
+
+    DirtyClusters.Init(false, Clusters.Num());
+    bAnyDirty = false;
+}
+
+bool FGridClusterGraph::FindAbstractPath(FIntPoint Start, FIntPoint Goal, TArray<FIntPoint>& OutNodes, int32& OutCost,
+    int32& OutExpandedNodes, int32 MaxExpandedNodes) const
+{
+    checkSlow(!IsDirty());
+
+    OutNodes.Reset();
+    OutCost = 0;
+    OutExpandedNodes = 0;
+
+    const FIntPoint LocalStart = Start - Min;
+    const FIntPoint LocalGoal = Goal - Min;
+    if (!IsOpen(LocalStart) || !IsOpen(LocalGoal))
+    {
+        return false;
+    }
+    if (Start == Goal)
+    {
+        OutNodes.Add(Start);
+        return true;
+    }
+
+    // 起点和终点临时接入所在簇的节点
+    const int32 StartClusterIndex = GetClusterIndex(LocalStart);
+    const int32 GoalClusterIndex = GetClusterIndex(LocalGoal);
+    const FCluster& StartCluster = Clusters[StartClusterIndex];
+    const FCluster& GoalCluster = Clusters[GoalClusterIndex];
+
+    TArray<int32> StartDistances;
+    TArray<int32> GoalDistances;
+    ComputeClusterDistances(StartCluster, LocalStart, StartDistances);
+    ComputeClusterDistances(GoalCluster, LocalGoal, GoalDistances);
+
+    auto DistanceAt = [](const FCluster& Cluster, const TArray<int32>& Distances, FIntPoint Local)
+    {
+        const FIntPoint InCluster = Local - Cluster.Min;
+        return Distances[InCluster.Y * Cluster.Size.X + InCluster.X];
+    };
+    auto Heuristic = [&LocalGoal](FIntPoint Local)
+    {
+        return FMath::Abs(Local.X - LocalGoal.X) + FMath::Abs(Local.Y - LocalGoal.Y);
+    };
+
+    const int32 StartId = NumNodes;
+    const int32 GoalId = NumNodes + 1;
+    auto GetNodeLocal = [&](int32 Id)
+    {
+        if (Id == StartId)
+        {
+            return LocalStart;
+        }
+        if (Id == GoalId)
+        {
+            return LocalGoal;
+        }
+        const FCluster& Cluster = Clusters[NodeClusters[Id]];
+        return Cluster.Nodes[Id - Cluster.FirstNode];
+    };
+
+    // 起点与终点可能和入口节点重合，对应的边代价为 0
+    auto ExpandNodes = [&](int32 Id, int32 ParentId, auto&& AddSuccessor)
+    {
+        if (Id == StartId)
+        {
+            for (int32 NodeIndex = 0; NodeIndex < StartCluster.Nodes.Num(); ++NodeIndex)
+            {
+                const FIntPoint Node = StartCluster.Nodes[NodeIndex];
+                const int32 Distance = DistanceAt(StartCluster, StartDistances, Node);
+                if (Distance >= 0)
+                {
+                    AddSuccessor(StartCluster.FirstNode + NodeIndex, Distance, Heuristic(Node));
+                }
+            }
+            if (StartClusterIndex == GoalClusterIndex)
+            {
+                const int32 Distance = DistanceAt(StartCluster, StartDistances, LocalGoal);
+                if (Distance >= 0)
+                {
+                    AddSuccessor(GoalId, Distance, 0);
+                }
+            }
+            return;
+        }
+
+        const int32 ClusterIndex = NodeClusters[Id];
+        const FCluster& Cluster = Clusters[ClusterIndex];
+        const int32 NodeIndex = Id - Cluster.FirstNode;
+        const FIntPoint Local = Cluster.Nodes[NodeIndex];
+
+        // 簇内边
+        const int32 NumClusterNodes = Cluster.Nodes.Num();
+        for (int32 Other = 0; Other < NumClusterNodes; ++Other)
+        {
+            const int32 Distance = Cluster.Distances[NodeIndex * NumClusterNodes + Other];
+            if (Distance > 0)
+            {
+                AddSuccessor(Cluster.FirstNode + Other, Distance, Heuristic(Cluster.Nodes[Other]));
+            }
+        }
+
+        // 跨簇边：入口另一侧的节点
+        FGridTopology4::ForEachNeighbor(Local, [&](FIntPoint Next, int32)
+        {
+            const int32 NextClusterIndex = GetClusterIndex(Next);
+            if (NextClusterIndex == INDEX_NONE || NextClusterIndex == ClusterIndex)
+            {
+                return;
+            }
+            const FCluster& NextCluster = Clusters[NextClusterIndex];
+            const int32 NextNodeIndex = NextCluster.Nodes.IndexOfByKey(Next);
+            if (NextNodeIndex != INDEX_NONE)
+            {
+                AddSuccessor(NextCluster.FirstNode + NextNodeIndex, 1, Heuristic(Next));
+            }
+        });
+
+        if (ClusterIndex == GoalClusterIndex)
+        {
+            const int32 Distance = DistanceAt(GoalCluster, GoalDistances, Local);
+            if (Distance >= 0)
+            {
+                AddSuccessor(GoalId, Distance, 0);
+            }
+        }
+    };
+
+    const bool bFound = AbstractSearch.SearchGraph(NumNodes + 2, StartId, GoalId, Heuristic(LocalStart), ExpandNodes,
+        AbstractPathIds, OutCost, MaxExpandedNodes);
+    OutExpandedNodes = AbstractSearch.GetExpandedCount();
+    if (!bFound)
+    {
+        return false;
+    }
+
+    // 与入口重合的起点/终点只保留一项
+    OutNodes.Reserve(AbstractPathIds.Num());
+    for (const int32 Id : AbstractPathIds)
+    {
+        const FIntPoint Grid = Min + GetNodeLocal(Id);
+        if (OutNodes.Num() == 0 || OutNodes.Last() != Grid)
+        {
+            OutNodes.Add(Grid);
+        }
+    }
+    return true;
+}
+
+SIZE_T FGridClusterGraph::GetAllocatedSize() const
+{
+    SIZE_T Bytes = Clusters.GetAllocatedSize() + NodeClusters.GetAllocatedSize() + WalkableBits.GetAllocatedSize() + DirtyClusters.GetAllocatedSize();
+    for (const FCluster& Cluster : Clusters)
+    {
+        Bytes += Cluster.Nodes.GetAllocatedSize() + Cluster.Distances.GetAllocatedSize();
+    }
+    return Bytes;
+}
+
+void FGridClusterGraph::AddBorderNodes(FCluster& Cluster, FIntPoint Start, FIntPoint Step, FIntPoint Across, int32 Length) const
+{
+    int32 RunStart = INDEX_NONE;
+    for (int32 Index = 0; Index <= Length; ++Index)
+    {
+        const FIntPoint Cell = Start + Step * Index;
+        if (Index < Length && IsOpen(Cell) && IsOpen(Cell + Across))
+        {
+            if (RunStart == INDEX_NONE)
+            {
+                RunStart = Index;
+            }
+            continue;
+        }
+        if (RunStart == INDEX_NONE)
+        {
+            continue;
+        }
+
+        // 两侧的簇按同样的规则扫描同一条边，节点位置一致
+        const int32 RunLength = Index - RunStart;
+        if (RunLength >= EntranceSplitLength)
+        {
+            Cluster.Nodes.AddUnique(Start + Step * RunStart);
+            Cluster.Nodes.AddUnique(Start + Step * (Index - 1));
+        }
+        else
+        {
+            Cluster.Nodes.AddUnique(Start + Step * (RunStart + RunLength / 2));
+        }
+        RunStart = INDEX_NONE;
+    }
+}
+
+void FGridClusterGraph::RebuildCluster(int32 ClusterIndex)
+{
+    FCluster& Cluster = Clusters[ClusterIndex];
+    const FIntPoint Max = Cluster.Min + Cluster.Size - FIntPoint(1, 1);
+
+    Cluster.Nodes.Reset();
+    AddBorderNodes(Cluster, FIntPoint(Max.X, Cluster.Min.Y), FIntPoint(0, 1), FIntPoint(1, 0), Cluster.Size.Y);
+    AddBorderNodes(Cluster, FIntPoint(Cluster.Min.X, Max.Y), FIntPoint(1, 0), FIntPoint(0, 1), Cluster.Size.X);
+    AddBorderNodes(Cluster, Cluster.Min, FIntPoint(0, 1), FIntPoint(-1, 0), Cluster.Size.Y);
+    AddBorderNodes(Cluster, Cluster.Min, FIntPoint(1, 0), FIntPoint(0, -1), Cluster.Size.X);
+
+    // 每个节点做一次簇内广度优先，填满距离矩阵的一行
+    const int32 NumNodes = Cluster.Nodes.Num();
+    Cluster.Distances.Init(INDEX_NONE, NumNodes * NumNodes);
+    TArray<int32> Distances;
+    for (int32 From = 0; From < NumNodes; ++From)
+    {
+        ComputeClusterDistances(Cluster, Cluster.Nodes[From], Distances);
+        for (int32 To = 0; To < NumNodes; ++To)
+        {
+            const FIntPoint InCluster = Cluster.Nodes[To] - Cluster.Min;
+            Cluster.Distances[From * NumNodes + To] = Distances[InCluster.Y * Cluster.Size.X + InCluster.X];
+        }
+    }
+}
+
+void FGridClusterGraph::ComputeClusterDistances(const FCluster& Cluster, FIntPoint Source, TArray<int32>& OutDistances) const
+{
+    OutDistances.Init(INDEX_NONE, Cluster.Size.X * Cluster.Size.Y);
+
+    auto ToIndex = [&Cluster](FIntPoint Local)
+    {
+        const FIntPoint InCluster = Local - Cluster.Min;
+        if (InCluster.X < 0 || InCluster.Y < 0 || InCluster.X >= Cluster.Size.X || InCluster.Y >= Cluster.Size.Y)
+        {
+            return (int32)INDEX_NONE;
+        }
+        return InCluster.Y * Cluster.Size.X + InCluster.X;
+    };
+
+    const int32 SourceIndex = ToIndex(Source);
+    if (SourceIndex == INDEX_NONE || !IsOpen(Source))
+    {
+        return;
+    }
+
+    TArray<FIntPoint> Queue;
+    Queue.Reserve(OutDistances.Num());
+    OutDistances[SourceIndex] = 0;
+    Queue.Add(Source);
+    for (int32 Head = 0; Head < Queue.Num(); ++Head)
+    {
+        const int32 NextDistance = OutDistances[ToIndex(Queue[Head])] + 1;
+        FGridTopology4::ForEachNeighbor(Queue[Head], [&](FIntPoint Next, int32)
+        {
+            const int32 NextIndex = ToIndex(Next);
+            if (NextIndex != INDEX_NONE && OutDistances[NextIndex] == INDEX_NONE && IsOpen(Next))
+            {
+                OutDistances[NextIndex] = NextDistance;
+                Queue.Add(Next);
+            }
+        });
+    }
+}
\ No newline at end of file
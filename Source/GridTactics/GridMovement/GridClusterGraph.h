@@ -0,0 +1,154 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridAStar.h"
+
+struct FGridBitboard;
+
+/**
+ * HPA* 分层寻路图（统一代价的地形寻路）
+ * 地图按 ClusterSize x ClusterSize 切成簇，相邻簇边界上连续可通行的一段为一个入口，入口两侧各放一个节点
+ * 簇内节点两两之间的距离预先算好，跨簇的一对节点距离为 1；查询时只在节点图上搜索（节点数组按节点数分配），逐格路径按段在单个簇内细化
+ * 格子变化只标记所在簇（位于簇边缘时连同相邻簇），Update 时只重建这些簇
+ */
+struct GRIDTACTICS_API FGridClusterGraph
+{
+    static constexpr int32 DefaultClusterSize = 16;
+
+    // 入口长度达到此值时在两端各放一个节点，否则只在中点放一个
+    static constexpr int32 EntranceSplitLength = 6;
+
+    // 按包围盒分配，所有簇标记为脏
+    void Init(FIntPoint InMin, FIntPoint InSize, int32 InClusterSize = DefaultClusterSize);
+
+    void MarkDirty(FIntPoint Grid);
+    bool IsDirty() const { return bAnyDirty; }
+
+    // 从可行走位图重建脏簇
+    void Update(const FGridBitboard& Walkable);
+
+    // 抽象路径：起点、经过的入口节点、终点；相邻两项要么在同一簇内，要么跨簇边界相邻。调用前需 Update
+    // 抽象层只看地形、按步数计代价；MaxExpandedNodes 限制的是抽象图上扩展的节点数
+    bool FindAbstractPath(FIntPoint Start, FIntPoint Goal, TArray<FIntPoint>& OutNodes, int32& OutCost,
+        int32& OutExpandedNodes, int32 MaxExpandedNodes = 0) const;
+
+    // 细化抽象路径的一段，逐格追加到 OutPath（不含 From）；GetEnterCost 规则同 FGridAStar::FindPath，搜索限制在 From 所在簇内
+    // 簇已重建或代价规则（占位等）导致走不通时返回 false
+    template<typename EnterCostFuncType>
+    bool RefineSegment(FIntPoint From, FIntPoint To, EnterCostFuncType&& GetEnterCost, TArray<FIntPoint>& OutPath,
+        int32 MaxExpandedNodes = 0) const;
+
+    int32 GetClusterSize() const { return ClusterSize; }
+    int32 GetNumClusters() const { return Clusters.Num(); }
+    int32 GetNumNodes() const { return NumNodes; }
+
+    // 节点图本身占用的内存
+    SIZE_T GetAllocatedSize() const;
+
+    // 抽象搜索复用的节点数组占用的内存（按节点数分配，与整图的 A* 节点池无关）
+    SIZE_T GetSearchAllocatedSize() const { return AbstractSearch.GetAllocatedSize() + AbstractPathIds.GetAllocatedSize(); }
+
+private:
+    struct FCluster
+    {
+        // 局部坐标
+        FIntPoint Min = FIntPoint::ZeroValue;
+        FIntPoint Size = FIntPoint::ZeroValue;
+
+        // 入口节点（局部坐标）
+        TArray<FIntPoint> Nodes;
+
+        // Nodes[0] 在整张节点图中的编号，Update 时按簇顺序重新分配
+        int32 FirstNode = 0;
+
+        // Nodes.Num() x Nodes.Num() 的簇内距离，INDEX_NONE 为簇内不可达
+        TArray<int32> Distances;
+    };
+
+    FIntPoint Min = FIntPoint::ZeroValue;
+    FIntPoint Size = FIntPoint::ZeroValue;
+    int32 ClusterSize = DefaultClusterSize;
+    FIntPoint ClusterCount = FIntPoint::ZeroValue;
+
+    TArray<FCluster> Clusters;
+
+    // 节点编号 -> 所在簇
+    TArray<int32> NodeClusters;
+    int32 NumNodes = 0;
+
+    // 抽象搜索：节点编号 [0, NumNodes) 为入口节点，NumNodes / NumNodes + 1 为临时接入的起点 / 终点
+    mutable FGridAStar AbstractSearch;
+    mutable TArray<int32> AbstractPathIds;
+
+    // 可行走位（行优先），Update 时从位图拷贝脏簇的部分
+    TBitArray<> WalkableBits;
+
+    TBitArray<> DirtyClusters;
+    bool bAnyDirty = false;
+
+    // 以下均为包围盒内的局部坐标
+    bool IsOpen(FIntPoint Local) const
+    {
+        return Local.X >= 0 && Local.Y >= 0 && Local.X < Size.X && Local.Y < Size.Y && WalkableBits[Local.Y * Size.X + Local.X];
+    }
+
+    int32 GetClusterIndex(FIntPoint Local) const
+    {
+        if (Local.X < 0 || Local.Y < 0 || Local.X >= Size.X || Local.Y >= Size.Y)
+        {
+            return INDEX_NONE;
+        }
+        return (Local.Y / ClusterSize) * ClusterCount.X + Local.X / ClusterSize;
+    }
+
+    // 沿簇的一条边扫描入口：Start 起沿 Step 走 Length 格，本侧与 Start + Across 一侧都可通行的连续段为一个入口
+    void AddBorderNodes(FCluster& Cluster, FIntPoint Start, FIntPoint Step, FIntPoint Across, int32 Length) const;
+
+    void RebuildCluster(int32 ClusterIndex);
+
+    // 簇内广度优先，OutDistances 按簇内行优先排列，不可达为 INDEX_NONE
+    void ComputeClusterDistances(const FCluster& Cluster, FIntPoint Source, TArray<int32>& OutDistances) const;
+};
+
+template<typename EnterCostFuncType>
+bool FGridClusterGraph::RefineSegment(FIntPoint From, FIntPoint To, EnterCostFuncType&& GetEnterCost, TArray<FIntPoint>& OutPath,
+    int32 MaxExpandedNodes) const
+{
+    const FIntPoint LocalFrom = From - Min;
+    const FIntPoint LocalTo = To - Min;
+    const int32 FromClusterIndex = GetClusterIndex(LocalFrom);
+    const int32 ToClusterIndex = GetClusterIndex(LocalTo);
+    if (FromClusterIndex == INDEX_NONE || ToClusterIndex == INDEX_NONE || !IsOpen(LocalFrom) || !IsOpen(LocalTo))
+    {
+        return false;
+    }
+    if (From == To)
+    {
+        return true;
+    }
+
+    // 跨簇的一段就是入口两侧之间的一步
+    if (FromClusterIndex != ToClusterIndex)
+    {
+        const FIntPoint Delta = To - From;
+        if (FMath::Abs(Delta.X) + FMath::Abs(Delta.Y) != 1 || GetEnterCost(To) <= 0)
+        {
+            return false;
+        }
+        OutPath.Add(To);
+        return true;
+    }
+
+    // 簇内 A*，只在簇的范围内搜索
+    const FCluster& Cluster = Clusters[FromClusterIndex];
+    TArray<FIntPoint> Segment;
+    int32 SegmentCost = 0;
+    if (!FGridAStar::Get().FindPath(Min + Cluster.Min, Cluster.Size, From, To, GetEnterCost, Segment, SegmentCost, MaxExpandedNodes))
+    {
+        return false;
+    }
+    OutPath.Append(Segment.GetData() + 1, Segment.Num() - 1);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridFieldOfView.h"
+
+namespace GridFieldOfView
+{
+    // 斜率分数 Num / Den（Den > 0）
+    struct FSlope
+    {
+        int32 Num;
+        int32 Den;
+    };
+
+    // 向下取整的整数除法（Den > 0）
+    int32 FloorDiv(int32 Num, int32 Den)
+    {
+        return Num >= 0 ? Num / Den : -((-Num + Den - 1) / Den);
+    }
+
+    // 一个象限内按深度扫描的一行
+    struct FRow
+    {
+        int32 Depth;
+        FSlope Start;
+        FSlope End;
+
+        // Depth * Start 四舍五入（0.5 向上）
+        int32 MinCol() const { return FloorDiv(2 * Depth * Start.Num + Start.Den, 2 * Start.Den); }
+
+        // Depth * End 四舍五入（0.5 向下）
+        int32 MaxCol() const { return -FloorDiv(-(2 * Depth * End.Num - End.Den), 2 * End.Den); }
+
+        // 格子中心是否落在本行的可见扇区内（保证对称性）
+        bool IsSymmetric(int32 Col) const
+        {
+            return Col * Start.Den >= Depth * Start.Num && Col * End.Den <= Depth * End.Num;
+        }
+    };
+
+    struct FScanContext
+    {
+        FIntPoint Origin;
+        int32 Radius;
+        int32 Quadrant;
+        TFunctionRef<bool(FIntPoint)> IsOpaque;
+        FGridBitboard& Visible;
+
+        // 象限坐标 (深度, 列) -> 格子坐标：0 = Y-，1 = X+，2 = Y+，3 = X-
+        FIntPoint Transform(int32 Depth, int32 Col) const
+        {
+            switch (Quadrant)
+            {
+            case 0:  return FIntPoint(Origin.X + Col, Origin.Y - Depth);
+            case 1:  return FIntPoint(Origin.X + Depth, Origin.Y + Col);
+            case 2:  return FIntPoint(Origin.X + Col, Origin.Y + Depth);
+            default: return FIntPoint(Origin.X - Depth, Origin.Y + Col);
+            }
+        }
+
+        void Reveal(int32 Depth, int32 Col)
+        {
+            if (Depth * Depth + Col * Col <= Radius * Radius + Radius)
+            {
+                Visible.SetBit(Transform(Depth, Col), true);
+            }
+        }
+
+        void Scan(FRow Row)
+        {
+            if (Row.Depth > Radius)
+            {
+                return;
+            }
+
+            // -1 = 尚无前一格，0 = 透光，1 = 墙
+            int32 PrevState = -1;
+            const int32 MaxCol = Row.MaxCol();
+            for (int32 Col = Row.MinCol(); Col <= MaxCol; ++Col)
+            {
+                const bool bWall = IsOpaque(Transform(Row.Depth, Col));
+                if (bWall || Row.IsSymmetric(Col))
+                {
+                    Reveal(Row.Depth, Col);
+                }
+
+                // 斜率 (2 * Col - 1) / (2 * Depth)：格子左边缘
+                if (PrevState == 1 && !bWall)
+                {
+                    Row.Start = { 2 * Col - 1, 2 * Row.Depth };
+                }
+                if (PrevState == 0 && bWall)
+                {
+                    Scan({ Row.Depth + 1, Row.Start, { 2 * Col - 1, 2 * Row.Depth } });
+                }
+                PrevState = bWall ? 1 : 0;
+            }
+
+            if (PrevState == 0)
+            {
+                Scan({ Row.Depth + 1, Row.Start, Row.End });
+            }
+        }
+    };
+}
+
+void FGridFieldOfView::Compute(FIntPoint Origin, int32 Radius, TFunctionRef<bool(FIntPoint Grid)> IsOpaque, FGridBitboard& OutVisible)
+{
+    Radius = FMath::Max(Radius, 0);
+    OutVisible.Init(Origin - FIntPoint(Radius, Radius), FIntPoint(2 * Radius + 1, 2 * Radius + 1));
+    OutVisible.SetBit(Origin, true);
+
+    for (int32 Quadrant = 0; Quadrant < 4; ++Quadrant)
+    {
+        GridFieldOfView::FScanContext Context{ Origin, Radius, Quadrant, IsOpaque, OutVisible };
+        Context.Scan({ 1, { -1, 1 }, { 1, 1 } });
+    }
+}
\ No newline at end of file
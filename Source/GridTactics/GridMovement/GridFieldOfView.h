@@ -0,0 +1,15 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBitboard.h"
+
+/**
+ * 对称阴影投射视野：A 能看到 B 当且仅当 B 能看到 A（墙体本身可见，但不透光）
+ * 结果写入以 Origin 为中心、边长 2 * Radius + 1 的位图，只标记欧氏距离 <= Radius 的格子
+ */
+struct GRIDTACTICS_API FGridFieldOfView
+{
+    static void Compute(FIntPoint Origin, int32 Radius, TFunctionRef<bool(FIntPoint Grid)> IsOpaque, FGridBitboard& OutVisible);
+};
\ No newline at end of file
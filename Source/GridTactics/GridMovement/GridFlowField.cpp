@@ -0,0 +1,104 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridFlowField.h"
+#include "GridTopology.h"
+#include "GridTactics/GridTactics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Flow Field Build"), STAT_GridFlowFieldBuild, STATGROUP_GridTactics);
+
+void FGridFlowField::Build(FIntPoint InMin, FIntPoint InSize, FIntPoint InGoal, TFunctionRef<int32(FIntPoint Grid)> GetEnterCost)
+{
+    SCOPE_CYCLE_COUNTER(STAT_GridFlowFieldBuild);
+
+    Min = InMin;
+    Size = FIntPoint(FMath::Max(InSize.X, 0), FMath::Max(InSize.Y, 0));
+    Goal = InGoal;
+    ReachedCount = 0;
+
+    const int32 NumCells = Size.X * Size.Y;
+    Integration.Init(MAX_int32, NumCells);
+    Directions.Init(NoDirection, NumCells);
+
+    const int32 GoalIndex = ToIndex(Goal);
+    if (GoalIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    // 进入代价每格只查一次（0 = 尚未查询）
+    TArray<int32> EnterCosts;
+    EnterCosts.SetNumZeroed(NumCells);
+    auto GetCachedEnterCost = [&](int32 Index)
+    {
+        if (EnterCosts[Index] == 0)
+        {
+            const int32 Cost = GetEnterCost(Min + FIntPoint(Index % Size.X, Index / Size.X));
+            EnterCosts[Index] = Cost > 0 ? Cost : -1;
+        }
+        return EnterCosts[Index];
+    };
+
+    struct FOpenCell
+    {
+        int32 Cost;
+        int32 Index;
+    };
+    auto OpenCellPredicate = [](const FOpenCell& A, const FOpenCell& B) { return A.Cost < B.Cost; };
+
+    TArray<FOpenCell> OpenHeap;
+    Integration[GoalIndex] = 0;
+    OpenHeap.HeapPush(FOpenCell{ 0, GoalIndex }, OpenCellPredicate);
+
+    // 反向扩展：从 V 走进 U 的代价是 U 的进入代价，终点本身不可通行时（例如被标成障碍的目标格）按 1 计
+    while (OpenHeap.Num() > 0)
+    {
+        FOpenCell Cell;
+        OpenHeap.HeapPop(Cell, OpenCellPredicate, EAllowShrinking::No);
+        if (Cell.Cost != Integration[Cell.Index])
+        {
+            continue;
+        }
+        ++ReachedCount;
+
+        const int32 StepCost = Cell.Index == GoalIndex ? FMath::Max(GetCachedEnterCost(Cell.Index), 1) : GetCachedEnterCost(Cell.Index);
+        const FIntPoint Grid = Min + FIntPoint(Cell.Index % Size.X, Cell.Index / Size.X);
+        FGridTopology4::ForEachNeighbor(Grid, [&](FIntPoint Next, int32 Dir)
+        {
+            const int32 NextIndex = ToIndex(Next);
+            if (NextIndex == INDEX_NONE || GetCachedEnterCost(NextIndex) < 0)
+            {
+                return;
+            }
+            const int32 NewCost = Cell.Cost + StepCost;
+            if (NewCost < Integration[NextIndex])
+            {
+                Integration[NextIndex] = NewCost;
+                Directions[NextIndex] = (uint8)FGridTopology4::WrapDirectionIndex(Dir + FGridTopology4::NumDirections / 2);
+                OpenHeap.HeapPush(FOpenCell{ NewCost, NextIndex }, OpenCellPredicate);
+            }
+        });
+    }
+}
+
+int32 FGridFlowField::GetIntegration(FIntPoint Grid) const
+{
+    const int32 Index = ToIndex(Grid);
+    return (Index != INDEX_NONE && Integration[Index] != MAX_int32) ? Integration[Index] : INDEX_NONE;
+}
+
+int32 FGridFlowField::GetDirectionIndex(FIntPoint Grid) const
+{
+    const int32 Index = ToIndex(Grid);
+    return (Index != INDEX_NONE && Directions[Index] != NoDirection) ? Directions[Index] : INDEX_NONE;
+}
+
+bool FGridFlowField::GetNextStep(FIntPoint Grid, FIntPoint& OutNextGrid) const
+{
+    const int32 DirectionIndex = GetDirectionIndex(Grid);
+    if (DirectionIndex == INDEX_NONE)
+    {
+        return false;
+    }
+    OutNextGrid = FGridTopology4::GetNeighbor(Grid, DirectionIndex);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 单一终点的流场：以终点为源做 Dijkstra 波前，得到每格到终点的累计代价（积分场）和朝终点走的下一步方向（方向场）
+ * 任意多个角色读取下一步都是 O(1)，终点或格子变化后才需要重建
+ */
+struct GRIDTACTICS_API FGridFlowField
+{
+    static constexpr uint8 NoDirection = 0xFF;
+
+    // 在 [InMin, InMin + InSize) 内构建；GetEnterCost 返回进入格子的代价，<= 0 为不可通行
+    void Build(FIntPoint InMin, FIntPoint InSize, FIntPoint InGoal, TFunctionRef<int32(FIntPoint Grid)> GetEnterCost);
+
+    FIntPoint GetGoal() const { return Goal; }
+
+    // 到终点的累计代价，不可达返回 INDEX_NONE
+    int32 GetIntegration(FIntPoint Grid) const;
+
+    // 朝终点的下一步方向（FGridTopology4 下标），终点本身或不可达返回 INDEX_NONE
+    int32 GetDirectionIndex(FIntPoint Grid) const;
+
+    bool GetNextStep(FIntPoint Grid, FIntPoint& OutNextGrid) const;
+
+    // 能到达终点的格子数（含终点）
+    int32 GetReachedCount() const { return ReachedCount; }
+
+    SIZE_T GetAllocatedSize() const { return Integration.GetAllocatedSize() + Directions.GetAllocatedSize(); }
+
+private:
+    FIntPoint Min = FIntPoint::ZeroValue;
+    FIntPoint Size = FIntPoint::ZeroValue;
+    FIntPoint Goal = FIntPoint::ZeroValue;
+
+    // 行优先，不可达为 MAX_int32
+    TArray<int32> Integration;
+    TArray<uint8> Directions;
+
+    int32 ReachedCount = 0;
+
+    int32 ToIndex(FIntPoint Grid) const
+    {
+        const FIntPoint Local = Grid - Min;
+        if (Local.X < 0 || Local.Y < 0 || Local.X >= Size.X || Local.Y >= Size.Y)
+        {
+            return INDEX_NONE;
+        }
+        return Local.Y * Size.X + Local.X;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,225 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridJumpPointTable.h"
+#include "GridBitboard.h"
+#include "GridTopology.h"
+
+void FGridJumpPointTable::Init(FIntPoint InMin, FIntPoint InSize)
+{
+    Min = InMin;
+    Size = FIntPoint(FMath::Max(InSize.X, 0), FMath::Max(InSize.Y, 0));
+    for (TArray<int32>& Table : Distances)
+    {
+        Table.SetNumZeroed(Size.X * Size.Y);
+    }
+    HorizontalJumpFlags.Init(false, Size.X * Size.Y);
+    WalkableBits.Init(false, Size.X * Size.Y);
+    DirtyRows.Init(true, Size.Y);
+    DirtyColumns.Init(true, Size.X);
+    bAnyDirty = Size.X > 0 && Size.Y > 0;
+}
+
+void FGridJumpPointTable::MarkDirty(FIntPoint Grid)
+{
+    const FIntPoint Local = Grid - Min;
+    if (Local.X < 0 || Local.Y < 0 || Local.X >= Size.X || Local.Y >= Size.Y)
+    {
+        return;
+    }
+
+    // 强迫邻居判断会看上下两行
+    for (int32 Y = FMath::Max(Local.Y - 1, 0); Y <= FMath::Min(Local.Y + 1, Size.Y - 1); ++Y)
+    {
+        DirtyRows[Y] = true;
+    }
+    DirtyColumns[Local.X] = true;
+    bAnyDirty = true;
+}
+
+void FGridJumpPointTable::Update(const FGridBitboard& Walkable)
+{
+    if (!bAnyDirty)
+    {
+        return;
+    }
+
+    // 先刷新所有脏行的可行走位，再重算水平表（重算时会读相邻行）
+    for (TConstSetBitIterator<> It(DirtyRows); It; ++It)
+    {
+        const int32 Y = It.GetIndex();
+        for (int32 X = 0; X < Size.X; ++X)
+        {
+            WalkableBits[Y * Size.X + X] = Walkable.TestBit(Min + FIntPoint(X, Y));
+        }
+    }
+    for (TConstSetBitIterator<> It(DirtyRows); It; ++It)
+    {
+        RebuildRow(It.GetIndex());
+    }
+    for (TConstSetBitIterator<> It(DirtyColumns); It; ++It)
+    {
+        RebuildColumn(It.GetIndex());
+    }
+
+    DirtyRows.SetRange(0, Size.Y, false);
+    DirtyColumns.SetRange(0, Size.X, false);
+    bAnyDirty = false;
+}
+
+void FGridJumpPointTable::RebuildRow(int32 Y)
+{
+    const int32 Row = Y * Size.X;
+    int32* East = Distances[0].GetData() + Row;
+    int32* West = Distances[2].GetData() + Row;
+
+    // 东向：从右往左，下一格是墙为 0，是跳点（向东到达时有强迫邻居）为 1，否则在下一格的基础上延长
+    for (int32 X = Size.X - 1; X >= 0; --X)
+    {
+        const int32 NextX = X + 1;
+        if (!IsOpen(NextX, Y))
+        {
+            East[X] = 0;
+        }
+        else if (IsForcedVertical(NextX, Y, 1, 1) || IsForcedVertical(NextX, Y, 1, -1))
+        {
+            East[X] = 1;
+        }
+        else
+        {
+            East[X] = East[NextX] > 0 ? East[NextX] + 1 : East[NextX] - 1;
+        }
+    }
+
+    for (int32 X = 0; X < Size.X; ++X)
+    {
+        const int32 NextX = X - 1;
+        if (!IsOpen(NextX, Y))
+        {
+            West[X] = 0;
+        }
+        else if (IsForcedVertical(NextX, Y, -1, 1) || IsForcedVertical(NextX, Y, -1, -1))
+        {
+            West[X] = 1;
+        }
+        else
+        {
+            West[X] = West[NextX] > 0 ? West[NextX] + 1 : West[NextX] - 1;
+        }
+    }
+
+    // 水平跳点标记变化的列，其竖直表需要重算
+    for (int32 X = 0; X < Size.X; ++X)
+    {
+        const bool bHasJump = East[X] > 0 || West[X] > 0;
+        if (HorizontalJumpFlags[Row + X] != bHasJump)
+        {
+            HorizontalJumpFlags[Row + X] = bHasJump;
+            DirtyColumns[X] = true;
+        }
+    }
+}
+
+void FGridJumpPointTable::RebuildColumn(int32 X)
+{
+    int32* North = Distances[1].GetData();
+    int32* South = Distances[3].GetData();
+
+    // 竖直移动时，水平跳跃能找到跳点的格子就是跳点
+    for (int32 Y = Size.Y - 1; Y >= 0; --Y)
+    {
+        const int32 NextY = Y + 1;
+        const int32 Index = Y * Size.X + X;
+        const int32 NextIndex = Index + Size.X;
+        if (!IsOpen(X, NextY))
+        {
+            North[Index] = 0;
+        }
+        else if (HorizontalJumpFlags[NextIndex])
+        {
+            North[Index] = 1;
+        }
+        else
+        {
+            North[Index] = North[NextIndex] > 0 ? North[NextIndex] + 1 : North[NextIndex] - 1;
+        }
+    }
+
+    for (int32 Y = 0; Y < Size.Y; ++Y)
+    {
+        const int32 NextY = Y - 1;
+        const int32 Index = Y * Size.X + X;
+        const int32 NextIndex = Index - Size.X;
+        if (!IsOpen(X, NextY))
+        {
+            South[Index] = 0;
+        }
+        else if (HorizontalJumpFlags[NextIndex])
+        {
+            South[Index] = 1;
+        }
+        else
+        {
+            South[Index] = South[NextIndex] > 0 ? South[NextIndex] + 1 : South[NextIndex] - 1;
+        }
+    }
+}
+
+int32 FGridJumpPointTable::GetJumpDistance(FIntPoint Grid, int32 DirectionIndex) const
+{
+    checkSlow(!bAnyDirty);
+
+    const FIntPoint Local = Grid - Min;
+    if (Local.X < 0 || Local.Y < 0 || Local.X >= Size.X || Local.Y >= Size.Y
+        || DirectionIndex < 0 || DirectionIndex >= NumDirections)
+    {
+        return 0;
+    }
+    return Distances[DirectionIndex][Local.Y * Size.X + Local.X];
+}
+
+bool FGridJumpPointTable::HasForcedVerticalNeighbor(FIntPoint Grid, int32 DirX, int32 DirY) const
+{
+    const FIntPoint Local = Grid - Min;
+    return IsForcedVertical(Local.X, Local.Y, DirX, DirY);
+}
+
+bool FGridJumpPointTable::Jump(FIntPoint Grid, int32 DirectionIndex, FIntPoint Goal, FIntPoint& OutJumpPoint) const
+{
+    const int32 Distance = GetJumpDistance(Grid, DirectionIndex);
+    const int32 Reach = FMath::Abs(Distance);
+    const FIntPoint Direction = FGridTopology4::GetDirection(DirectionIndex);
+    const FIntPoint ToGoal = Goal - Grid;
+
+    if (Direction.X != 0)
+    {
+        // 水平：终点在射线上且在墙/跳点之前
+        if (ToGoal.Y == 0 && ToGoal.X * Direction.X > 0 && FMath::Abs(ToGoal.X) <= Reach)
+        {
+            OutJumpPoint = Goal;
+            return true;
+        }
+    }
+    else if (ToGoal.Y * Direction.Y > 0 && FMath::Abs(ToGoal.Y) <= Reach)
+    {
+        // 竖直：经过终点所在行时，能水平走到终点的格子也是跳点
+        const FIntPoint TurnGrid(Grid.X, Goal.Y);
+        if (ToGoal.X == 0)
+        {
+            OutJumpPoint = Goal;
+            return true;
+        }
+        const int32 Horizontal = GetJumpDistance(TurnGrid, ToGoal.X > 0 ? 0 : 2);
+        if (Horizontal > 0 || FMath::Abs(ToGoal.X) <= -Horizontal)
+        {
+            OutJumpPoint = TurnGrid;
+            return true;
+        }
+    }
+
+    if (Distance > 0)
+    {
+        OutJumpPoint = Grid + Direction * Distance;
+        return true;
+    }
+    return false;
+}
\ No newline at end of file
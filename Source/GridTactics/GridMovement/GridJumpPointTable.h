@@ -0,0 +1,106 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FGridBitboard;
+
+/**
+ * 四方向 JPS+ 跳跃距离表（统一代价的地形寻路）
+ * 规范路径约定：竖直移动可以随时转为水平，水平移动只在强迫邻居处转为竖直（类似八方向 JPS 中竖直对应对角线）
+ * 每格每方向存一个有符号距离：> 0 为到下一个跳点的格数，<= 0 为到墙前可走的格数取负
+ * 格子变化时只重算所在行及上下两行的水平表，竖直表只重算跳点标记发生变化的列
+ */
+struct GRIDTACTICS_API FGridJumpPointTable
+{
+    // 方向下标与 FGridTopology4 一致：0 东 (X+)，1 北 (Y+)，2 西 (X-)，3 南 (Y-)
+    static constexpr int32 NumDirections = 4;
+
+    // 按包围盒分配，整表标记为脏
+    void Init(FIntPoint InMin, FIntPoint InSize);
+
+    void MarkDirty(FIntPoint Grid);
+    bool IsDirty() const { return bAnyDirty; }
+
+    // 从可行走位图重算脏行列
+    void Update(const FGridBitboard& Walkable);
+
+    // 包围盒外返回 0；调用前需 Update
+    int32 GetJumpDistance(FIntPoint Grid, int32 DirectionIndex) const;
+
+    // 沿 DirectionIndex 从 Grid 跳跃，找到跳点（或路过的终点 / 转向终点的格子）时返回 true
+    bool Jump(FIntPoint Grid, int32 DirectionIndex, FIntPoint Goal, FIntPoint& OutJumpPoint) const;
+
+    // JPS+ 剪枝后的后继：ParentGrid 等于 Grid 时视为起点，四个方向全部展开
+    template<typename FunctorType>
+    void ForEachSuccessor(FIntPoint Grid, FIntPoint ParentGrid, FIntPoint Goal, FunctorType&& Visitor) const;
+
+    // 水平移动到达 Grid 时，朝竖直方向 DirY 是否有强迫邻居
+    bool HasForcedVerticalNeighbor(FIntPoint Grid, int32 DirX, int32 DirY) const;
+
+private:
+    FIntPoint Min = FIntPoint::ZeroValue;
+    FIntPoint Size = FIntPoint::ZeroValue;
+
+    TArray<int32> Distances[NumDirections];
+
+    // 每格是否有水平跳点（竖直跳跃在这些格子停下）
+    TBitArray<> HorizontalJumpFlags;
+
+    // 可行走位（行优先），Update 时从位图拷贝，Jump 时用于强迫邻居判断
+    TBitArray<> WalkableBits;
+
+    TBitArray<> DirtyRows;
+    TBitArray<> DirtyColumns;
+    bool bAnyDirty = false;
+
+    // 以下均为包围盒内的局部坐标
+    bool IsOpen(int32 X, int32 Y) const
+    {
+        return X >= 0 && Y >= 0 && X < Size.X && Y < Size.Y && WalkableBits[Y * Size.X + X];
+    }
+
+    bool IsForcedVertical(int32 X, int32 Y, int32 DirX, int32 DirY) const
+    {
+        return IsOpen(X, Y + DirY) && !IsOpen(X - DirX, Y + DirY);
+    }
+
+    // 重算一行的东西向距离，跳点标记变化的列记入 DirtyColumns
+    void RebuildRow(int32 Y);
+    void RebuildColumn(int32 X);
+};
+
+template<typename FunctorType>
+void FGridJumpPointTable::ForEachSuccessor(FIntPoint Grid, FIntPoint ParentGrid, FIntPoint Goal, FunctorType&& Visitor) const
+{
+    const FIntPoint Delta = Grid - ParentGrid;
+    bool bExpand[NumDirections] = {};
+    if (Delta == FIntPoint::ZeroValue)
+    {
+        bExpand[0] = bExpand[1] = bExpand[2] = bExpand[3] = true;
+    }
+    else if (Delta.X != 0)
+    {
+        // 水平到达：继续前进，竖直方向只走强迫邻居
+        const int32 DirX = FMath::Sign(Delta.X);
+        bExpand[DirX > 0 ? 0 : 2] = true;
+        bExpand[1] = HasForcedVerticalNeighbor(Grid, DirX, 1);
+        bExpand[3] = HasForcedVerticalNeighbor(Grid, DirX, -1);
+    }
+    else
+    {
+        // 竖直到达：继续前进，水平两侧都是自然邻居
+        bExpand[Delta.Y > 0 ? 1 : 3] = true;
+        bExpand[0] = bExpand[2] = true;
+    }
+
+    for (int32 Dir = 0; Dir < NumDirections; ++Dir)
+    {
+        FIntPoint JumpPoint;
+        if (bExpand[Dir] && Jump(Grid, Dir, Goal, JumpPoint))
+        {
+            Visitor(JumpPoint, FMath::Abs(JumpPoint.X - Grid.X) + FMath::Abs(JumpPoint.Y - Grid.Y));
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 格子连线遍历（整数版 Amanatides-Woo）：从 From 中心到 To 中心的线段依次经过的格子
+ * 只用整数比较两轴的下一次越界时刻，不分配内存；线段恰好穿过格子角点时沿对角线直接进入下一格
+ */
+struct FGridLine
+{
+    /**
+     * 按顺序访问 From 之后（不含 From，含 To）经过的每个格子，Visitor 返回 false 时提前结束
+     * 返回是否走到了 To
+     */
+    template<typename FunctorType>
+    static bool Traverse(FIntPoint From, FIntPoint To, FunctorType&& Visitor)
+    {
+        const int32 DeltaX = FMath::Abs(To.X - From.X);
+        const int32 DeltaY = FMath::Abs(To.Y - From.Y);
+        const int32 StepX = To.X > From.X ? 1 : -1;
+        const int32 StepY = To.Y > From.Y ? 1 : -1;
+
+        FIntPoint Grid = From;
+        int32 IndexX = 0;
+        int32 IndexY = 0;
+        while (IndexX < DeltaX || IndexY < DeltaY)
+        {
+            // 比较 (0.5 + IndexX) / DeltaX 与 (0.5 + IndexY) / DeltaY：哪条轴先越过格子边界
+            const int64 Decision = int64(1 + 2 * IndexX) * DeltaY - int64(1 + 2 * IndexY) * DeltaX;
+            if (Decision == 0)
+            {
+                Grid.X += StepX;
+                Grid.Y += StepY;
+                ++IndexX;
+                ++IndexY;
+            }
+            else if (Decision < 0)
+            {
+                Grid.X += StepX;
+                ++IndexX;
+            }
+            else
+            {
+                Grid.Y += StepY;
+                ++IndexY;
+            }
+
+            if (!Visitor(Grid))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
\ No newline at end of file
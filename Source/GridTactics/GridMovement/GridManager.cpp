@@ -5,12 +5,27 @@
 #include "GridMovementComponent.h"
 #include "GridTactics/AttributesComponent.h"
 #include "GridCell.h"
+#include "GridRenderer.h"
+#include "GridMapAsset.h"
+#include "GridLine.h"
+#include "GridFieldOfView.h"
 #include "DisplacementTypes.h"
 #include "PathPlanner.h"
+#include "GridAStar.h"
 #include "ConflictResolver.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
+#include "GridTactics/HeroCharacter.h"
+#include "GridTactics/EnemyCharacter.h"
 #include "GameFramework/Character.h"
 #include "Engine/OverlapResult.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
 #include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
+#include "Algo/AllOf.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "UObject/UObjectArray.h"
 
 // Sets default values
 AGridManager::AGridManager()
@@ -18,13 +33,57 @@ AGridManager::AGridManager()
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = false;
 
+    GridRendererClass = AGridRenderer::StaticClass();
 }
 
 // Called when the game starts or when spawned
 void AGridManager::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+    if (bMergeCellProxies)
+    {
+        EnsureGridRenderer();
+    }
+
+    // 一次性从 GridCell 构建格子存储，之后的查询不再访问场景
+    RebuildCellStore();
+
+    // 之后流式加载/卸载的关卡按区块增量更新
+    LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &AGridManager::HandleLevelAddedToWorld);
+    LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &AGridManager::HandleLevelRemovedFromWorld);
+}
+
+void AGridManager::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+
+    // 尽早注册，保证其他 Actor 的 BeginPlay 中就能取到 GridManager
+    if (UGridTacticsWorldSubsystem* GridSubsystem = UGridTacticsWorldSubsystem::Get(this))
+    {
+        GridSubsystem->RegisterGridManager(this);
+    }
+}
+
+void AGridManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+    FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+    if (UWorld* World = GetWorld())
+    {
+        World->GetTimerManager().ClearTimer(FlushChangesTimerHandle);
+    }
+
+    if (UGridTacticsWorldSubsystem* GridSubsystem = UGridTacticsWorldSubsystem::Get(this))
+    {
+        GridSubsystem->UnregisterGridManager(this);
+    }
+
+    // 游戏线程的 A* 节点数组按本地图大小分配，地图结束时释放
+    FGridAStar::Get().Trim();
+
+    Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -36,26 +95,118 @@ void AGridManager::Tick(float DeltaTime)
 
 bool AGridManager::ReserveGrid(AActor* Requester, FIntPoint TargetGrid)
 {
-    // 检查是否已经有其他Actor预定了这个格子
-    if (GridReservations.Contains(TargetGrid))
+    std::atomic<uint64>* Slot = FindReservationSlot(TargetGrid);
+    const uint64 Handle = MakeReservationHandle(Requester);
+    if (!Slot || Handle == 0)
     {
         return false;
     }
 
-    // 没有被预定，立即为请求者预定该格子
-    GridReservations.Add(TargetGrid, Requester);
-    return true;
+    // 只有槽位为空时才能抢到，已经有其他Actor预定了这个格子则失败
+    uint64 Expected = 0;
+    return Slot->compare_exchange_strong(Expected, Handle, std::memory_order_acq_rel, std::memory_order_acquire);
 }
 
 void AGridManager::ForceReserveGrid(AActor* Requester, FIntPoint TargetGrid)
 {
     // 强制覆盖预定（如果有之前的预定，直接覆盖）
-    GridReservations.Add(TargetGrid, Requester);
+    if (std::atomic<uint64>* Slot = FindReservationSlot(TargetGrid))
+    {
+        Slot->store(MakeReservationHandle(Requester), std::memory_order_release);
+    }
 }
 
 void AGridManager::ReleaseGrid(FIntPoint GridToRelease)
 {
-    GridReservations.Remove(GridToRelease);
+    if (std::atomic<uint64>* Slot = FindReservationSlot(GridToRelease))
+    {
+        Slot->store(0, std::memory_order_release);
+    }
+}
+
+bool AGridManager::ReleaseGridIfOwner(AActor* Owner, FIntPoint TargetGrid)
+{
+    std::atomic<uint64>* Slot = FindReservationSlot(TargetGrid);
+    uint64 Expected = MakeReservationHandle(Owner);
+    return Slot && Expected != 0 && Slot->compare_exchange_strong(Expected, 0, std::memory_order_acq_rel, std::memory_order_acquire);
+}
+
+AActor* AGridManager::GetGridReservation(FIntPoint TargetGrid) const
+{
+    const std::atomic<uint64>* Slot = FindReservationSlot(TargetGrid);
+    return Slot ? ResolveReservationHandle(Slot->load(std::memory_order_acquire)) : nullptr;
+}
+
+bool AGridManager::ReserveFootprint(AActor* Requester, FIntPoint Anchor, int32 FootprintSize)
+{
+    const FIntPoint Max = Anchor + FIntPoint(FootprintSize - 1, FootprintSize - 1);
+    for (int32 Y = Anchor.Y; Y <= Max.Y; ++Y)
+    {
+        for (int32 X = Anchor.X; X <= Max.X; ++X)
+        {
+            if (!ReserveGrid(Requester, FIntPoint(X, Y)))
+            {
+                // 回滚本次已抢到的格子（按行优先顺序，当前格之前的都是自己的）
+                for (int32 RY = Anchor.Y; RY <= Y; ++RY)
+                {
+                    const int32 EndX = (RY == Y) ? X - 1 : Max.X;
+                    for (int32 RX = Anchor.X; RX <= EndX; ++RX)
+                    {
+                        ReleaseGridIfOwner(Requester, FIntPoint(RX, RY));
+                    }
+                }
+                return false;
+            }
+        }
+    }
+    return FootprintSize > 0;
+}
+
+void AGridManager::ReleaseFootprintIfOwner(AActor* Owner, FIntPoint Anchor, int32 FootprintSize)
+{
+    for (int32 Y = 0; Y < FootprintSize; ++Y)
+    {
+        for (int32 X = 0; X < FootprintSize; ++X)
+        {
+            ReleaseGridIfOwner(Owner, Anchor + FIntPoint(X, Y));
+        }
+    }
+}
+
+uint64 AGridManager::MakeReservationHandle(const AActor* Actor)
+{
+    if (!Actor)
+    {
+        return 0;
+    }
+
+    // AllocateSerialNumber 是线程安全的，已分配时直接返回现有序列号
+    const int32 ObjectIndex = GUObjectArray.ObjectToIndex(Actor);
+    const int32 SerialNumber = GUObjectArray.AllocateSerialNumber(ObjectIndex);
+    return (uint64(uint32(SerialNumber)) << 32) | uint64(uint32(ObjectIndex + 1));
+}
+
+AActor* AGridManager::ResolveReservationHandle(uint64 Handle)
+{
+    if (Handle == 0)
+    {
+        return nullptr;
+    }
+
+    const int32 ObjectIndex = int32(uint32(Handle)) - 1;
+    const int32 SerialNumber = int32(Handle >> 32);
+    const FUObjectItem* Item = GUObjectArray.IndexToObject(ObjectIndex);
+    if (!Item || Item->GetSerialNumber() != SerialNumber || Item->IsUnreachable())
+    {
+        return nullptr;
+    }
+    return static_cast<AActor*>(static_cast<UObject*>(Item->GetObject()));
+}
+
+std::atomic<uint64>* AGridManager::FindReservationSlot(FIntPoint Grid) const
+{
+    FGridCellChunk* Chunk = FindChunk(Grid);
+    return Chunk ? &Chunk->Reservations[FGridCellChunk::GetLocalIndex(Grid)] : nullptr;
 }
 
 // --- 新的位移请求接口 ---
@@ -364,127 +515,2088 @@ void AGridManager::ExecuteAllDisplacements()
 
 bool AGridManager::IsGridWalkable(FIntPoint Grid) const
 {
-    const float GridSizeCM = 100.0f;
-    FVector TargetWorld(Grid.X * GridSizeCM, Grid.Y * GridSizeCM, 0.0f);
+    const FGridCellRecord* Cell = FindCell(Grid);
+    return Cell && Cell->IsWalkable();
+}
 
-    const float DetectionRadius = GridSizeCM * 0.4f;
-    const FVector DetectionOrigin = TargetWorld + FVector(0, 0, 10.0f);
+AActor* AGridManager::GetActorAtGrid(FIntPoint Grid) const
+{
+    if (const FGridOccupantList* Occupants = FindOccupantList(Grid))
+    {
+        for (const TWeakObjectPtr<AActor>& Occupant : *Occupants)
+        {
+            if (AActor* Actor = Occupant.Get())
+            {
+                return Actor;
+            }
+        }
+        return nullptr;
+    }
 
-    FCollisionQueryParams QueryParams;
-    QueryParams.bReturnPhysicalMaterial = false;
+    // 未加载区块的格子很少被查询，直接查反向表
+    for (const TPair<TWeakObjectPtr<AActor>, FIntPoint>& Pair : OccupantGrids)
+    {
+        const FIntPoint Offset = Grid - Pair.Value;
+        const int32 FootprintSize = GetOccupantFootprintSize(Pair.Key);
+        if (Offset.X >= 0 && Offset.Y >= 0 && Offset.X < FootprintSize && Offset.Y < FootprintSize && Pair.Key.IsValid())
+        {
+            return Pair.Key.Get();
+        }
+    }
+    return nullptr;
+}
 
-    FCollisionObjectQueryParams ObjectQueryParams;
-    ObjectQueryParams.AddObjectTypesToQuery(ECC_WorldDynamic); // 匹配 GridCell 的 ObjectType
+void AGridManager::BatchQueryGrids(const TArray<FIntPoint>& Grids, TArray<bool>& OutValid, TArray<bool>& OutWalkable,
+    TArray<AActor*>& OutActors) const
+{
+    OutValid.SetNumUninitialized(Grids.Num());
+    OutWalkable.SetNumUninitialized(Grids.Num());
+    OutActors.SetNumUninitialized(Grids.Num());
 
-    TArray<FOverlapResult> OverlapResults;
-    bool bHasOverlap = GetWorld()->OverlapMultiByObjectType(
-        OverlapResults,
-        DetectionOrigin,
-        FQuat::Identity,
-        ObjectQueryParams,
-        FCollisionShape::MakeSphere(DetectionRadius),
-        QueryParams
-    );
+    for (int32 Index = 0; Index < Grids.Num(); ++Index)
+    {
+        const FGridCellRecord* Cell = FindCell(Grids[Index]);
+        OutValid[Index] = Cell && Cell->IsValid();
+        OutWalkable[Index] = Cell && Cell->IsWalkable();
+        OutActors[Index] = GetFirstOccupant(Grids[Index]);
+    }
+}
 
-    if (!bHasOverlap)
+void AGridManager::FilterWalkableGrids(const TArray<FIntPoint>& Grids, TArray<FIntPoint>& OutGrids, bool bExcludeOccupied) const
+{
+    OutGrids.Reset(Grids.Num());
+    for (const FIntPoint& Grid : Grids)
     {
-        // 没有检测到任何 GridCell，认为不可通行
-        return false;
+        if (WalkableBoard.TestBit(Grid) && !(bExcludeOccupied && GetFirstOccupant(Grid)))
+        {
+            OutGrids.Add(Grid);
+        }
     }
+}
 
-    // 检查是否有可行走的格子
-    for (const FOverlapResult& Result : OverlapResults)
+void AGridManager::BatchIsGridValid(TArrayView<const FIntPoint> Grids, TBitArray<>& OutValid) const
+{
+    OutValid.Init(false, Grids.Num());
+    for (int32 Index = 0; Index < Grids.Num(); ++Index)
     {
-        if (AGridCell* GridCell = Cast<AGridCell>(Result.GetActor()))
+        const FGridCellRecord* Cell = FindCell(Grids[Index]);
+        if (Cell && Cell->IsValid())
         {
-            if (GridCell->IsWalkable())
+            OutValid[Index] = true;
+        }
+    }
+}
+
+void AGridManager::BatchIsGridWalkable(TArrayView<const FIntPoint> Grids, TBitArray<>& OutWalkable) const
+{
+    OutWalkable.Init(false, Grids.Num());
+    for (int32 Index = 0; Index < Grids.Num(); ++Index)
+    {
+        if (WalkableBoard.TestBit(Grids[Index]))
+        {
+            OutWalkable[Index] = true;
+        }
+    }
+}
+
+void AGridManager::BatchGetActorAtGrid(TArrayView<const FIntPoint> Grids, TArray<AActor*>& OutActors) const
+{
+    OutActors.SetNumUninitialized(Grids.Num());
+    for (int32 Index = 0; Index < Grids.Num(); ++Index)
+    {
+        OutActors[Index] = GetFirstOccupant(Grids[Index]);
+    }
+}
+
+AActor* AGridManager::GetFirstOccupant(FIntPoint Grid) const
+{
+    // 占位位图为空时跳过角色列表（未加载区块的位恒为 0，交给 GetActorAtGrid 查反向表）
+    if (!OccupancyBoard.TestBit(Grid) && FindOccupantList(Grid))
+    {
+        return nullptr;
+    }
+    return GetActorAtGrid(Grid);
+}
+
+// 去重并保持原有顺序（结果通常只有几个角色）
+static void RemoveDuplicateActors(TArray<AActor*>& Actors)
+{
+    for (int32 Index = Actors.Num() - 1; Index > 0; --Index)
+    {
+        if (Actors.Find(Actors[Index]) < Index)
+        {
+            Actors.RemoveAt(Index, 1, EAllowShrinking::No);
+        }
+    }
+}
+
+TArray<AActor*> AGridManager::GetActorsAtGrid(FIntPoint Grid) const
+{
+    TArray<AActor*> Actors;
+    GetActorsInRect(Grid, Grid, Actors);
+    return Actors;
+}
+
+void AGridManager::GetActorsInRect(FIntPoint Min, FIntPoint Max, TArray<AActor*>& OutActors) const
+{
+    OutActors.Reset();
+
+    const int64 Area = int64(FMath::Max(0, Max.X - Min.X + 1)) * int64(FMath::Max(0, Max.Y - Min.Y + 1));
+    if (Area == 0)
+    {
+        return;
+    }
+
+    // 区域比角色数量大，或覆盖了未加载的区块时，直接遍历角色
+    if (Area > OccupantGrids.Num() || !AreChunksLoaded(Min, Max))
+    {
+        for (const TPair<TWeakObjectPtr<AActor>, FIntPoint>& Pair : OccupantGrids)
+        {
+            // 占地区域与矩形相交
+            const FIntPoint& Grid = Pair.Value;
+            const int32 Extent = GetOccupantFootprintSize(Pair.Key) - 1;
+            if (Grid.X + Extent >= Min.X && Grid.X <= Max.X && Grid.Y + Extent >= Min.Y && Grid.Y <= Max.Y)
             {
-                return true; // 找到了可行走的格子
+                if (AActor* Actor = Pair.Key.Get())
+                {
+                    OutActors.Add(Actor);
+                }
             }
         }
+        return;
     }
 
-    // 没有找到可行走的格子，说明这里是墙壁或空地
-    return false;
+    FGridCellChunk::ForEachGridInRect(Min, Max, [this, &OutActors](FIntPoint Grid)
+    {
+        for (const TWeakObjectPtr<AActor>& Occupant : *FindOccupantList(Grid))
+        {
+            if (AActor* Actor = Occupant.Get())
+            {
+                OutActors.Add(Actor);
+            }
+        }
+    });
+
+    // 多格角色会出现在多个格子的列表中
+    if (OccupantFootprintSizes.Num() > 0)
+    {
+        RemoveDuplicateActors(OutActors);
+    }
 }
 
-AActor* AGridManager::GetActorAtGrid(FIntPoint Grid) const
+void AGridManager::GetActorsInManhattanRadius(FIntPoint Center, int32 Radius, TArray<AActor*>& OutActors) const
 {
-    // 遍历场景中的所有角色,检查其网格坐标
-    // 这里简化示例,实际应该用更高效的数据结构
-    TArray<AActor*> AllCharacters;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ACharacter::StaticClass(), AllCharacters);
+    OutActors.Reset();
+    if (Radius < 0)
+    {
+        return;
+    }
+
+    // 菱形区域格子数 = 2r(r+1)+1
+    const int64 Area = 2 * int64(Radius) * int64(Radius + 1) + 1;
+    if (Area > OccupantGrids.Num()
+        || !AreChunksLoaded(Center - FIntPoint(Radius, Radius), Center + FIntPoint(Radius, Radius)))
+    {
+        for (const TPair<TWeakObjectPtr<AActor>, FIntPoint>& Pair : OccupantGrids)
+        {
+            // 占地区域内离中心最近的格子
+            const int32 Extent = GetOccupantFootprintSize(Pair.Key) - 1;
+            const FIntPoint Nearest(FMath::Clamp(Center.X, Pair.Value.X, Pair.Value.X + Extent),
+                FMath::Clamp(Center.Y, Pair.Value.Y, Pair.Value.Y + Extent));
+            const FIntPoint Delta = Nearest - Center;
+            if (FMath::Abs(Delta.X) + FMath::Abs(Delta.Y) <= Radius)
+            {
+                if (AActor* Actor = Pair.Key.Get())
+                {
+                    OutActors.Add(Actor);
+                }
+            }
+        }
+        return;
+    }
 
-    for (AActor* Actor : AllCharacters)
+    for (int32 DY = -Radius; DY <= Radius; ++DY)
     {
-        if (GetActorCurrentGrid(Actor) == Grid)
+        const int32 HalfWidth = Radius - FMath::Abs(DY);
+        for (int32 DX = -HalfWidth; DX <= HalfWidth; ++DX)
         {
-            return Actor;
+            for (const TWeakObjectPtr<AActor>& Occupant : *FindOccupantList(Center + FIntPoint(DX, DY)))
+            {
+                if (AActor* Actor = Occupant.Get())
+                {
+                    OutActors.Add(Actor);
+                }
+            }
         }
     }
-    return nullptr;
+
+    if (OccupantFootprintSizes.Num() > 0)
+    {
+        RemoveDuplicateActors(OutActors);
+    }
 }
 
-FIntPoint AGridManager::GetActorCurrentGrid(AActor* Actor) const
+void AGridManager::UpdateActorOccupancy(AActor* Actor, FIntPoint NewGrid, int32 FootprintSize)
 {
-    if (UGridMovementComponent* MovementComp = Actor->FindComponentByClass<UGridMovementComponent>())
+    if (!Actor) return;
+
+    const int32 NewSize = FMath::Clamp(FootprintSize, 1, FGridClearanceMap::MaxClearance);
+    const TWeakObjectPtr<AActor> Key(Actor);
+    if (FIntPoint* OldGrid = OccupantGrids.Find(Key))
     {
-        int32 X, Y;
-        MovementComp->GetCurrentGrid(X, Y);
-        return FIntPoint(X, Y);
+        const int32 OldSize = GetOccupantFootprintSize(Key);
+        if (*OldGrid == NewGrid && OldSize == NewSize)
+        {
+            return;
+        }
+
+        RemoveOccupantFromCells(Key, *OldGrid, OldSize);
+        *OldGrid = NewGrid;
     }
-    return FIntPoint::ZeroValue;
+    else
+    {
+        OccupantGrids.Add(Key, NewGrid);
+    }
+
+    if (NewSize > 1)
+    {
+        OccupantFootprintSizes.Add(Key, NewSize);
+    }
+    else
+    {
+        OccupantFootprintSizes.Remove(Key);
+    }
+
+    AddOccupantToCells(Key, NewGrid, NewSize);
 }
 
-bool AGridManager::IsGridValid(FIntPoint Grid) const
+void AGridManager::RemoveActorOccupancy(AActor* Actor)
 {
-    // 实时检查该坐标是否存在 GridCell
-    const float GridSizeCM = 100.0f;
-    FVector WorldPos = FVector(Grid.X * GridSizeCM, Grid.Y * GridSizeCM, 0.0f);
+    const TWeakObjectPtr<AActor> Key(Actor);
+    FIntPoint OldGrid;
+    if (OccupantGrids.RemoveAndCopyValue(Key, OldGrid))
+    {
+        RemoveOccupantFromCells(Key, OldGrid, GetOccupantFootprintSize(Key));
+        OccupantFootprintSizes.Remove(Key);
+    }
+}
 
-    TArray<AActor*> FoundGridCells;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AGridCell::StaticClass(), FoundGridCells);
+int32 AGridManager::GetOccupantFootprintSize(const TWeakObjectPtr<AActor>& Key) const
+{
+    const int32* Size = OccupantFootprintSizes.Find(Key);
+    return Size ? *Size : 1;
+}
 
-    for (AActor* Actor : FoundGridCells)
+void AGridManager::AddOccupantToCells(const TWeakObjectPtr<AActor>& Key, FIntPoint Anchor, int32 FootprintSize)
+{
+    const FIntPoint Max = Anchor + FIntPoint(FootprintSize - 1, FootprintSize - 1);
+    FGridCellChunk::ForEachGridInRect(Anchor, Max, [this, &Key](FIntPoint Grid)
     {
-        AGridCell* GridCell = Cast<AGridCell>(Actor);
-        if (GridCell && GridCell->GridCoordinate == Grid)
+        if (FGridCellChunk* Chunk = FindChunk(Grid))
         {
-            return true; // 找到了该坐标的 GridCell
+            FGridOccupantList& Occupants = Chunk->Occupants[FGridCellChunk::GetLocalIndex(Grid)];
+            Occupants.Add(Key);
+            RefreshOccupancyBits(Occupants, Grid);
         }
-    }
-    UE_LOG(LogTemp, Warning, TEXT("Can't Found GridCell"));
-    return false; // 该坐标没有 GridCell
+    });
 }
 
-FVector AGridManager::GridToWorld(FIntPoint Grid) const
+void AGridManager::RemoveOccupantFromCells(const TWeakObjectPtr<AActor>& Key, FIntPoint Anchor, int32 FootprintSize)
 {
-    const float GridSizeCM = 100.0f;
-    return FVector(Grid.X * GridSizeCM, Grid.Y * GridSizeCM, 0.0f);
+    const FIntPoint Max = Anchor + FIntPoint(FootprintSize - 1, FootprintSize - 1);
+    FGridCellChunk::ForEachGridInRect(Anchor, Max, [this, &Key](FIntPoint Grid)
+    {
+        if (FGridCellChunk* Chunk = FindChunk(Grid))
+        {
+            FGridOccupantList& Occupants = Chunk->Occupants[FGridCellChunk::GetLocalIndex(Grid)];
+            Occupants.RemoveSingleSwap(Key);
+            RefreshOccupancyBits(Occupants, Grid);
+        }
+    });
 }
 
-FIntPoint AGridManager::WorldToGrid(FVector WorldPos) const
+int32 AGridManager::GetGridClearance(FIntPoint Grid) const
 {
-    const float GridSizeCM = 100.0f;
-    int32 X = FMath::RoundToInt(WorldPos.X / GridSizeCM);
-    int32 Y = FMath::RoundToInt(WorldPos.Y / GridSizeCM);
-    return FIntPoint(X, Y);
+    check(IsInGameThread());
+    ClearanceMap.Update(WalkableBoard);
+    return ClearanceMap.GetClearance(Grid);
 }
 
-void AGridManager::SubmitCustomRequest(const FGridDisplacementRequest& Request)
+bool AGridManager::CanFootprintStandAt(FIntPoint Anchor, int32 FootprintSize) const
 {
-    if (Request.IsValid())
+    if (FootprintSize <= 1)
     {
-        PendingDisplacements.Add(Request);
+        return IsGridWalkable(Anchor);
     }
-    else
+    return GetGridClearance(Anchor) >= FootprintSize;
+}
+
+int32 AGridManager::GetFootprintObstacleDistance(FIntPoint Anchor, FIntPoint Direction, int32 FootprintSize, bool bIncludeOccupants) const
+{
+    if (FootprintSize <= 1)
     {
-        UE_LOG(LogTemp, Error, TEXT("SubmitCustomRequest: Invalid request!"));
+        return GetObstacleDistance(Anchor, Direction, bIncludeOccupants);
+    }
+    if (FGridObstacleDistance::GetDirectionIndex(Direction) == INDEX_NONE)
+    {
+        return 0;
+    }
+
+    // 前沿：朝 X+ / Y+ 时为区域的最大边，朝 X- / Y- 时为最小边；区域每平移一格只新进入前沿外的一排格子
+    const int32 Extent = FootprintSize - 1;
+    const FIntPoint Edge(Direction.X > 0 ? Anchor.X + Extent : Anchor.X, Direction.Y > 0 ? Anchor.Y + Extent : Anchor.Y);
+    const FIntPoint Lateral(Direction.Y != 0 ? 1 : 0, Direction.X != 0 ? 1 : 0);
+
+    int32 Distance = MAX_int32;
+    for (int32 Lane = 0; Lane < FootprintSize && Distance > 0; ++Lane)
+    {
+        Distance = FMath::Min(Distance, GetObstacleDistance(Edge + Lateral * Lane, Direction, bIncludeOccupants));
     }
+    return Distance;
 }
 
-void AGridManager::ProcessDisplacementsAsync()
+AActor* AGridManager::GetActorInFootprint(FIntPoint Anchor, int32 FootprintSize, AActor* IgnoreActor) const
 {
-    // 异步处理的简单实现（可以后续优化为真正的异步）
-    ProcessDisplacements();
+    for (int32 Y = 0; Y < FootprintSize; ++Y)
+    {
+        for (int32 X = 0; X < FootprintSize; ++X)
+        {
+            const FIntPoint Grid = Anchor + FIntPoint(X, Y);
+            if (const FGridOccupantList* Occupants = FindOccupantList(Grid))
+            {
+                // 占位位图先做快速排除
+                if (!OccupancyBoard.TestBit(Grid))
+                {
+                    continue;
+                }
+                for (const TWeakObjectPtr<AActor>& Occupant : *Occupants)
+                {
+                    AActor* Actor = Occupant.Get();
+                    if (Actor && Actor != IgnoreActor)
+                    {
+                        return Actor;
+                    }
+                }
+                continue;
+            }
+
+            // 未加载区块
+            for (AActor* Actor : GetActorsAtGrid(Grid))
+            {
+                if (Actor != IgnoreActor)
+                {
+                    return Actor;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+const FGridJumpPointTable& AGridManager::GetJumpPointTable() const
+{
+    check(IsInGameThread());
+    JumpPointTable.Update(WalkableBoard);
+    return JumpPointTable;
+}
+
+const FGridClusterGraph& AGridManager::GetClusterGraph() const
+{
+    check(IsInGameThread());
+    ClusterGraph.Update(WalkableBoard);
+    return ClusterGraph;
+}
+
+int32 AGridManager::GetActorFootprintSize(AActor* Actor) const
+{
+    return GetOccupantFootprintSize(TWeakObjectPtr<AActor>(Actor));
+}
+
+bool AGridManager::GetActorFootprint(const AActor* Actor, FIntPoint& OutAnchor, int32& OutFootprintSize) const
+{
+    const TWeakObjectPtr<AActor> Key(const_cast<AActor*>(Actor));
+    if (const FIntPoint* Anchor = OccupantGrids.Find(Key))
+    {
+        OutAnchor = *Anchor;
+        OutFootprintSize = GetOccupantFootprintSize(Key);
+        return true;
+    }
+    return false;
+}
+
+void AGridManager::RebuildCellOccupants()
+{
+    for (TPair<FIntPoint, TUniquePtr<FGridCellChunk>>& Pair : Chunks)
+    {
+        for (FGridOccupantList& Occupants : Pair.Value->Occupants)
+        {
+            Occupants.Reset();
+        }
+    }
+
+    OccupancyBoard.Init(CellStoreMin, CellStoreSize);
+    OccupantObstacleDistance.Init(CellStoreMin, CellStoreSize);
+    for (int32 Team = 0; Team < (int32)EGridTeam::MAX; ++Team)
+    {
+        TeamBoards[Team].Init(CellStoreMin, CellStoreSize);
+        TeamAreaTables[Team].Init(CellStoreMin, CellStoreSize);
+    }
+
+    for (auto It = OccupantGrids.CreateIterator(); It; ++It)
+    {
+        if (!It->Key.IsValid())
+        {
+            It.RemoveCurrent();
+            continue;
+        }
+
+        const EGridTeam Team = GetActorTeam(It->Key.Get());
+        const int32 Extent = GetOccupantFootprintSize(It->Key) - 1;
+        FGridCellChunk::ForEachGridInRect(It->Value, It->Value + FIntPoint(Extent, Extent), [&](FIntPoint Grid)
+        {
+            if (FGridCellChunk* Chunk = FindChunk(Grid))
+            {
+                Chunk->Occupants[FGridCellChunk::GetLocalIndex(Grid)].Add(It->Key);
+                OccupancyBoard.SetBit(Grid, true);
+                TeamBoards[(int32)Team].SetBit(Grid, true);
+            }
+        });
+    }
+
+    for (auto It = OccupantFootprintSizes.CreateIterator(); It; ++It)
+    {
+        if (!It->Key.IsValid())
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+void AGridManager::RebuildChunkOccupants(const TSet<FIntPoint>& ChunkCoords)
+{
+    for (const FIntPoint& ChunkCoord : ChunkCoords)
+    {
+        if (const TUniquePtr<FGridCellChunk>* Chunk = Chunks.Find(ChunkCoord))
+        {
+            for (FGridOccupantList& Occupants : (*Chunk)->Occupants)
+            {
+                Occupants.Reset();
+            }
+        }
+    }
+
+    for (const TPair<TWeakObjectPtr<AActor>, FIntPoint>& Pair : OccupantGrids)
+    {
+        if (!Pair.Key.IsValid())
+        {
+            continue;
+        }
+
+        const int32 Extent = GetOccupantFootprintSize(Pair.Key) - 1;
+        FGridCellChunk::ForEachGridInRect(Pair.Value, Pair.Value + FIntPoint(Extent, Extent), [this, &Pair, &ChunkCoords](FIntPoint Grid)
+        {
+            if (ChunkCoords.Contains(FGridCellChunk::GridToChunk(Grid)))
+            {
+                if (FGridCellChunk* Chunk = FindChunk(Grid))
+                {
+                    Chunk->Occupants[FGridCellChunk::GetLocalIndex(Grid)].Add(Pair.Key);
+                }
+            }
+        });
+    }
+
+    // 占位与阵营位只在包围盒内；已释放的区块按空列表清除
+    const FGridOccupantList NoOccupants;
+    const FIntPoint BoundsMax = CellStoreMin + CellStoreSize - FIntPoint(1, 1);
+    for (const FIntPoint& ChunkCoord : ChunkCoords)
+    {
+        const FIntPoint ChunkMin = FGridCellChunk::ChunkToGrid(ChunkCoord);
+        const FIntPoint Min(FMath::Max(ChunkMin.X, CellStoreMin.X), FMath::Max(ChunkMin.Y, CellStoreMin.Y));
+        const FIntPoint Max(FMath::Min(ChunkMin.X + FGridCellChunk::Size - 1, BoundsMax.X),
+            FMath::Min(ChunkMin.Y + FGridCellChunk::Size - 1, BoundsMax.Y));
+        if (Min.X > Max.X || Min.Y > Max.Y)
+        {
+            continue;
+        }
+        FGridCellChunk::ForEachGridInRect(Min, Max, [this, &NoOccupants](FIntPoint Grid)
+        {
+            const FGridOccupantList* Occupants = FindOccupantList(Grid);
+            RefreshOccupancyBits(Occupants ? *Occupants : NoOccupants, Grid);
+        });
+    }
+}
+
+void AGridManager::RefreshOccupancyBits(const FGridOccupantList& Occupants, FIntPoint Grid)
+{
+    bool bOccupied = false;
+    bool bTeamPresent[(int32)EGridTeam::MAX] = {};
+    for (const TWeakObjectPtr<AActor>& Occupant : Occupants)
+    {
+        if (const AActor* Actor = Occupant.Get())
+        {
+            bOccupied = true;
+            bTeamPresent[(int32)GetActorTeam(Actor)] = true;
+        }
+    }
+
+    if (OccupancyBoard.TestBit(Grid) != bOccupied)
+    {
+        OccupancyBoard.SetBit(Grid, bOccupied);
+        OccupantObstacleDistance.MarkDirty(Grid);
+    }
+    for (int32 Team = 0; Team < (int32)EGridTeam::MAX; ++Team)
+    {
+        if (TeamBoards[Team].TestBit(Grid) != bTeamPresent[Team])
+        {
+            TeamBoards[Team].SetBit(Grid, bTeamPresent[Team]);
+            TeamAreaTables[Team].MarkDirty(Grid);
+        }
+    }
+}
+
+int32 AGridManager::CountTeamCellsInRect(EGridTeam Team, FIntPoint Min, FIntPoint Max) const
+{
+    if (Team >= EGridTeam::MAX)
+    {
+        return 0;
+    }
+    check(IsInGameThread());
+    FGridSummedAreaTable& Table = TeamAreaTables[(int32)Team];
+    Table.Update(TeamBoards[(int32)Team]);
+    return Table.Sum(Min, Max);
+}
+
+int32 AGridManager::CountBlockedCellsInRect(FIntPoint Min, FIntPoint Max) const
+{
+    check(IsInGameThread());
+    BlockedAreaTable.Update(WalkableBoard, true);
+    return BlockedAreaTable.Sum(Min, Max);
+}
+
+int32 AGridManager::GetObstacleDistance(FIntPoint Grid, FIntPoint Direction, bool bIncludeOccupants) const
+{
+    const int32 DirectionIndex = FGridObstacleDistance::GetDirectionIndex(Direction);
+    if (DirectionIndex == INDEX_NONE)
+    {
+        return 0;
+    }
+
+    check(IsInGameThread());
+    StaticObstacleDistance.Update(WalkableBoard, false);
+    int32 Distance = StaticObstacleDistance.GetDistance(Grid, DirectionIndex);
+    if (bIncludeOccupants && Distance > 0)
+    {
+        OccupantObstacleDistance.Update(OccupancyBoard, true);
+        Distance = FMath::Min(Distance, OccupantObstacleDistance.GetDistance(Grid, DirectionIndex));
+    }
+    return Distance;
+}
+
+const FGridBitboard& AGridManager::GetTeamBoard(EGridTeam Team) const
+{
+    check(Team < EGridTeam::MAX);
+    return TeamBoards[(int32)Team];
+}
+
+bool AGridManager::IsTeamInPattern(EGridTeam Team, FIntPoint Origin, const FGridPatternMask& Mask) const
+{
+    return Team < EGridTeam::MAX && TeamBoards[(int32)Team].IntersectsPattern(Origin, Mask);
+}
+
+bool AGridManager::IsAnyOccupiedInPattern(FIntPoint Origin, const FGridPatternMask& Mask) const
+{
+    return OccupancyBoard.IntersectsPattern(Origin, Mask);
+}
+
+void AGridManager::GetWalkableGridsInPattern(FIntPoint Origin, const FGridPatternMask& Mask,
+    TArray<FIntPoint>& OutGrids, bool bExcludeOccupied) const
+{
+    WalkableBoard.GetPatternHits(Origin, Mask, OutGrids, bExcludeOccupied ? &OccupancyBoard : nullptr);
+}
+
+EGridTeam AGridManager::GetActorTeam(const AActor* Actor)
+{
+    if (!Actor)
+    {
+        return EGridTeam::None;
+    }
+    if (Actor->IsA<AHeroCharacter>())
+    {
+        return EGridTeam::Player;
+    }
+    if (Actor->IsA<AEnemyCharacter>())
+    {
+        return EGridTeam::Enemy;
+    }
+    return EGridTeam::None;
+}
+
+FIntPoint AGridManager::GetActorCurrentGrid(AActor* Actor) const
+{
+    if (UGridMovementComponent* MovementComp = Actor->FindComponentByClass<UGridMovementComponent>())
+    {
+        int32 X, Y;
+        MovementComp->GetCurrentGrid(X, Y);
+        return FIntPoint(X, Y);
+    }
+    return FIntPoint::ZeroValue;
+}
+
+bool AGridManager::IsGridValid(FIntPoint Grid) const
+{
+    const FGridCellRecord* Cell = FindCell(Grid);
+    if (Cell && Cell->IsValid())
+    {
+        return true;
+    }
+    UE_LOG(LogTemp, Verbose, TEXT("Can't Found GridCell at %s"), *Grid.ToString());
+    return false; // 该坐标没有 GridCell
+}
+
+FVector AGridManager::GridToWorld(FIntPoint Grid) const
+{
+    const float GridSizeCM = 100.0f;
+    return FVector(Grid.X * GridSizeCM, Grid.Y * GridSizeCM, 0.0f);
+}
+
+FIntPoint AGridManager::WorldToGrid(FVector WorldPos) const
+{
+    const float GridSizeCM = 100.0f;
+    int32 X = FMath::RoundToInt(WorldPos.X / GridSizeCM);
+    int32 Y = FMath::RoundToInt(WorldPos.Y / GridSizeCM);
+    return FIntPoint(X, Y);
+}
+
+void AGridManager::SubmitCustomRequest(const FGridDisplacementRequest& Request)
+{
+    if (Request.IsValid())
+    {
+        PendingDisplacements.Add(Request);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("SubmitCustomRequest: Invalid request!"));
+    }
+}
+
+void AGridManager::ProcessDisplacementsAsync()
+{
+    // 异步处理的简单实现（可以后续优化为真正的异步）
+    ProcessDisplacements();
+}
+
+// --- 格子存储 ---
+
+void AGridManager::RebuildCellStore()
+{
+    Chunks.Reset();
+    LevelCellGrids.Reset();
+    NumWeightedMoveCostCells = 0;
+
+    int32 NumGridCells = 0;
+
+    // 本关卡有烘焙数据时一次读入，本关卡中的 GridCell（仅未烘焙的编辑器/PIE 中存在）不再读取
+    ULevel* BakedLevel = nullptr;
+    if (GridMapAsset)
+    {
+        const int32 NumBakedCells = LoadCellsFromMapAsset();
+        if (NumBakedCells != INDEX_NONE)
+        {
+            NumGridCells += NumBakedCells;
+            BakedLevel = GetLevel();
+
+            // 烘焙关卡的 GridCell 在打包时被剔除，外观只能来自资产；编辑器/PIE 中仍可退回代理采集
+            if (GridRenderer)
+            {
+                GridRenderer->CaptureAppearanceFromMapAsset(GridMapAsset);
+            }
+            if (!GridMapAsset->CellMesh)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("GridManager: GridMapAsset %s has no cell mesh, re-run GridMapBake (cooked builds will not draw cells)"),
+                    *GridMapAsset->GetName());
+            }
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("GridManager: GridMapAsset %s is invalid, falling back to GridCells"), *GridMapAsset->GetName());
+        }
+    }
+
+    if (UWorld* World = GetWorld())
+    {
+        for (ULevel* Level : World->GetLevels())
+        {
+            if (Level == BakedLevel)
+            {
+                TArray<AGridCell*> Proxies;
+                GatherCellProxies(Level, Proxies);
+                MergeCellProxies(Proxies);
+                continue;
+            }
+            NumGridCells += AddGridCellsFromLevel(Level);
+        }
+    }
+
+    if (NumGridCells == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("GridManager: No GridCell found, cell store is empty"));
+    }
+
+    // 角色可能先于本函数完成注册
+    OnCellLayoutChanged();
+
+    UE_LOG(LogTemp, Log, TEXT("GridManager: Cell store built from %d cells (%s), %d chunks, bounds %s size %s"),
+        NumGridCells, BakedLevel ? TEXT("baked") : TEXT("GridCells"), Chunks.Num(), *CellStoreMin.ToString(), *CellStoreSize.ToString());
+}
+
+EGridCellType AGridManager::GetGridCellType(FIntPoint Grid) const
+{
+    const FGridCellRecord* Cell = FindCell(Grid);
+    return (Cell && Cell->IsValid()) ? Cell->Type : EGridCellType::Blocked;
+}
+
+bool AGridManager::AddCellRecord(FIntPoint Grid, EGridCellType Type, bool bWalkable, const FGridCellAttributes& Attributes)
+{
+    TUniquePtr<FGridCellChunk>& Chunk = Chunks.FindOrAdd(FGridCellChunk::GridToChunk(Grid));
+    if (!Chunk)
+    {
+        Chunk = MakeUnique<FGridCellChunk>();
+    }
+
+    const int32 LocalIndex = FGridCellChunk::GetLocalIndex(Grid);
+    FGridCellRecord& Record = Chunk->Cells[LocalIndex];
+    const bool bWasValid = Record.IsValid();
+
+    // 同一坐标叠放多个 GridCell 时，只要有一个可行走就视为可行走（与旧的重叠检测一致），属性层取自同一个 GridCell
+    if (!bWasValid || bWalkable)
+    {
+        NumWeightedMoveCostCells -= (bWasValid && Chunk->MoveCost[LocalIndex] > 1) ? 1 : 0;
+        NumWeightedMoveCostCells += Attributes.MoveCost > 1 ? 1 : 0;
+        Record.Type = Type;
+        Chunk->SetAttributes(LocalIndex, Attributes);
+    }
+    Record.Flags |= EGridCellFlags::Valid;
+    if (bWalkable)
+    {
+        Record.Flags |= EGridCellFlags::Walkable;
+    }
+
+    if (!bWasValid)
+    {
+        ++Chunk->NumValidCells;
+    }
+    return !bWasValid;
+}
+
+bool AGridManager::RemoveCellRecord(FIntPoint Grid)
+{
+    const FIntPoint ChunkCoord = FGridCellChunk::GridToChunk(Grid);
+    TUniquePtr<FGridCellChunk>* Chunk = Chunks.Find(ChunkCoord);
+    if (!Chunk)
+    {
+        return false;
+    }
+
+    const int32 LocalIndex = FGridCellChunk::GetLocalIndex(Grid);
+    FGridCellRecord& Record = (*Chunk)->Cells[LocalIndex];
+    if (!Record.IsValid())
+    {
+        return false;
+    }
+
+    NumWeightedMoveCostCells -= (*Chunk)->MoveCost[LocalIndex] > 1 ? 1 : 0;
+    Record = FGridCellRecord();
+    (*Chunk)->SetAttributes(LocalIndex, FGridCellAttributes());
+    (*Chunk)->MoveCost[LocalIndex] = 0;
+    if (--(*Chunk)->NumValidCells == 0)
+    {
+        // 区块内的角色仍保留在 OccupantGrids 中，区块重新加载后会重新分配
+        Chunks.Remove(ChunkCoord);
+    }
+    return true;
+}
+
+int32 AGridManager::LoadCellsFromMapAsset()
+{
+    TArray<FGridCellRecord> Cells;
+    TArray<FGridCellAttributes> Attributes;
+    if (!GridMapAsset->ReadCells(Cells, &Attributes))
+    {
+        return INDEX_NONE;
+    }
+
+    const FIntPoint BoundsMin = GridMapAsset->BoundsMin;
+    const FIntPoint BoundsSize = GridMapAsset->BoundsSize;
+    TArray<FIntPoint>& Grids = LevelCellGrids.FindOrAdd(GetLevel());
+    Grids.Reserve(GridMapAsset->NumValidCells);
+
+    for (int32 Y = 0; Y < BoundsSize.Y; ++Y)
+    {
+        for (int32 X = 0; X < BoundsSize.X; ++X)
+        {
+            const int32 Index = Y * BoundsSize.X + X;
+            const FGridCellRecord& Cell = Cells[Index];
+            if (Cell.IsValid())
+            {
+                const FIntPoint Grid = BoundsMin + FIntPoint(X, Y);
+                AddCellRecord(Grid, Cell.Type, Cell.IsWalkable(), Attributes[Index]);
+                Grids.Add(Grid);
+            }
+        }
+    }
+    return Grids.Num();
+}
+
+void AGridManager::GatherCellProxies(ULevel* Level, TArray<AGridCell*>& OutProxies)
+{
+    OutProxies.Reset();
+    if (!Level)
+    {
+        return;
+    }
+
+    for (AActor* Actor : Level->Actors)
+    {
+        if (AGridCell* GridCell = Cast<AGridCell>(Actor))
+        {
+            OutProxies.Add(GridCell);
+        }
+    }
+}
+
+void AGridManager::MergeCellProxies(const TArray<AGridCell*>& Proxies)
+{
+    if (!bMergeCellProxies || Proxies.Num() == 0)
+    {
+        return;
+    }
+
+    // 代理已并入存储与 GridRenderer，销毁以减少 Actor 与组件数量
+    if (GridRenderer)
+    {
+        GridRenderer->CaptureAppearanceFromProxy(Proxies[0]);
+    }
+    for (AGridCell* GridCell : Proxies)
+    {
+        GridCell->Destroy();
+    }
+}
+
+int32 AGridManager::AddGridCellsFromLevel(ULevel* Level)
+{
+    TArray<AGridCell*> Proxies;
+    GatherCellProxies(Level, Proxies);
+    if (Proxies.Num() == 0)
+    {
+        return 0;
+    }
+
+    // GridCell::BeginPlay 可能晚于本函数执行，因此直接由位置计算坐标
+    TArray<FIntPoint>& Grids = LevelCellGrids.FindOrAdd(Level);
+    for (const AGridCell* GridCell : Proxies)
+    {
+        const FIntPoint Grid = WorldToGrid(GridCell->GetActorLocation());
+        AddCellRecord(Grid, GridCell->CellType, GridCell->IsWalkable(), GridCell->GetCellAttributes());
+        Grids.Add(Grid);
+    }
+
+    MergeCellProxies(Proxies);
+    return Proxies.Num();
+}
+
+int32 AGridManager::RemoveGridCellsFromLevel(ULevel* Level, TArray<FIntPoint>& OutGrids)
+{
+    OutGrids.Reset();
+    if (!Level || !LevelCellGrids.RemoveAndCopyValue(Level, OutGrids))
+    {
+        return 0;
+    }
+
+    // 注意：若其他关卡在同一坐标也放了 GridCell，该坐标会一并清除
+    for (const FIntPoint& Grid : OutGrids)
+    {
+        RemoveCellRecord(Grid);
+    }
+    return OutGrids.Num();
+}
+
+void AGridManager::RebuildChunkDirectory()
+{
+    FIntPoint ChunkMin(MAX_int32, MAX_int32);
+    FIntPoint ChunkMax(MIN_int32, MIN_int32);
+    for (const TPair<FIntPoint, TUniquePtr<FGridCellChunk>>& Pair : Chunks)
+    {
+        ChunkMin = FIntPoint(FMath::Min(ChunkMin.X, Pair.Key.X), FMath::Min(ChunkMin.Y, Pair.Key.Y));
+        ChunkMax = FIntPoint(FMath::Max(ChunkMax.X, Pair.Key.X), FMath::Max(ChunkMax.Y, Pair.Key.Y));
+    }
+
+    ChunkDirectory.Reset();
+    if (Chunks.Num() > 0)
+    {
+        ChunkDirectoryMin = ChunkMin;
+        ChunkDirectorySize = ChunkMax - ChunkMin + FIntPoint(1, 1);
+    }
+    else
+    {
+        ChunkDirectoryMin = ChunkDirectorySize = FIntPoint::ZeroValue;
+    }
+
+    ChunkDirectory.SetNumZeroed(ChunkDirectorySize.X * ChunkDirectorySize.Y);
+    for (const TPair<FIntPoint, TUniquePtr<FGridCellChunk>>& Pair : Chunks)
+    {
+        const FIntPoint Local = Pair.Key - ChunkDirectoryMin;
+        ChunkDirectory[Local.Y * ChunkDirectorySize.X + Local.X] = Pair.Value.Get();
+    }
+}
+
+void AGridManager::OnCellLayoutChanged()
+{
+    // 包围盒与区块目录
+    RebuildChunkDirectory();
+
+    FIntPoint Min(MAX_int32, MAX_int32);
+    FIntPoint Max(MIN_int32, MIN_int32);
+    ForEachLoadedCell([&Min, &Max](FIntPoint Grid, const FGridCellRecord& Cell)
+    {
+        Min = FIntPoint(FMath::Min(Min.X, Grid.X), FMath::Min(Min.Y, Grid.Y));
+        Max = FIntPoint(FMath::Max(Max.X, Grid.X), FMath::Max(Max.Y, Grid.Y));
+    });
+
+    if (Chunks.Num() > 0)
+    {
+        CellStoreMin = Min;
+        CellStoreSize = Max - Min + FIntPoint(1, 1);
+    }
+    else
+    {
+        CellStoreMin = CellStoreSize = FIntPoint::ZeroValue;
+    }
+
+    // 可行走位图
+    WalkableBoard.Init(CellStoreMin, CellStoreSize);
+    ForEachLoadedCell([this](FIntPoint Grid, const FGridCellRecord& Cell)
+    {
+        if (Cell.IsWalkable())
+        {
+            WalkableBoard.SetBit(Grid, true);
+        }
+    });
+
+    BlockedAreaTable.Init(CellStoreMin, CellStoreSize);
+    StaticObstacleDistance.Init(CellStoreMin, CellStoreSize);
+    ClearanceMap.Init(CellStoreMin, CellStoreSize);
+    JumpPointTable.Init(CellStoreMin, CellStoreSize);
+    JumpPointTable.Update(WalkableBoard);
+    ClusterGraph.Init(CellStoreMin, CellStoreSize);
+
+    RebuildRegionLabels();
+    RebuildCellOccupants();
+    FieldOfViewCache.Reset();
+    FlowFieldCache.Reset();
+
+    if (GridRenderer)
+    {
+        GridRenderer->RebuildInstances(this);
+    }
+
+    // 布局变化通知订阅者整体重建
+    ++GridVersion;
+    bPendingFullRebuild = true;
+    ChangeHistory.Reset();
+    ChangeHistoryStartVersion = GridVersion;
+    ScheduleChangeFlush();
+}
+
+void AGridManager::OnCellsStreamed(TConstArrayView<FIntPoint> Grids)
+{
+    const FIntPoint BoundsMax = CellStoreMin + CellStoreSize;
+    const bool bInsideBounds = CellStoreSize.X > 0 && CellStoreSize.Y > 0
+        && Algo::AllOf(Grids, [this, BoundsMax](const FIntPoint& Grid)
+        {
+            return Grid.X >= CellStoreMin.X && Grid.Y >= CellStoreMin.Y && Grid.X < BoundsMax.X && Grid.Y < BoundsMax.Y;
+        });
+    if (!bInsideBounds)
+    {
+        OnCellLayoutChanged();
+        return;
+    }
+
+    // 包围盒不变：派生表保持尺寸，只有可行走性变化的格子标脏，查询时按各自的脏区增量重算
+    RebuildChunkDirectory();
+    TSet<FIntPoint> StreamedChunks;
+    TArray<FIntPoint> WalkableGrids;
+    TArray<FIntPoint> UnwalkableGrids;
+    for (const FIntPoint& Grid : Grids)
+    {
+        StreamedChunks.Add(FGridCellChunk::GridToChunk(Grid));
+        const bool bWalkable = IsGridWalkable(Grid);
+        if (WalkableBoard.TestBit(Grid) != bWalkable)
+        {
+            (bWalkable ? WalkableGrids : UnwalkableGrids).Add(Grid);
+            WalkableBoard.SetBit(Grid, bWalkable);
+            BlockedAreaTable.MarkDirty(Grid);
+            StaticObstacleDistance.MarkDirty(Grid);
+            ClearanceMap.MarkDirty(Grid);
+            JumpPointTable.MarkDirty(Grid);
+            ClusterGraph.MarkDirty(Grid);
+        }
+
+        // 按格子记入变化日志；卸载后区块可能已释放，此时只推进全局版本号
+        if (FGridCellChunk* Chunk = FindChunk(Grid))
+        {
+            RecordCellChange(Grid, Chunk->Versions[FGridCellChunk::GetLocalIndex(Grid)]);
+        }
+        else
+        {
+            ++GridVersion;
+            PendingChangedCells.Add(Grid);
+            AddChangeHistory(Grid);
+        }
+    }
+
+    // 区域编号只处理可行走性变化的格子；角色列表与视野只处理增删的区块
+    // 流场铺满整个包围盒，上面推进的 GridVersion 已使其在下次查询时重建，保留缓存以复用数组
+    UpdateStreamedRegionLabels(WalkableGrids, UnwalkableGrids);
+    RebuildChunkOccupants(StreamedChunks);
+    for (const FIntPoint& ChunkCoord : StreamedChunks)
+    {
+        const FIntPoint ChunkMin = FGridCellChunk::ChunkToGrid(ChunkCoord);
+        InvalidateFieldOfView(ChunkMin, ChunkMin + FIntPoint(FGridCellChunk::Size - 1, FGridCellChunk::Size - 1));
+    }
+
+    if (GridRenderer)
+    {
+        GridRenderer->RebuildInstances(this);
+    }
+    ScheduleChangeFlush();
+}
+
+bool AGridManager::SetGridCellType(FIntPoint Grid, EGridCellType NewType)
+{
+    FGridCellChunk* Chunk = FindChunk(Grid);
+    if (!Chunk)
+    {
+        return false;
+    }
+
+    const int32 LocalIndex = FGridCellChunk::GetLocalIndex(Grid);
+    FGridCellRecord& Record = Chunk->Cells[LocalIndex];
+    if (!Record.IsValid() || Record.Type == NewType)
+    {
+        return false;
+    }
+
+    // 与 AGridCell::IsWalkable 规则一致
+    const bool bWalkable = NewType == EGridCellType::Walkable;
+    Record.Type = NewType;
+    Record.Flags = bWalkable ? (Record.Flags | EGridCellFlags::Walkable) : (Record.Flags & ~EGridCellFlags::Walkable);
+    if (WalkableBoard.TestBit(Grid) != bWalkable)
+    {
+        WalkableBoard.SetBit(Grid, bWalkable);
+        BlockedAreaTable.MarkDirty(Grid);
+        StaticObstacleDistance.MarkDirty(Grid);
+        ClearanceMap.MarkDirty(Grid);
+        JumpPointTable.MarkDirty(Grid);
+        ClusterGraph.MarkDirty(Grid);
+        UpdateRegionLabels(Grid, bWalkable);
+    }
+    InvalidateFieldOfView(Grid, Grid);
+
+    RecordCellChange(Grid, Chunk->Versions[LocalIndex]);
+    return true;
+}
+
+int32 AGridManager::GetGridCellVersion(FIntPoint Grid) const
+{
+    const FGridCellChunk* Chunk = FindChunk(Grid);
+    return Chunk ? Chunk->Versions[FGridCellChunk::GetLocalIndex(Grid)] : 0;
+}
+
+int32 AGridManager::GetGridLayerValue(FIntPoint Grid, EGridCellLayer Layer) const
+{
+    const FGridCellChunk* Chunk = FindChunk(Grid);
+    return Chunk ? Chunk->GetLayerValue(FGridCellChunk::GetLocalIndex(Grid), Layer) : 0;
+}
+
+bool AGridManager::SetGridLayerValue(FIntPoint Grid, EGridCellLayer Layer, int32 Value)
+{
+    FGridCellChunk* Chunk = FindChunk(Grid);
+    if (!Chunk)
+    {
+        return false;
+    }
+
+    const int32 LocalIndex = FGridCellChunk::GetLocalIndex(Grid);
+    const bool bWasWeighted = Chunk->MoveCost[LocalIndex] > 1;
+    if (!Chunk->Cells[LocalIndex].IsValid() || !Chunk->SetLayerValue(LocalIndex, Layer, Value))
+    {
+        return false;
+    }
+    NumWeightedMoveCostCells += (Chunk->MoveCost[LocalIndex] > 1 ? 1 : 0) - (bWasWeighted ? 1 : 0);
+
+    RecordCellChange(Grid, Chunk->Versions[LocalIndex]);
+    return true;
+}
+
+void AGridManager::ReadLayerRect(EGridCellLayer Layer, FIntPoint Min, FIntPoint Max, TArray<int32>& OutValues) const
+{
+    OutValues.Reset();
+    if (Max.X < Min.X || Max.Y < Min.Y)
+    {
+        return;
+    }
+
+    const int32 Width = Max.X - Min.X + 1;
+    OutValues.SetNumZeroed(Width * (Max.Y - Min.Y + 1));
+
+    if constexpr (FGridCellChunk::bMortonLayout)
+    {
+        // Z 序布局：按存储顺序读取，写入行优先的输出
+        FGridCellChunk::ForEachGridInRect(Min, Max, [this, Layer, Min, Width, &OutValues](FIntPoint Grid)
+        {
+            if (const FGridCellChunk* Chunk = FindChunk(Grid))
+            {
+                OutValues[(Grid.Y - Min.Y) * Width + (Grid.X - Min.X)] = Chunk->GetLayerValue(FGridCellChunk::GetLocalIndex(Grid), Layer);
+            }
+        });
+    }
+    else
+    {
+        // 按区块切分每一行，区块内同一行的格子在各层数组中是连续的
+        for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+        {
+            int32* OutRow = OutValues.GetData() + (Y - Min.Y) * Width;
+            for (int32 SpanStart = Min.X; SpanStart <= Max.X; )
+            {
+                const int32 SpanEnd = FMath::Min(Max.X, (SpanStart | FGridCellChunk::LocalMask));
+                const FIntPoint Grid(SpanStart, Y);
+                if (const FGridCellChunk* Chunk = FindChunk(Grid))
+                {
+                    const int32 LocalIndex = FGridCellChunk::GetLocalIndex(Grid);
+                    for (int32 Offset = 0; Offset <= SpanEnd - SpanStart; ++Offset)
+                    {
+                        OutRow[SpanStart - Min.X + Offset] = Chunk->GetLayerValue(LocalIndex + Offset, Layer);
+                    }
+                }
+                SpanStart = SpanEnd + 1;
+            }
+        }
+    }
+}
+
+FGridCellAttributes AGridManager::GetGridCellAttributes(FIntPoint Grid) const
+{
+    const FGridCellChunk* Chunk = FindChunk(Grid);
+    const int32 LocalIndex = FGridCellChunk::GetLocalIndex(Grid);
+    return (Chunk && Chunk->Cells[LocalIndex].IsValid()) ? Chunk->GetAttributes(LocalIndex) : FGridCellAttributes();
+}
+
+FVector AGridManager::GetGridSurfaceLocation(FIntPoint Grid) const
+{
+    FVector Location = GridToWorld(Grid);
+    Location.Z += GetGridLayerValue(Grid, EGridCellLayer::Height);
+    return Location;
+}
+
+bool AGridManager::IsSightBlocked(FIntPoint Grid, EGridSightBlocker Blockers) const
+{
+    if (EnumHasAnyFlags(Blockers, EGridSightBlocker::Unwalkable) && !WalkableBoard.TestBit(Grid))
+    {
+        return true;
+    }
+    if (EnumHasAnyFlags(Blockers, EGridSightBlocker::Actors) && OccupancyBoard.TestBit(Grid))
+    {
+        return true;
+    }
+    if (EnumHasAnyFlags(Blockers, EGridSightBlocker::Walls))
+    {
+        const FGridCellRecord* Cell = FindCell(Grid);
+        return Cell && Cell->IsValid() && Cell->Type == EGridCellType::Blocked;
+    }
+    return false;
+}
+
+bool AGridManager::HasLineOfSight(FIntPoint From, FIntPoint To, int32 BlockerMask) const
+{
+    const EGridSightBlocker Blockers = (EGridSightBlocker)BlockerMask;
+    return FGridLine::Traverse(From, To, [this, To, Blockers](FIntPoint Grid)
+    {
+        return Grid == To || !IsSightBlocked(Grid, Blockers);
+    });
+}
+
+FIntPoint AGridManager::TraceGridLine(FIntPoint From, FIntPoint To, EGridSightBlocker Blockers, bool& bOutBlocked) const
+{
+    FIntPoint LastClear = From;
+    bOutBlocked = !FGridLine::Traverse(From, To, [this, Blockers, &LastClear](FIntPoint Grid)
+    {
+        if (IsSightBlocked(Grid, Blockers))
+        {
+            return false;
+        }
+        LastClear = Grid;
+        return true;
+    });
+    return LastClear;
+}
+
+const FGridBitboard& AGridManager::GetFieldOfView(FIntPoint Origin, int32 Radius)
+{
+    Radius = FMath::Max(Radius, 0);
+    const FIntVector Key(Origin.X, Origin.Y, Radius);
+    if (FCachedFieldOfView* Cached = FieldOfViewCache.Find(Key))
+    {
+        Cached->LastUseStamp = ++FieldOfViewUseCount;
+        return Cached->Visible;
+    }
+
+    // 按最近最少使用批量淘汰到上限的四分之三，排序的开销分摊到之后的多次新增上
+    const int32 MaxEntries = FMath::Max(MaxCachedFieldsOfView, 1);
+    if (FieldOfViewCache.Num() >= MaxEntries)
+    {
+        TArray<uint64> Stamps;
+        Stamps.Reserve(FieldOfViewCache.Num());
+        for (const TPair<FIntVector, FCachedFieldOfView>& Pair : FieldOfViewCache)
+        {
+            Stamps.Add(Pair.Value.LastUseStamp);
+        }
+        Algo::Sort(Stamps);
+
+        // 使用序号互不相同，淘汰序号不大于阈值的条目即恰好淘汰 NumRemoved 个
+        const int32 NumRemoved = FieldOfViewCache.Num() - MaxEntries * 3 / 4;
+        const uint64 Threshold = Stamps[FMath::Clamp(NumRemoved, 1, Stamps.Num()) - 1];
+        for (auto It = FieldOfViewCache.CreateIterator(); It; ++It)
+        {
+            if (It->Value.LastUseStamp <= Threshold)
+            {
+                It.RemoveCurrent();
+            }
+        }
+    }
+
+    FCachedFieldOfView& Entry = FieldOfViewCache.Add(Key);
+    Entry.LastUseStamp = ++FieldOfViewUseCount;
+    FGridFieldOfView::Compute(Origin, Radius, [this](FIntPoint Grid)
+    {
+        return IsSightBlocked(Grid, EGridSightBlocker::Walls);
+    }, Entry.Visible);
+    return Entry.Visible;
+}
+
+bool AGridManager::IsGridInFieldOfView(FIntPoint Origin, int32 Radius, FIntPoint Target)
+{
+    // 先排除视野方框外的目标，避免为远处目标计算视野
+    if (FMath::Abs(Target.X - Origin.X) > Radius || FMath::Abs(Target.Y - Origin.Y) > Radius)
+    {
+        return false;
+    }
+    return GetFieldOfView(Origin, Radius).TestBit(Target);
+}
+
+void AGridManager::GetVisibleGrids(FIntPoint Origin, int32 Radius, TArray<FIntPoint>& OutGrids)
+{
+    OutGrids.Reset();
+    const FGridBitboard& Visible = GetFieldOfView(Origin, Radius);
+    const FIntPoint Min = Visible.GetMin();
+    const FIntPoint Size = Visible.GetSize();
+    for (int32 Y = 0; Y < Size.Y; ++Y)
+    {
+        for (int32 X = 0; X < Size.X; X += 64)
+        {
+            for (uint64 Bits = Visible.ExtractBits(X, Y); Bits != 0; Bits &= Bits - 1)
+            {
+                OutGrids.Add(Min + FIntPoint(X + (int32)FMath::CountTrailingZeros64(Bits), Y));
+            }
+        }
+    }
+}
+
+const FGridFlowField& AGridManager::GetFlowField(FIntPoint Goal)
+{
+    FCachedFlowField* Cached = FlowFieldCache.Find(Goal);
+    if (Cached && Cached->GridVersion == GridVersion)
+    {
+        Cached->LastUseStamp = ++FlowFieldUseCount;
+        return Cached->Field;
+    }
+
+    // 终点换了（英雄移动）时按最近最少使用淘汰到低于上限，同一帧内请求再多的终点也不会超出；被淘汰的场的数组留给新终点复用
+    if (!Cached)
+    {
+        FGridFlowField Recycled;
+        while (FlowFieldCache.Num() >= FMath::Max(MaxCachedFlowFields, 1))
+        {
+            FIntPoint OldestGoal = FIntPoint::ZeroValue;
+            uint64 OldestStamp = MAX_uint64;
+            for (const TPair<FIntPoint, FCachedFlowField>& Pair : FlowFieldCache)
+            {
+                if (Pair.Value.LastUseStamp < OldestStamp)
+                {
+                    OldestGoal = Pair.Key;
+                    OldestStamp = Pair.Value.LastUseStamp;
+                }
+            }
+            Recycled = MoveTemp(FlowFieldCache.FindChecked(OldestGoal).Field);
+            FlowFieldCache.Remove(OldestGoal);
+        }
+        Cached = &FlowFieldCache.Add(Goal);
+        Cached->Field = MoveTemp(Recycled);
+    }
+
+    Cached->GridVersion = GridVersion;
+    Cached->LastUseStamp = ++FlowFieldUseCount;
+    Cached->Field.Build(CellStoreMin, CellStoreSize, Goal, [this](FIntPoint Grid)
+    {
+        return WalkableBoard.TestBit(Grid) ? FMath::Max(GetGridLayerValue(Grid, EGridCellLayer::MoveCost), 1) : 0;
+    });
+    return Cached->Field;
+}
+
+bool AGridManager::GetFlowFieldStep(FIntPoint Grid, FIntPoint Goal, FIntPoint& OutNextGrid)
+{
+    return GetFlowField(Goal).GetNextStep(Grid, OutNextGrid);
+}
+
+int32 AGridManager::GetFlowFieldDistance(FIntPoint Grid, FIntPoint Goal)
+{
+    return GetFlowField(Goal).GetIntegration(Grid);
+}
+
+void AGridManager::InvalidateFieldOfView(FIntPoint Min, FIntPoint Max)
+{
+    for (auto It = FieldOfViewCache.CreateIterator(); It; ++It)
+    {
+        const FIntVector& Key = It->Key;
+        if (Min.X <= Key.X + Key.Z && Max.X >= Key.X - Key.Z && Min.Y <= Key.Y + Key.Z && Max.Y >= Key.Y - Key.Z)
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+bool AGridManager::AreConnected(FIntPoint A, FIntPoint B) const
+{
+    const int32 RegionA = GetRegionLabel(A);
+    return RegionA != 0 && RegionA == GetRegionLabel(B);
+}
+
+int32 AGridManager::GetRegionLabel(FIntPoint Grid) const
+{
+    const FGridCellChunk* Chunk = FindChunk(Grid);
+    return Chunk ? RegionRoots[Chunk->RegionLabels[FGridCellChunk::GetLocalIndex(Grid)]] : 0;
+}
+
+void AGridManager::RebuildRegionLabels()
+{
+    // 第一遍：每个可行走格子一个临时编号
+    TArray<int32> Parents;
+    TArray<int32> Sizes;
+    Parents.Add(0);
+    Sizes.Add(0);
+    for (const TPair<FIntPoint, TUniquePtr<FGridCellChunk>>& Pair : Chunks)
+    {
+        FGridCellChunk& Chunk = *Pair.Value;
+        for (int32 LocalIndex = 0; LocalIndex < FGridCellChunk::NumCells; ++LocalIndex)
+        {
+            int32 Label = 0;
+            if (Chunk.Cells[LocalIndex].IsWalkable())
+            {
+                Label = Parents.Num();
+                Parents.Add(Label);
+                Sizes.Add(1);
+            }
+            Chunk.RegionLabels[LocalIndex] = Label;
+        }
+    }
+
+    auto Find = [&Parents](int32 Label)
+    {
+        while (Parents[Label] != Label)
+        {
+            Parents[Label] = Parents[Parents[Label]];
+            Label = Parents[Label];
+        }
+        return Label;
+    };
+
+    // 第二遍：与左侧、下方可行走格子合并（按大小合并 + 路径减半）
+    for (const TPair<FIntPoint, TUniquePtr<FGridCellChunk>>& Pair : Chunks)
+    {
+        const FGridCellChunk& Chunk = *Pair.Value;
+        const FIntPoint ChunkOrigin = FGridCellChunk::ChunkToGrid(Pair.Key);
+        for (int32 LocalIndex = 0; LocalIndex < FGridCellChunk::NumCells; ++LocalIndex)
+        {
+            const int32 Label = Chunk.RegionLabels[LocalIndex];
+            if (Label == 0)
+            {
+                continue;
+            }
+
+            const FIntPoint Grid = ChunkOrigin + FGridCellChunk::GetLocalCoord(LocalIndex);
+            for (const FIntPoint& Neighbor : { Grid - FIntPoint(1, 0), Grid - FIntPoint(0, 1) })
+            {
+                const FGridCellChunk* NeighborChunk = FindChunk(Neighbor);
+                const int32 NeighborLabel = NeighborChunk ? NeighborChunk->RegionLabels[FGridCellChunk::GetLocalIndex(Neighbor)] : 0;
+                if (NeighborLabel == 0)
+                {
+                    continue;
+                }
+
+                int32 RootA = Find(Label);
+                int32 RootB = Find(NeighborLabel);
+                if (RootA != RootB)
+                {
+                    if (Sizes[RootA] < Sizes[RootB])
+                    {
+                        Swap(RootA, RootB);
+                    }
+                    Parents[RootB] = RootA;
+                    Sizes[RootA] += Sizes[RootB];
+                }
+            }
+        }
+    }
+
+    // 第三遍：根编号压缩为 1..N 写回区块
+    TArray<int32> CompactLabels;
+    CompactLabels.SetNumZeroed(Parents.Num());
+    int32 NumRegions = 0;
+    for (const TPair<FIntPoint, TUniquePtr<FGridCellChunk>>& Pair : Chunks)
+    {
+        FGridCellChunk& Chunk = *Pair.Value;
+        for (int32 LocalIndex = 0; LocalIndex < FGridCellChunk::NumCells; ++LocalIndex)
+        {
+            int32& Label = Chunk.RegionLabels[LocalIndex];
+            if (Label != 0)
+            {
+                int32& Compact = CompactLabels[Find(Label)];
+                if (Compact == 0)
+                {
+                    Compact = ++NumRegions;
+                }
+                Label = Compact;
+            }
+        }
+    }
+
+    ResetRegionRoots(NumRegions);
+}
+
+void AGridManager::ResetRegionRoots(int32 NumRegions)
+{
+    RegionRoots.SetNumUninitialized(NumRegions + 1);
+    for (int32 Label = 0; Label <= NumRegions; ++Label)
+    {
+        RegionRoots[Label] = Label;
+    }
+
+    // 下限保证区域很少时也要累积足够多的编辑才压缩一次，压缩的整表开销分摊到这些编辑上
+    MaxRegionLabels = FMath::Max(NumRegions * 4, 1024);
+}
+
+void AGridManager::CompactRegionLabelsIfNeeded()
+{
+    if (RegionRoots.Num() <= MaxRegionLabels)
+    {
+        return;
+    }
+
+    // 区块内的原始编号改写为合并后的区域编号并压缩为 1..N，没有格子再使用的编号随之回收
+    TArray<int32> CompactLabels;
+    CompactLabels.SetNumZeroed(RegionRoots.Num());
+    int32 NumRegions = 0;
+    for (TPair<FIntPoint, TUniquePtr<FGridCellChunk>>& Pair : Chunks)
+    {
+        for (int32& Label : Pair.Value->RegionLabels)
+        {
+            if (Label != 0)
+            {
+                int32& Compact = CompactLabels[RegionRoots[Label]];
+                if (Compact == 0)
+                {
+                    Compact = ++NumRegions;
+                }
+                Label = Compact;
+            }
+        }
+    }
+    ResetRegionRoots(NumRegions);
+}
+
+int32 AGridManager::AllocateRegionLabel()
+{
+    return RegionRoots.Add(RegionRoots.Num());
+}
+
+void AGridManager::MergeRegions(int32 KeepRoot, int32 MergedRoot)
+{
+    // 区域数量远小于格子数量，直接改写映射表，区块内的原始编号保持不变
+    for (int32& Root : RegionRoots)
+    {
+        if (Root == MergedRoot)
+        {
+            Root = KeepRoot;
+        }
+    }
+}
+
+void AGridManager::UpdateRegionLabels(FIntPoint Grid, bool bWalkable)
+{
+    FGridCellChunk* Chunk = FindChunk(Grid);
+    if (!Chunk)
+    {
+        return;
+    }
+    int32& CellLabel = Chunk->RegionLabels[FGridCellChunk::GetLocalIndex(Grid)];
+
+    if (bWalkable)
+    {
+        // 并入相邻区域；连接了多个区域时将它们合并
+        int32 Root = 0;
+        FGridTopology4::ForEachNeighbor(Grid, [this, &Root](FIntPoint Neighbor, int32)
+        {
+            const int32 NeighborRoot = GetRegionLabel(Neighbor);
+            if (NeighborRoot == 0 || NeighborRoot == Root)
+            {
+                return;
+            }
+            if (Root == 0)
+            {
+                Root = NeighborRoot;
+            }
+            else
+            {
+                MergeRegions(Root, NeighborRoot);
+            }
+        });
+        CellLabel = Root != 0 ? Root : AllocateRegionLabel();
+        CompactRegionLabelsIfNeeded();
+        return;
+    }
+
+    CellLabel = 0;
+
+    TArray<FIntPoint, TInlineAllocator<FGridTopology4::NumDirections>> Seeds;
+    FGridTopology4::ForEachNeighbor(Grid, [this, &Seeds](FIntPoint Neighbor, int32)
+    {
+        if (GetRegionLabel(Neighbor) != 0)
+        {
+            Seeds.Add(Neighbor);
+        }
+    });
+    SplitRegion(Seeds);
+    CompactRegionLabelsIfNeeded();
+}
+
+void AGridManager::UpdateStreamedRegionLabels(TConstArrayView<FIntPoint> WalkableGrids, TConstArrayView<FIntPoint> UnwalkableGrids)
+{
+    // 变为不可行走的格子（卸载）：清除编号，相邻的剩余格子按区域分组，各组检测是否被切断
+    for (const FIntPoint& Grid : UnwalkableGrids)
+    {
+        if (FGridCellChunk* Chunk = FindChunk(Grid))
+        {
+            Chunk->RegionLabels[FGridCellChunk::GetLocalIndex(Grid)] = 0;
+        }
+    }
+
+    TMap<int32, TArray<FIntPoint>> SeedsByRegion;
+    for (const FIntPoint& Grid : UnwalkableGrids)
+    {
+        FGridTopology4::ForEachNeighbor(Grid, [this, &SeedsByRegion](FIntPoint Neighbor, int32)
+        {
+            if (const int32 Region = GetRegionLabel(Neighbor))
+            {
+                SeedsByRegion.FindOrAdd(Region).Add(Neighbor);
+            }
+        });
+    }
+    for (const TPair<int32, TArray<FIntPoint>>& Pair : SeedsByRegion)
+    {
+        SplitRegion(Pair.Value);
+    }
+
+    // 变为可行走的格子（加载）：先清除编号，再按连通块泛洪分配新编号，碰到已有区域时合并
+    for (const FIntPoint& Grid : WalkableGrids)
+    {
+        FindChunk(Grid)->RegionLabels[FGridCellChunk::GetLocalIndex(Grid)] = 0;
+    }
+
+    TArray<FIntPoint> Queue;
+    for (const FIntPoint& Start : WalkableGrids)
+    {
+        if (GetRegionLabel(Start) != 0)
+        {
+            continue;
+        }
+
+        const int32 NewLabel = AllocateRegionLabel();
+        int32 Root = NewLabel;
+        FindChunk(Start)->RegionLabels[FGridCellChunk::GetLocalIndex(Start)] = NewLabel;
+        Queue.Reset();
+        Queue.Add(Start);
+        for (int32 Head = 0; Head < Queue.Num(); ++Head)
+        {
+            FGridTopology4::ForEachNeighbor(Queue[Head], [this, NewLabel, &Root, &Queue](FIntPoint Neighbor, int32)
+            {
+                if (!WalkableBoard.TestBit(Neighbor))
+                {
+                    return;
+                }
+                const int32 NeighborRoot = GetRegionLabel(Neighbor);
+                if (NeighborRoot == 0)
+                {
+                    FindChunk(Neighbor)->RegionLabels[FGridCellChunk::GetLocalIndex(Neighbor)] = NewLabel;
+                    Queue.Add(Neighbor);
+                }
+                else if (NeighborRoot != Root)
+                {
+                    MergeRegions(NeighborRoot, Root);
+                    Root = NeighborRoot;
+                }
+            });
+        }
+    }
+    CompactRegionLabelsIfNeeded();
+}
+
+void AGridManager::SplitRegion(TConstArrayView<FIntPoint> Seeds)
+{
+    // 从每个起点同时做 BFS：两路相遇即属于同一区域；某一组先走完说明它已被切断，改用新编号
+    // 最后剩下的一组保留原编号，因此耗时取决于被切出去的较小部分，而不是整个区域
+    struct FRegionFront
+    {
+        TArray<FIntPoint> Cells;
+        int32 Head = 0;
+        int32 Group = 0;
+    };
+    TArray<FRegionFront, TInlineAllocator<FGridTopology4::NumDirections>> Fronts;
+    TMap<FIntPoint, int32> VisitedBy;
+
+    for (const FIntPoint& Seed : Seeds)
+    {
+        if (VisitedBy.Contains(Seed))
+        {
+            continue;
+        }
+        FRegionFront& Front = Fronts.AddDefaulted_GetRef();
+        Front.Group = Fronts.Num() - 1;
+        Front.Cells.Add(Seed);
+        VisitedBy.Add(Seed, Front.Group);
+    }
+
+    auto FindGroup = [&Fronts](int32 FrontIndex)
+    {
+        while (Fronts[FrontIndex].Group != FrontIndex)
+        {
+            FrontIndex = Fronts[FrontIndex].Group;
+        }
+        return FrontIndex;
+    };
+
+    TArray<bool, TInlineAllocator<FGridTopology4::NumDirections>> GroupDone;
+    GroupDone.SetNumZeroed(Fronts.Num());
+    TArray<int32, TInlineAllocator<FGridTopology4::NumDirections>> NumActiveFronts;
+
+    for (;;)
+    {
+        // 仍在扩展或尚未结算的组
+        int32 NumOpenGroups = 0;
+        for (int32 Index = 0; Index < Fronts.Num(); ++Index)
+        {
+            NumOpenGroups += (FindGroup(Index) == Index && !GroupDone[Index]) ? 1 : 0;
+        }
+        if (NumOpenGroups <= 1)
+        {
+            break;
+        }
+
+        // 每组轮流扩展一层中的一个格子
+        for (int32 Index = 0; Index < Fronts.Num(); ++Index)
+        {
+            FRegionFront& Front = Fronts[Index];
+            if (GroupDone[FindGroup(Index)] || Front.Head >= Front.Cells.Num())
+            {
+                continue;
+            }
+
+            const FIntPoint Current = Front.Cells[Front.Head++];
+            FGridTopology4::ForEachNeighbor(Current, [this, Index, &Fronts, &VisitedBy, &FindGroup](FIntPoint Neighbor, int32)
+            {
+                if (GetRegionLabel(Neighbor) == 0)
+                {
+                    return;
+                }
+                if (const int32* Other = VisitedBy.Find(Neighbor))
+                {
+                    const int32 GroupA = FindGroup(Index);
+                    const int32 GroupB = FindGroup(*Other);
+                    if (GroupA != GroupB)
+                    {
+                        Fronts[FMath::Max(GroupA, GroupB)].Group = FMath::Min(GroupA, GroupB);
+                    }
+                    return;
+                }
+                VisitedBy.Add(Neighbor, Index);
+                Fronts[Index].Cells.Add(Neighbor);
+            });
+        }
+
+        // 整组都已走完且未与其他组相遇：这是一个被切断的独立区域（起点很多时按组计数，避免两两比较）
+        NumActiveFronts.Reset();
+        NumActiveFronts.SetNumZeroed(Fronts.Num());
+        for (int32 Index = 0; Index < Fronts.Num(); ++Index)
+        {
+            if (Fronts[Index].Head < Fronts[Index].Cells.Num())
+            {
+                ++NumActiveFronts[FindGroup(Index)];
+            }
+        }
+        for (int32 Index = 0; Index < Fronts.Num(); ++Index)
+        {
+            if (FindGroup(Index) != Index || GroupDone[Index] || NumActiveFronts[Index] > 0)
+            {
+                continue;
+            }
+
+            GroupDone[Index] = true;
+            const int32 NewLabel = AllocateRegionLabel();
+            for (int32 Other = 0; Other < Fronts.Num(); ++Other)
+            {
+                if (FindGroup(Other) != Index)
+                {
+                    continue;
+                }
+                for (const FIntPoint& RegionGrid : Fronts[Other].Cells)
+                {
+                    FindChunk(RegionGrid)->RegionLabels[FGridCellChunk::GetLocalIndex(RegionGrid)] = NewLabel;
+                }
+            }
+        }
+    }
+}
+
+void AGridManager::RecordCellChange(FIntPoint Grid, int32& CellVersion)
+{
+    // 版本号晚于本帧日志起点说明本帧已记录过，不重复加入
+    const bool bAlreadyJournaled = CellVersion > PendingJournalStartVersion;
+    CellVersion = ++GridVersion;
+    if (!bAlreadyJournaled)
+    {
+        PendingChangedCells.Add(Grid);
+    }
+    AddChangeHistory(Grid);
+    ScheduleChangeFlush();
+}
+
+void AGridManager::AddChangeHistory(FIntPoint Grid)
+{
+    // 超出上限时丢弃较早的一半，之前的版本号不再能增量查询
+    if (ChangeHistory.Num() >= MaxChangeHistory)
+    {
+        const int32 NumRemoved = MaxChangeHistory / 2;
+        ChangeHistoryStartVersion = ChangeHistory[NumRemoved - 1].Version;
+        ChangeHistory.RemoveAt(0, NumRemoved, EAllowShrinking::No);
+    }
+    ChangeHistory.Add({ GridVersion, Grid });
+}
+
+bool AGridManager::GetCellsChangedSince(int32 SinceVersion, TArray<FIntPoint>& OutGrids) const
+{
+    OutGrids.Reset();
+    if (SinceVersion < ChangeHistoryStartVersion || SinceVersion > GridVersion)
+    {
+        return false;
+    }
+
+    const int32 First = Algo::UpperBoundBy(ChangeHistory, SinceVersion, &FGridChangeEntry::Version);
+    OutGrids.Reserve(ChangeHistory.Num() - First);
+    for (int32 Index = First; Index < ChangeHistory.Num(); ++Index)
+    {
+        OutGrids.Add(ChangeHistory[Index].Grid);
+    }
+    return true;
+}
+
+void AGridManager::ScheduleChangeFlush()
+{
+    UWorld* World = GetWorld();
+    if (!World || FlushChangesTimerHandle.IsValid())
+    {
+        return;
+    }
+    FlushChangesTimerHandle = World->GetTimerManager().SetTimerForNextTick(this, &AGridManager::FlushCellChanges);
+}
+
+void AGridManager::FlushCellChanges()
+{
+    FlushChangesTimerHandle.Invalidate();
+
+    TArray<FIntPoint> ChangedCells = MoveTemp(PendingChangedCells);
+    const bool bFullRebuild = bPendingFullRebuild;
+    PendingChangedCells.Reset();
+    PendingJournalStartVersion = GridVersion;
+    bPendingFullRebuild = false;
+
+    if (ChangedCells.Num() == 0 && !bFullRebuild)
+    {
+        return;
+    }
+
+    if (GridRenderer && !bFullRebuild)
+    {
+        GridRenderer->UpdateInstances(this, ChangedCells);
+    }
+    OnGridCellsChanged.Broadcast(ChangedCells, bFullRebuild, GridVersion);
+}
+
+void AGridManager::EnsureGridRenderer()
+{
+    if (GridRenderer)
+    {
+        return;
+    }
+
+    // 优先使用场景中放置的 GridRenderer（可在其上指定网格体和材质）
+    for (TActorIterator<AGridRenderer> It(GetWorld()); It; ++It)
+    {
+        GridRenderer = *It;
+        return;
+    }
+
+    if (GridRendererClass)
+    {
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.Owner = this;
+        GridRenderer = GetWorld()->SpawnActor<AGridRenderer>(GridRendererClass, FTransform::Identity, SpawnParams);
+    }
+}
+
+void AGridManager::ForEachLoadedCell(TFunctionRef<void(FIntPoint Grid, const FGridCellRecord& Cell)> Visitor) const
+{
+    for (const TPair<FIntPoint, TUniquePtr<FGridCellChunk>>& Pair : Chunks)
+    {
+        const FIntPoint ChunkOrigin = FGridCellChunk::ChunkToGrid(Pair.Key);
+        for (int32 LocalIndex = 0; LocalIndex < FGridCellChunk::NumCells; ++LocalIndex)
+        {
+            const FGridCellRecord& Cell = Pair.Value->Cells[LocalIndex];
+            if (Cell.IsValid())
+            {
+                Visitor(ChunkOrigin + FGridCellChunk::GetLocalCoord(LocalIndex), Cell);
+            }
+        }
+    }
+}
+
+void AGridManager::HandleLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+    if (World != GetWorld() || !Level)
+    {
+        return;
+    }
+
+    const int32 NumGridCells = AddGridCellsFromLevel(Level);
+    if (NumGridCells > 0)
+    {
+        OnCellsStreamed(LevelCellGrids.FindChecked(Level));
+        UE_LOG(LogTemp, Log, TEXT("GridManager: Streamed in %d GridCells from %s, %d chunks loaded"),
+            NumGridCells, *GetNameSafe(Level->GetOuter()), Chunks.Num());
+    }
+}
+
+void AGridManager::HandleLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+    // Level 为空表示整个世界被移除，由 EndPlay 处理
+    if (World != GetWorld() || !Level)
+    {
+        return;
+    }
+
+    TArray<FIntPoint> RemovedGrids;
+    const int32 NumGridCells = RemoveGridCellsFromLevel(Level, RemovedGrids);
+    if (NumGridCells > 0)
+    {
+        OnCellsStreamed(RemovedGrids);
+        UE_LOG(LogTemp, Log, TEXT("GridManager: Streamed out %d GridCells from %s, %d chunks loaded"),
+            NumGridCells, *GetNameSafe(Level->GetOuter()), Chunks.Num());
+    }
+}
+
+FGridCellChunk* AGridManager::FindChunk(FIntPoint Grid) const
+{
+    const FIntPoint Local = FGridCellChunk::GridToChunk(Grid) - ChunkDirectoryMin;
+    if (Local.X < 0 || Local.Y < 0 || Local.X >= ChunkDirectorySize.X || Local.Y >= ChunkDirectorySize.Y)
+    {
+        return nullptr;
+    }
+    return ChunkDirectory[Local.Y * ChunkDirectorySize.X + Local.X];
+}
+
+const FGridCellRecord* AGridManager::FindCell(FIntPoint Grid) const
+{
+    const FGridCellChunk* Chunk = FindChunk(Grid);
+    return Chunk ? &Chunk->Cells[FGridCellChunk::GetLocalIndex(Grid)] : nullptr;
+}
+
+const FGridOccupantList* AGridManager::FindOccupantList(FIntPoint Grid) const
+{
+    const FGridCellChunk* Chunk = FindChunk(Grid);
+    return Chunk ? &Chunk->Occupants[FGridCellChunk::GetLocalIndex(Grid)] : nullptr;
+}
+
+bool AGridManager::AreChunksLoaded(FIntPoint Min, FIntPoint Max) const
+{
+    const FIntPoint ChunkMin = FGridCellChunk::GridToChunk(Min);
+    const FIntPoint ChunkMax = FGridCellChunk::GridToChunk(Max);
+    for (int32 Y = ChunkMin.Y; Y <= ChunkMax.Y; ++Y)
+    {
+        for (int32 X = ChunkMin.X; X <= ChunkMax.X; ++X)
+        {
+            if (!FindChunk(FGridCellChunk::ChunkToGrid(FIntPoint(X, Y))))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int32 AGridManager::ValidateCellStoreAgainstWorld() const
+{
+    if (bMergeCellProxies)
+    {
+        // 代理已销毁，没有可对比的场景数据；不能返回 0，否则会被当作校验通过
+        UE_LOG(LogTemp, Warning, TEXT("ValidateCellStore: GridCell proxies were merged and destroyed, disable bMergeCellProxies to compare against the world"));
+        return INDEX_NONE;
+    }
+
+    int32 MismatchCount = 0;
+
+    // 包围盒外扩一圈，确保边界外的格子也被判定为无效
+    const FIntPoint From = CellStoreMin - FIntPoint(1, 1);
+    const FIntPoint To = CellStoreMin + CellStoreSize;
+    for (int32 Y = From.Y; Y <= To.Y; ++Y)
+    {
+        for (int32 X = From.X; X <= To.X; ++X)
+        {
+            const FIntPoint Grid(X, Y);
+            const bool bStoreValid = IsGridValid(Grid);
+            const bool bStoreWalkable = IsGridWalkable(Grid);
+            const bool bWorldValid = IsGridValidByActorScan(Grid);
+            const bool bWorldWalkable = IsGridWalkableByOverlap(Grid);
+
+            if (bStoreValid != bWorldValid || bStoreWalkable != bWorldWalkable)
+            {
+                ++MismatchCount;
+                UE_LOG(LogTemp, Error, TEXT("ValidateCellStore: Mismatch at %s (Valid %d/%d, Walkable %d/%d)"),
+                    *Grid.ToString(), bStoreValid, bWorldValid, bStoreWalkable, bWorldWalkable);
+            }
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("ValidateCellStore: %d mismatches in %s cells"),
+        MismatchCount, *(To - From + FIntPoint(1, 1)).ToString());
+    return MismatchCount;
+}
+
+int32 AGridManager::ValidateObstacleDistances() const
+{
+    int32 MismatchCount = 0;
+
+    for (int32 Y = 0; Y < CellStoreSize.Y; ++Y)
+    {
+        for (int32 X = 0; X < CellStoreSize.X; ++X)
+        {
+            const FIntPoint Grid = CellStoreMin + FIntPoint(X, Y);
+            for (int32 Index = 0; Index < FGridTopology4::NumDirections; ++Index)
+            {
+                const FIntPoint Direction = FGridTopology4::GetDirection(Index);
+                for (const bool bIncludeOccupants : { false, true })
+                {
+                    // 与 PathPlanner 旧实现相同的逐格前进
+                    int32 Expected = 0;
+                    FIntPoint Next = Grid + Direction;
+                    while (IsGridValid(Next) && IsGridWalkable(Next) && !(bIncludeOccupants && GetActorAtGrid(Next)))
+                    {
+                        ++Expected;
+                        Next += Direction;
+                    }
+
+                    const int32 Actual = GetObstacleDistance(Grid, Direction, bIncludeOccupants);
+                    if (Actual != Expected)
+                    {
+                        ++MismatchCount;
+                        UE_LOG(LogTemp, Error, TEXT("ValidateObstacleDistances: Mismatch at %s dir %s (Occupants %d): %d vs %d"),
+                            *Grid.ToString(), *Direction.ToString(), bIncludeOccupants, Actual, Expected);
+                    }
+                }
+            }
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("ValidateObstacleDistances: %d mismatches in %s cells"),
+        MismatchCount, *CellStoreSize.ToString());
+    return MismatchCount;
+}
+
+bool AGridManager::IsGridWalkableByOverlap(FIntPoint Grid) const
+{
+    const float GridSizeCM = 100.0f;
+    FVector TargetWorld(Grid.X * GridSizeCM, Grid.Y * GridSizeCM, 0.0f);
+
+    const float DetectionRadius = GridSizeCM * 0.4f;
+    const FVector DetectionOrigin = TargetWorld + FVector(0, 0, 10.0f);
+
+    FCollisionQueryParams QueryParams;
+    QueryParams.bReturnPhysicalMaterial = false;
+
+    FCollisionObjectQueryParams ObjectQueryParams;
+    ObjectQueryParams.AddObjectTypesToQuery(ECC_WorldDynamic); // 匹配 GridCell 的 ObjectType
+
+    TArray<FOverlapResult> OverlapResults;
+    bool bHasOverlap = GetWorld()->OverlapMultiByObjectType(
+        OverlapResults,
+        DetectionOrigin,
+        FQuat::Identity,
+        ObjectQueryParams,
+        FCollisionShape::MakeSphere(DetectionRadius),
+        QueryParams
+    );
+
+    if (!bHasOverlap)
+    {
+        // 没有检测到任何 GridCell，认为不可通行
+        return false;
+    }
+
+    // 检查是否有可行走的格子
+    for (const FOverlapResult& Result : OverlapResults)
+    {
+        if (AGridCell* GridCell = Cast<AGridCell>(Result.GetActor()))
+        {
+            if (GridCell->IsWalkable())
+            {
+                return true; // 找到了可行走的格子
+            }
+        }
+    }
+
+    // 没有找到可行走的格子，说明这里是墙壁或空地
+    return false;
+}
+
+bool AGridManager::IsGridValidByActorScan(FIntPoint Grid) const
+{
+    // 实时检查该坐标是否存在 GridCell
+    TArray<AActor*> FoundGridCells;
+    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AGridCell::StaticClass(), FoundGridCells);
+
+    for (AActor* Actor : FoundGridCells)
+    {
+        AGridCell* GridCell = Cast<AGridCell>(Actor);
+        if (GridCell && GridCell->GridCoordinate == Grid)
+        {
+            return true; // 找到了该坐标的 GridCell
+        }
+    }
+    return false; // 该坐标没有 GridCell
 }
\ No newline at end of file
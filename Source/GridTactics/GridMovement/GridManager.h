@@ -5,10 +5,26 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "GridDisplacementRequest.h"
+#include "GridType.h"
+#include "GridBitboard.h"
+#include "GridChunk.h"
+#include "GridSummedAreaTable.h"
+#include "GridObstacleDistance.h"
+#include "GridClearanceMap.h"
+#include "GridJumpPointTable.h"
+#include "GridClusterGraph.h"
+#include "GridFlowField.h"
 #include "GridManager.generated.h"
 
+// һ֡ڱ仯ĸӣϲȥغÿ֡㲥һΣbFullRebuild Ϊ true ʱʾ仯Χиı䡢ؽӴ洢Ӧȫؽ
+// Χڵʽ/жذ ChangedCellsӿܱΪЧЧ
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnGridCellsChanged, const TArray<FIntPoint>&, ChangedCells, bool, bFullRebuild, int32, GridVersion);
+
 class UPathPlanner;
 class UConflictResolver;
+class AGridRenderer;
+class AGridCell;
+class UGridMapAsset;
 UCLASS()
 class GRIDTACTICS_API AGridManager : public AActor
 {
@@ -20,6 +36,9 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+    // --- ԤÿһԭӲλCAS ռڹ̲߳ã/жͬʱУ ---
+
+    // ӿʱΪԤѱԤԼԤδط false
     UFUNCTION(BlueprintCallable, Category = "Grid")
     bool ReserveGrid(AActor* Requester, FIntPoint TargetGrid);
 
@@ -29,6 +48,22 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Grid")
     void ReleaseGrid(FIntPoint TargetGrid);
 
+    //  Owner Ԥʱͷţ²ͷű˸Ԥ
+    UFUNCTION(BlueprintCallable, Category = "Grid")
+    bool ReleaseGridIfOwner(AActor* Owner, FIntPoint TargetGrid);
+
+    // Ԥ˸øӵĽɫԤɫٷ nullptr
+    UFUNCTION(BlueprintPure, Category = "Grid")
+    AActor* GetGridReservation(FIntPoint TargetGrid) const;
+
+    // Ԥ Anchor ΪСǵ FootprintSize x FootprintSize ȫӶųɹعĸ
+    UFUNCTION(BlueprintCallable, Category = "Grid|Footprint")
+    bool ReserveFootprint(AActor* Requester, FIntPoint Anchor, int32 FootprintSize = 1);
+
+    // ͷ Owner Ԥĸ
+    UFUNCTION(BlueprintCallable, Category = "Grid|Footprint")
+    void ReleaseFootprintIfOwner(AActor* Owner, FIntPoint Anchor, int32 FootprintSize = 1);
+
     UFUNCTION(BlueprintCallable, Category = "Grid|Displacement")
     void RequestDash(AActor* Requester, FIntPoint Direction, int32 Distance,
         bool bCanKnockback = false, int32 KnockbackDist = 1
@@ -63,6 +98,113 @@ public:
     UFUNCTION(BlueprintPure, Category = "Grid")
     AActor* GetActorAtGrid(FIntPoint Grid) const;
 
+    // --- ѯΧָʾѭĵ÷һεɣ Grids һһӦ ---
+
+    // һβÿӵЧԡԺ͸ϵĽɫͼһεãԽͼ
+    // const  BlueprintCallable ᱻ UHT ÿűȡʱִһΣʽΪǴ
+    UFUNCTION(BlueprintCallable, Category = "Grid|Batch", meta = (BlueprintPure = false))
+    void BatchQueryGrids(const TArray<FIntPoint>& Grids, TArray<bool>& OutValid, TArray<bool>& OutWalkable,
+        TArray<AActor*>& OutActors) const;
+
+    // ɸѡߵĸӣbExcludeOccupied Ϊ true ʱͬʱ޳ɫռݵĸ
+    UFUNCTION(BlueprintCallable, Category = "Grid|Batch", meta = (BlueprintPure = false))
+    void FilterWalkableGrids(const TArray<FIntPoint>& Grids, TArray<FIntPoint>& OutGrids, bool bExcludeOccupied = false) const;
+
+    // C++ 汾Ϊλ
+    void BatchIsGridValid(TArrayView<const FIntPoint> Grids, TBitArray<>& OutValid) const;
+    void BatchIsGridWalkable(TArrayView<const FIntPoint> Grids, TBitArray<>& OutWalkable) const;
+    void BatchGetActorAtGrid(TArrayView<const FIntPoint> Grids, TArray<AActor*>& OutActors) const;
+
+    // --- ռλ -> ɫ GridMovementComponent ʱά ---
+
+    // ȡϵнɫ
+    UFUNCTION(BlueprintPure, Category = "Grid|Occupancy")
+    TArray<AActor*> GetActorsAtGrid(FIntPoint Grid) const;
+
+    // ȡ [Min, Max]߽磩ڵнɫ
+    UFUNCTION(BlueprintCallable, Category = "Grid|Occupancy")
+    void GetActorsInRect(FIntPoint Min, FIntPoint Max, TArray<AActor*>& OutActors) const;
+
+    // ȡپ <= Radius ڵнɫ
+    UFUNCTION(BlueprintCallable, Category = "Grid|Occupancy")
+    void GetActorsInManhattanRadius(FIntPoint Center, int32 Radius, TArray<AActor*>& OutActors) const;
+
+    // ½ɫڸӣ״εüעᣩFootprintSize > 1 ʱ NewGrid ΪռСǣÿ񶼵ǼǸýɫ
+    UFUNCTION(BlueprintCallable, Category = "Grid|Occupancy")
+    void UpdateActorOccupancy(AActor* Actor, FIntPoint NewGrid, int32 FootprintSize = 1);
+
+    // ռλƳɫ
+    UFUNCTION(BlueprintCallable, Category = "Grid|Occupancy")
+    void RemoveActorOccupancy(AActor* Actor);
+
+    // --- λͼ㣨 / ռλ / ӪӴ洢ðΧ ---
+
+    const FGridBitboard& GetWalkableBoard() const { return WalkableBoard; }
+    const FGridBitboard& GetOccupancyBoard() const { return OccupancyBoard; }
+    const FGridBitboard& GetTeamBoard(EGridTeam Team) const;
+
+    // ģǷָӪĽɫ
+    bool IsTeamInPattern(EGridTeam Team, FIntPoint Origin, const FGridPatternMask& Mask) const;
+
+    // ģǷɫ
+    bool IsAnyOccupiedInPattern(FIntPoint Origin, const FGridPatternMask& Mask) const;
+
+    // ģڿߵĸӣbExcludeOccupied Ϊ true ʱ޳ѱռݵĸ
+    void GetWalkableGridsInPattern(FIntPoint Origin, const FGridPatternMask& Mask,
+        TArray<FIntPoint>& OutGrids, bool bExcludeOccupied = false) const;
+
+    // --- μͼO(1)仯´βѯʱж㣬Ϸ̣߳ ---
+
+    //  [Min, Max]߽磩ڱָӪɫռݵĸ
+    UFUNCTION(BlueprintPure, Category = "Grid|Area")
+    int32 CountTeamCellsInRect(EGridTeam Team, FIntPoint Min, FIntPoint Max) const;
+
+    //  [Min, Max]߽磩ڲߵĸΧû GridCell ĿλҲ룩
+    UFUNCTION(BlueprintPure, Category = "Grid|Area")
+    int32 CountBlockedCellsInRect(FIntPoint Min, FIntPoint Max) const;
+
+    // --- ռأK x K ɫСǸΪê㣻ͼڲѯʱ㣬K > 1 ĲѯϷ̣߳ ---
+
+    //  Grid ΪСǵȫα߳ضϵ FGridClearanceMap::MaxClearanceO(1)
+    UFUNCTION(BlueprintPure, Category = "Grid|Footprint")
+    int32 GetGridClearance(FIntPoint Grid) const;
+
+    //  K x K ɫܷվ AnchorǽɫռλO(1)
+    UFUNCTION(BlueprintPure, Category = "Grid|Footprint")
+    bool CanFootprintStandAt(FIntPoint Anchor, int32 FootprintSize = 1) const;
+
+    // ڳ IgnoreActor ĵһɫ
+    UFUNCTION(BlueprintPure, Category = "Grid|Footprint")
+    AActor* GetActorInFootprint(FIntPoint Anchor, int32 FootprintSize = 1, AActor* IgnoreActor = nullptr) const;
+
+    // K x K ɫ Anchor  DirectionķλƽƵĸǰռΪվ
+    // ȡǰ K ͨϰСֵO(K)FootprintSize Ϊ 1 ʱͬ GetObstacleDistance
+    UFUNCTION(BlueprintPure, Category = "Grid|Footprint")
+    int32 GetFootprintObstacleDistance(FIntPoint Anchor, FIntPoint Direction, int32 FootprintSize = 1, bool bIncludeOccupants = true) const;
+
+    // ɫǼǵռر߳δǼΪ 1
+    UFUNCTION(BlueprintPure, Category = "Grid|Footprint")
+    int32 GetActorFootprintSize(AActor* Actor) const;
+
+    // ɫǼǵռê߳δǼǷ false
+    bool GetActorFootprint(const AActor* Actor, FIntPoint& OutAnchor, int32& OutFootprintSize) const;
+
+    // JPS+ ԾѰ·ãʱӱ仯ڴ˴㣬Ϸ̣߳
+    const FGridJumpPointTable& GetJumpPointTable() const;
+
+    // HPA* ֲѰ·ͼ״βѯʱֻ֮ؽӱ仯漰ĴأϷ̣߳
+    const FGridClusterGraph& GetClusterGraph() const;
+
+    // --- ϰ루ķO(1)仯´βѯʱ㣬Ϸ̣߳ ---
+
+    //  Grid  DirectionķλĿ߸ Grid ķ򷵻 0
+    // bIncludeOccupants Ϊ true ʱɫռݵĸҲϰ
+    UFUNCTION(BlueprintPure, Category = "Grid|Obstacles")
+    int32 GetObstacleDistance(FIntPoint Grid, FIntPoint Direction, bool bIncludeOccupants = true) const;
+
+    // ɫӪHeroCharacter -> PlayerEnemyCharacter -> Enemy
+    static EGridTeam GetActorTeam(const AActor* Actor);
+
     UFUNCTION(BlueprintPure, Category = "Grid")
     FIntPoint GetActorCurrentGrid(AActor* Actor) const;
 
@@ -72,13 +214,161 @@ public:
     UFUNCTION(BlueprintPure, Category = "Grid")
     FIntPoint WorldToGrid(FVector WorldPos) const;
 
+    // --- Ӵ洢 ---
+
+    // ӳѼعؿ GridCell ؽӴ洢BeginPlay ʱԶãʱɾ GridCell ֶã
+    // ʽؿ / World Partition ԪػжʱԶɾӦ飬ֶ
+    UFUNCTION(BlueprintCallable, Category = "Grid")
+    void RebuildCellStore();
+
+    // ȡͣЧ귵 Blocked
+    UFUNCTION(BlueprintPure, Category = "Grid")
+    EGridCellType GetGridCellType(FIntPoint Grid) const;
+
+    // ѼظӵİΧУСߴ磩
+    UFUNCTION(BlueprintPure, Category = "Grid")
+    FIntPoint GetGridBoundsMin() const { return CellStoreMin; }
+
+    UFUNCTION(BlueprintPure, Category = "Grid")
+    FIntPoint GetGridBoundsSize() const { return CellStoreSize; }
+
+    // ú決ͼGridMapBake дؿʱʹã
+    void SetGridMapAsset(UGridMapAsset* InGridMapAsset) { GridMapAsset = InGridMapAsset; }
+
+    // --- ʱӱ仯ƻǽ塢α仯ȣ ---
+
+    // ޸ĸ֮ͣ£Чδ䷵ false
+    UFUNCTION(BlueprintCallable, Category = "Grid|Change")
+    bool SetGridCellType(FIntPoint Grid, EGridCellType NewType);
+
+    // ȫְ汾ţÿθӱ仯򲼾ֱ仯
+    UFUNCTION(BlueprintPure, Category = "Grid|Change")
+    int32 GetGridVersion() const { return GridVersion; }
+
+    // һα仯ʱȫְ汾ţ0 = غδ仯
+    UFUNCTION(BlueprintPure, Category = "Grid|Change")
+    int32 GetGridCellVersion(FIntPoint Grid) const;
+
+    // 汾 SinceVersion ֮仯ĸӣظάݵĶʹ
+    // ڼ䷢ֱ仯¼ѱضʱ false÷ؽ
+    bool GetCellsChangedSince(int32 SinceVersion, TArray<FIntPoint>& OutGrids) const;
+
+    // --- Բ㣨ƶ / ߶ / Ӫ / Σ ---
+
+    // ȡȡֵЧ귵 0
+    UFUNCTION(BlueprintPure, Category = "Grid|Layers")
+    int32 GetGridLayerValue(FIntPoint Grid, EGridCellLayer Layer) const;
+
+    // д뵥ȡֵȡֵΧüЧֵδ䷵ false仯仯־
+    UFUNCTION(BlueprintCallable, Category = "Grid|Layers")
+    bool SetGridLayerValue(FIntPoint Grid, EGridCellLayer Layer, int32 Value);
+
+    // ȶȡ [Min, Max]߽磩ĳһȡֵδػЧĸΪ 0
+    UFUNCTION(BlueprintCallable, Category = "Grid|Layers")
+    void ReadLayerRect(EGridCellLayer Layer, FIntPoint Min, FIntPoint Max, TArray<int32>& OutValues) const;
+
+    // ӵȫԲ㣨Ч귵Ĭֵ
+    FGridCellAttributes GetGridCellAttributes(FIntPoint Grid) const;
+
+    // ѼظӵƶĶΪ 1ʱƶѰ·밴Ѱ·ȼۣ JPS+
+    UFUNCTION(BlueprintPure, Category = "Grid|Layers")
+    bool HasUniformMoveCost() const { return NumWeightedMoveCostCells == 0; }
+
+    // ĵĵλãGridToWorld ϸ߶Ȳ㣩
+    UFUNCTION(BlueprintPure, Category = "Grid|Layers")
+    FVector GetGridSurfaceLocation(FIntPoint Grid) const;
+
+    // --- ͨķڵĿ߸ӣ ---
+
+    // ǷɻൽֻΣǽɫռλһӲ߷ falseO(1)
+    UFUNCTION(BlueprintPure, Category = "Grid|Regions")
+    bool AreConnected(FIntPoint A, FIntPoint B) const;
+
+    // ͨıţ0 = ߻δأα仯ſܱ·䣬Ҫ֡
+    UFUNCTION(BlueprintPure, Category = "Grid|Regions")
+    int32 GetRegionLabel(FIntPoint Grid) const;
+
+    // ǰѺϲ޸ʹõıţ޺ᱻѹ
+    int32 GetNumRegionLabels() const { return RegionRoots.Num() - 1; }
+
+    // --- ߣ߱⣩ ---
+
+    // From  To ֮Ƿûڵ˸ӱڵBlockerMask Ϊ EGridSightBlocker 
+    UFUNCTION(BlueprintPure, Category = "Grid|Sight")
+    bool HasLineOfSight(FIntPoint From, FIntPoint To,
+        UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/GridTactics.EGridSightBlocker")) int32 BlockerMask) const;
+
+    //  From -> To ǰڵǰһӣڵ ToTo Ҳж
+    FIntPoint TraceGridLine(FIntPoint From, FIntPoint To, EGridSightBlocker Blockers, bool& bOutBlocked) const;
+
+    // Ƿڵ
+    bool IsSightBlocked(FIntPoint Grid, EGridSightBlocker Blockers) const;
+
+    // --- ҰԳӰͶ䣬Blocked Ӳ͸⣩ ---
+
+    // Origin 뾶 Radius ڵĿɼλͼ (Origin, Radius) 棨ʹõ̭뾶ڵĸͱ仯¼
+    // صֻһε GetFieldOfView IsGridInFieldOfView / GetVisibleGrids֮ǰЧ
+    const FGridBitboard& GetFieldOfView(FIntPoint Origin, int32 Radius);
+
+    // ǰҰ MaxCachedFieldsOfView
+    int32 GetNumCachedFieldsOfView() const { return FieldOfViewCache.Num(); }
+
+    UFUNCTION(BlueprintCallable, Category = "Grid|Sight")
+    bool IsGridInFieldOfView(FIntPoint Origin, int32 Radius, FIntPoint Target);
+
+    UFUNCTION(BlueprintCallable, Category = "Grid|Sight")
+    void GetVisibleGrids(FIntPoint Origin, int32 Radius, TArray<FIntPoint>& OutGrids);
+
+    // --- ׷ͬһյĽɫֻƶģռλ ---
+
+    //  Goal Ϊյյ㻺棨ʹõ̭Ӱ汾ű仯ؽ
+    // صֻһε GetFlowField GetFlowFieldStep / GetFlowFieldDistance֮ǰЧ÷Ҫó
+    const FGridFlowField& GetFlowField(FIntPoint Goal);
+
+    // ǰ MaxCachedFlowFields
+    int32 GetNumCachedFlowFields() const { return FlowFieldCache.Num(); }
+
+    // Grid  Goal һO(1)յ򲻿ɴʱ false
+    UFUNCTION(BlueprintCallable, Category = "Grid|FlowField")
+    bool GetFlowFieldStep(FIntPoint Grid, FIntPoint Goal, FIntPoint& OutNextGrid);
+
+    // Grid  Goal ۼƶģɴﷵ -1
+    UFUNCTION(BlueprintCallable, Category = "Grid|FlowField")
+    int32 GetFlowFieldDistance(FIntPoint Grid, FIntPoint Goal);
+
+    // ÿ֡ϲĸӱ仯֪ͨ
+    UPROPERTY(BlueprintAssignable, Category = "Grid|Change")
+    FOnGridCellsChanged OnGridCellsChanged;
+
+    // ѼصЧ
+    void ForEachLoadedCell(TFunctionRef<void(FIntPoint Grid, const FGridCellRecord& Cell)> Visitor) const;
+
+    // ԣӴ洢ɵĳѯԱȣزһµĸ
+    // ֻڹر bMergeCellProxiesб GridCellʱã򷵻 -1У Tests/GridCellStoreTests
+    UFUNCTION(BlueprintCallable, Category = "Grid|Debug")
+    int32 ValidateCellStoreAgainstWorld() const;
+
+    // ԣϰǰĽԱȣزһµģ, 
+    UFUNCTION(BlueprintCallable, Category = "Grid|Debug")
+    int32 ValidateObstacleDistances() const;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+    //  GridTacticsWorldSubsystem ע/ע
+    virtual void PostInitializeComponents() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 private:
-    UPROPERTY()
-    TMap<FIntPoint, TObjectPtr<AActor>> GridReservations;
+    // ɫ <-> Ԥ 32 λΪ UObject ȫ± + 1 32 λΪ±кţ±걻úɾʧЧ
+    static uint64 MakeReservationHandle(const AActor* Actor);
+    static AActor* ResolveReservationHandle(uint64 Handle);
+
+    std::atomic<uint64>* FindReservationSlot(FIntPoint Grid) const;
+
+    // ѯãȲռλλͼٰɫб
+    AActor* GetFirstOccupant(FIntPoint Grid) const;
 
     UPROPERTY()
     TArray<FGridDisplacementRequest> PendingDisplacements;
@@ -89,6 +379,224 @@ private:
 
     int32 CurrentRecursionDepth = 0;
 
+    // 決õĸݣú󱾹ؿGridManager ڹؿĸֱӴʲһζ룬ٱ GridCell
+    UPROPERTY(EditAnywhere, Category = "Grid")
+    TObjectPtr<UGridMapAsset> GridMapAsset;
+
+    // ʱ GridCell Ӵ洢٣ GridRenderer ͳһ
+    UPROPERTY(EditAnywhere, Category = "Grid|Render")
+    bool bMergeCellProxies = true;
+
+    // ûз GridRenderer ʱԶɵ
+    UPROPERTY(EditAnywhere, Category = "Grid|Render", meta = (EditCondition = "bMergeCellProxies"))
+    TSubclassOf<AGridRenderer> GridRendererClass;
+
+    UPROPERTY(Transient)
+    TObjectPtr<AGridRenderer> GridRenderer;
+
+    // һ GridRenderer
+    void EnsureGridRenderer();
+
+    // ϲɼ۲٣bMergeCellProxies رʱκ£
+    void MergeCellProxies(const TArray<AGridCell*>& Proxies);
+
+    static void GatherCellProxies(ULevel* Level, TArray<AGridCell*>& OutProxies);
+
+    // ϡӴ洢 32x32 䣬ֻд GridCell ռڴ
+    TMap<FIntPoint, TUniquePtr<FGridCellChunk>> Chunks;
+
+    // Ŀ¼ѼΧеĳָѯʱ O(1) λ
+    TArray<FGridCellChunk*> ChunkDirectory;
+    FIntPoint ChunkDirectoryMin = FIntPoint::ZeroValue;
+    FIntPoint ChunkDirectorySize = FIntPoint::ZeroValue;
+
+    // ѼظӵİΧ
+    FIntPoint CellStoreMin = FIntPoint::ZeroValue;
+    FIntPoint CellStoreSize = FIntPoint::ZeroValue;
+
+    // ƶĴ 1 Чɾ SetGridLayerValue ά
+    int32 NumWeightedMoveCostCells = 0;
+
+    // ռλڵÿɫбFGridCellChunk::OccupantsԼɫ -> ӵķ
+    TMap<TWeakObjectPtr<AActor>, FIntPoint> OccupantGrids;
+
+    // ռر߳ 1 ĽɫOccupantGrids дê㣩
+    TMap<TWeakObjectPtr<AActor>, int32> OccupantFootprintSizes;
+
+    int32 GetOccupantFootprintSize(const TWeakObjectPtr<AActor>& Key) const;
+
+    // ڽɫռڵÿӵǼ/Ƴýɫ
+    void AddOccupantToCells(const TWeakObjectPtr<AActor>& Key, FIntPoint Anchor, int32 FootprintSize);
+    void RemoveOccupantFromCells(const TWeakObjectPtr<AActor>& Key, FIntPoint Anchor, int32 FootprintSize);
+
+    // --- 仯־ ---
+
+    int32 GridVersion = 0;
+
+    // ֡仯ĸӣӰ汾ȥأһ֡ʼǰͳһ㲥
+    TArray<FIntPoint> PendingChangedCells;
+    int32 PendingJournalStartVersion = 0;
+    bool bPendingFullRebuild = false;
+
+    // ֡ı仯¼汾ŵֻ MaxChangeHistory 汾 <= ChangeHistoryStartVersion ı仯Ѳ
+    struct FGridChangeEntry
+    {
+        int32 Version = 0;
+        FIntPoint Grid = FIntPoint::ZeroValue;
+    };
+    static constexpr int32 MaxChangeHistory = 16384;
+    TArray<FGridChangeEntry> ChangeHistory;
+    int32 ChangeHistoryStartVersion = 0;
+    void AddChangeHistory(FIntPoint Grid);
+    FTimerHandle FlushChangesTimerHandle;
+
+    // ¼һθӱ仯ű֡ĺϲ㲥
+    void RecordCellChange(FIntPoint Grid, int32& CellVersion);
+    void ScheduleChangeFlush();
+    void FlushCellChanges();
+
+    // ÿؿ׵ĸ꣨ٺжعؿʱݴƳ
+    TMap<TObjectKey<ULevel>, TArray<FIntPoint>> LevelCellGrids;
+
+    FDelegateHandle LevelAddedHandle;
+    FDelegateHandle LevelRemovedHandle;
+
+    // λͼ㣺WalkableBoard Ӵ洢ؽռλӪλͼռλ
+    FGridBitboard WalkableBoard;
+    FGridBitboard OccupancyBoard;
+    FGridBitboard TeamBoards[(int32)EGridTeam::MAX];
+
+    // ͼλͼ࣬ѯʱ㣨Ϊ mutableconst ѯдЩֻϷ̵߳ã
+    mutable FGridSummedAreaTable TeamAreaTables[(int32)EGridTeam::MAX];
+    mutable FGridSummedAreaTable BlockedAreaTable;
+
+    // ϰΣλͼռλֿάɫƶֻռλб
+    mutable FGridObstacleDistance StaticObstacleDistance;
+    mutable FGridObstacleDistance OccupantObstacleDistance;
+
+    // ͨоͼλͼ࣬ѯʱ
+    mutable FGridClearanceMap ClearanceMap;
+
+    mutable FGridJumpPointTable JumpPointTable;
+
+    mutable FGridClusterGraph ClusterGraph;
+
+    // --- Ұ ---
+
+    struct FCachedFieldOfView
+    {
+        FGridBitboard Visible;
+
+        // һʹʱ FieldOfViewUseCountԽСԽδ
+        uint64 LastUseStamp = 0;
+    };
+
+    // Ϊ (Origin.X, Origin.Y, Radius)
+    TMap<FIntVector, FCachedFieldOfView> FieldOfViewCache;
+    uint64 FieldOfViewUseCount = 0;
+
+    // Ŀޣʱһ̭ʹõķ֮һͬһ֡ѯٶҰҲᳬ
+    UPROPERTY(EditAnywhere, Category = "Grid|Sight", meta = (ClampMin = "16"))
+    int32 MaxCachedFieldsOfView = 512;
+
+    // Χ [Min, Max] ཻĻҰ
+    void InvalidateFieldOfView(FIntPoint Min, FIntPoint Max);
+
+    // ---  ---
+
+    struct FCachedFlowField
+    {
+        FGridFlowField Field;
+        int32 GridVersion = 0;
+
+        // һʹʱ FlowFieldUseCountԽСԽδ
+        uint64 LastUseStamp = 0;
+    };
+
+    TMap<FIntPoint, FCachedFlowField> FlowFieldCache;
+    uint64 FlowFieldUseCount = 0;
+
+    // յޣÿյһͼСĳյǰʹ̭
+    UPROPERTY(EditAnywhere, Category = "Grid|FlowField", meta = (ClampMin = "1"))
+    int32 MaxCachedFlowFields = 4;
+
+    // --- ͨ ---
+
+    // ڴŵԭʼ -> ϲţϲʱдʹѯֻһβ± 0 ߣ
+    TArray<int32> RegionRoots;
+
+    // ֵʱѹϴѹȫǣʱ 4  1024ʹ RegionRoots  MergeRegions Ŀ༭
+    int32 MaxRegionLabels = 1024;
+
+    // 鼯ȫǣֱ仯ãŴ 1 ʼ
+    void RebuildRegionLabels();
+
+    // ӿԱ仯£Ϊʱϲ򣬱ΪʱǷ
+    void UpdateRegionLabels(FIntPoint Grid, bool bWalkable);
+
+    // ʽ/жغ£жصĸӰѣصĸӷŲϲ
+    void UpdateStreamedRegionLabels(TConstArrayView<FIntPoint> WalkableGrids, TConstArrayView<FIntPoint> UnwalkableGrids);
+
+    // Seeds ͬһ뱻ƳĸӶϿӸͬʱ BFSжϵĲָ±
+    void SplitRegion(TConstArrayView<FIntPoint> Seeds);
+
+    int32 AllocateRegionLabel();
+    void MergeRegions(int32 KeepRoot, int32 MergedRoot);
+
+    // RegionRoots Ϊ 0..NumRegions ĺӳ䣬 MaxRegionLabels
+    void ResetRegionRoots(int32 NumRegions);
+
+    //  MaxRegionLabels ʱڵıŸдΪյţֻ½ãʱûݴıţ
+    void CompactRegionLabelsIfNeeded();
+
+    //  OccupantGrids ɫ·䵽Ľɫбɾã
+    void RebuildCellOccupants();
+
+    // ֻ· ChunkCoords ĽɫбˢЩ鷶ΧڵռλӪλʽ/жغã
+    void RebuildChunkOccupants(const TSet<FIntPoint>& ChunkCoords);
+
+    // ӵǰĽɫбˢռλӪλ
+    void RefreshOccupancyBits(const FGridOccupantList& Occupants, FIntPoint Grid);
+
+    // ---  ---
+
+    // д/Ӽ¼Բ㣬ͷ飻ЧǷ仯
+    bool AddCellRecord(FIntPoint Grid, EGridCellType Type, bool bWalkable, const FGridCellAttributes& Attributes);
+    bool RemoveCellRecord(FIntPoint Grid);
+
+    //  GridMapAsset 뱾ؿĸӣЧʱ INDEX_NONE
+    int32 LoadCellsFromMapAsset();
+
+    // ؿе GridCell /Ƴ洢ش GridCell OutGrids ΪӰĸ
+    int32 AddGridCellsFromLevel(ULevel* Level);
+    int32 RemoveGridCellsFromLevel(ULevel* Level, TArray<FIntPoint>& OutGrids);
+
+    // ɾΧСĿ¼λͼռλ°Χ
+    void OnCellLayoutChanged();
+
+    // ʽ/жغ£ӶڵǰΧʱֻؽĿ¼Щӱ࣬šɫбҰֻɾĸ飻˻ OnCellLayoutChanged
+    // жزΧУֳߴ磩´ RebuildCellStore ʱս
+    void OnCellsStreamed(TConstArrayView<FIntPoint> Grids);
+
+    //  Chunks ؽĿ¼
+    void RebuildChunkDirectory();
+
+    // ʽؿ / World Partition Ԫж
+    void HandleLevelAddedToWorld(ULevel* Level, UWorld* World);
+    void HandleLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+    // 飬δط nullptr
+    FGridCellChunk* FindChunk(FIntPoint Grid) const;
+    const FGridCellRecord* FindCell(FIntPoint Grid) const;
+    const FGridOccupantList* FindOccupantList(FIntPoint Grid) const;
+
+    // [Min, Max] ǵǷȫѼأʱռλԸģ
+    bool AreChunksLoaded(FIntPoint Min, FIntPoint Max) const;
+
+    // ɵĳѯʵ֣ ValidateCellStoreAgainstWorld
+    bool IsGridValidByActorScan(FIntPoint Grid) const;
+    bool IsGridWalkableByOverlap(FIntPoint Grid) const;
+
     // --- Ĺ ---
     void PlanAllPaths();
     void ResolveAllConflicts();
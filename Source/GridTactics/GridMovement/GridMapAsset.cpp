@@ -0,0 +1,191 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridMapAsset.h"
+
+namespace GridMapEncoding
+{
+    constexpr uint8 TypeMask = 0x0F;
+    constexpr uint8 ValidBit = 1 << 4;
+    constexpr uint8 WalkableBit = 1 << 5;
+
+    // 每格字节数：仅类型 / 类型 + 属性层
+    constexpr int64 TypeOnlyBytesPerCell = 1;
+    constexpr int64 LayeredBytesPerCell = 1 + 1 + 2 + 1 + 1;
+}
+
+uint8 UGridMapAsset::EncodeCell(const FGridCellRecord& Cell)
+{
+    // 无格子统一编码为 0
+    if (!Cell.IsValid())
+    {
+        return 0;
+    }
+
+    uint8 Encoded = ((uint8)Cell.Type & GridMapEncoding::TypeMask) | GridMapEncoding::ValidBit;
+    if (Cell.IsWalkable())
+    {
+        Encoded |= GridMapEncoding::WalkableBit;
+    }
+    return Encoded;
+}
+
+FGridCellRecord UGridMapAsset::DecodeCell(uint8 Encoded)
+{
+    FGridCellRecord Cell;
+    if (Encoded & GridMapEncoding::ValidBit)
+    {
+        Cell.Type = (EGridCellType)(Encoded & GridMapEncoding::TypeMask);
+        Cell.Flags |= EGridCellFlags::Valid;
+        if (Encoded & GridMapEncoding::WalkableBit)
+        {
+            Cell.Flags |= EGridCellFlags::Walkable;
+        }
+    }
+    return Cell;
+}
+
+void UGridMapAsset::SetCells(FIntPoint InBoundsMin, FIntPoint InBoundsSize, TConstArrayView<FGridCellRecord> Cells,
+    TConstArrayView<FGridCellAttributes> Attributes)
+{
+    const int32 NumCells = InBoundsSize.X * InBoundsSize.Y;
+    check(Cells.Num() == NumCells && Attributes.Num() == NumCells);
+
+    BoundsMin = InBoundsMin;
+    BoundsSize = InBoundsSize;
+    NumValidCells = 0;
+
+    TArray<uint8> Encoded;
+    Encoded.SetNumZeroed(NumCells * GridMapEncoding::LayeredBytesPerCell);
+    uint8* TypePlane = Encoded.GetData();
+    uint8* MoveCostPlane = TypePlane + NumCells;
+    uint8* HeightPlane = MoveCostPlane + NumCells;
+    uint8* FactionPlane = HeightPlane + NumCells * 2;
+    uint8* HazardPlane = FactionPlane + NumCells;
+
+    for (int32 Index = 0; Index < NumCells; ++Index)
+    {
+        TypePlane[Index] = EncodeCell(Cells[Index]);
+        if (!Cells[Index].IsValid())
+        {
+            continue;
+        }
+        ++NumValidCells;
+
+        // 高度按小端存放，与平台无关
+        const uint16 Height = (uint16)Attributes[Index].Height;
+        MoveCostPlane[Index] = Attributes[Index].MoveCost;
+        HeightPlane[Index * 2] = (uint8)(Height & 0xFF);
+        HeightPlane[Index * 2 + 1] = (uint8)(Height >> 8);
+        FactionPlane[Index] = Attributes[Index].Faction;
+        HazardPlane[Index] = Attributes[Index].Hazard;
+    }
+    CellDataCrc = FCrc::MemCrc32(Encoded.GetData(), Encoded.Num());
+
+    CellBulkData.Lock(LOCK_READ_WRITE);
+    void* Data = CellBulkData.Realloc(Encoded.Num());
+    FMemory::Memcpy(Data, Encoded.GetData(), Encoded.Num());
+    CellBulkData.Unlock();
+
+    // 随导出数据内联保存，加载关卡时一并读入，不再单独发起 IO
+    CellBulkData.SetBulkDataFlags(BULKDATA_ForceInlinePayload);
+}
+
+bool UGridMapAsset::ReadCells(TArray<FGridCellRecord>& OutCells, TArray<FGridCellAttributes>* OutAttributes) const
+{
+    OutCells.Reset();
+    if (OutAttributes)
+    {
+        OutAttributes->Reset();
+    }
+
+    const int64 NumCells = int64(BoundsSize.X) * int64(BoundsSize.Y);
+    const int64 DataSize = CellBulkData.GetBulkDataSize();
+    const bool bLayered = DataSize == NumCells * GridMapEncoding::LayeredBytesPerCell;
+    if (!bLayered && DataSize != NumCells * GridMapEncoding::TypeOnlyBytesPerCell)
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridMapAsset %s: bulk data size %lld does not match bounds %s"),
+            *GetName(), DataSize, *BoundsSize.ToString());
+        return false;
+    }
+
+    const uint8* Data = static_cast<const uint8*>(CellBulkData.LockReadOnly());
+    const bool bCrcMatches = FCrc::MemCrc32(Data, (int32)DataSize) == CellDataCrc;
+    if (bCrcMatches)
+    {
+        OutCells.SetNumUninitialized((int32)NumCells);
+        for (int32 Index = 0; Index < OutCells.Num(); ++Index)
+        {
+            OutCells[Index] = DecodeCell(Data[Index]);
+        }
+
+        if (OutAttributes)
+        {
+            OutAttributes->SetNum((int32)NumCells);
+            if (bLayered)
+            {
+                const uint8* MoveCostPlane = Data + NumCells;
+                const uint8* HeightPlane = MoveCostPlane + NumCells;
+                const uint8* FactionPlane = HeightPlane + NumCells * 2;
+                const uint8* HazardPlane = FactionPlane + NumCells;
+                for (int32 Index = 0; Index < OutAttributes->Num(); ++Index)
+                {
+                    FGridCellAttributes& Attributes = (*OutAttributes)[Index];
+                    Attributes.MoveCost = FMath::Max<uint8>(MoveCostPlane[Index], 1);
+                    Attributes.Height = (int16)(uint16(HeightPlane[Index * 2]) | (uint16(HeightPlane[Index * 2 + 1]) << 8));
+                    Attributes.Faction = FactionPlane[Index];
+                    Attributes.Hazard = HazardPlane[Index];
+                }
+            }
+        }
+    }
+    CellBulkData.Unlock();
+
+    if (!bCrcMatches)
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridMapAsset %s: cell data CRC mismatch"), *GetName());
+    }
+    return bCrcMatches;
+}
+
+FString UGridMapAsset::ExportText() const
+{
+    TArray<FGridCellRecord> Cells;
+    if (!ReadCells(Cells))
+    {
+        return FString();
+    }
+
+    FString Text = FString::Printf(TEXT("GridMap %s\nSource %s\nBoundsMin %d %d\nBoundsSize %d %d\nValidCells %d\nCrc %08x\n"),
+        *GetName(), *SourceMap.ToString(), BoundsMin.X, BoundsMin.Y, BoundsSize.X, BoundsSize.Y, NumValidCells, CellDataCrc);
+    Text.Reserve(Text.Len() + (BoundsSize.X + 1) * BoundsSize.Y);
+
+    for (int32 Y = 0; Y < BoundsSize.Y; ++Y)
+    {
+        for (int32 X = 0; X < BoundsSize.X; ++X)
+        {
+            const FGridCellRecord& Cell = Cells[Y * BoundsSize.X + X];
+            if (!Cell.IsValid())
+            {
+                Text.AppendChar(TEXT('.'));
+            }
+            else if (Cell.Type == EGridCellType::Blocked)
+            {
+                Text.AppendChar(TEXT('#'));
+            }
+            else
+            {
+                Text.AppendChar(TEXT('0') + (TCHAR)FMath::Min<int32>((int32)Cell.Type, 9));
+            }
+        }
+        Text.AppendChar(TEXT('\n'));
+    }
+    return Text;
+}
+
+void UGridMapAsset::Serialize(FArchive& Ar)
+{
+    Super::Serialize(Ar);
+
+    CellBulkData.Serialize(Ar, this);
+}
\ No newline at end of file
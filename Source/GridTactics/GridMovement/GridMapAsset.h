@@ -0,0 +1,76 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Serialization/BulkData.h"
+#include "GridType.h"
+#include "GridMapAsset.generated.h"
+
+class UStaticMesh;
+class UMaterialInterface;
+
+/**
+ * 烘焙后的网格地图：按包围盒行优先排列，以 BulkData 形式内联存储
+ * 由 UGridMapBakeCommandlet 从关卡中的 GridCell 生成，GridManager 在 BeginPlay 一次性读入
+ *
+ * 数据按平面依次存放（N = 格子数）：
+ *   类型   N 字节   低 4 位 = EGridCellType，bit4 = Valid，bit5 = Walkable
+ *   移动消耗 N 字节，高度 N 个 int16，阵营 N 字节，危险区域 N 字节
+ * 只有类型平面的旧数据仍可读取，属性层取默认值
+ */
+UCLASS(BlueprintType)
+class GRIDTACTICS_API UGridMapAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+    // 烘焙来源关卡
+    UPROPERTY(VisibleAnywhere, Category = "Grid Map")
+    FSoftObjectPath SourceMap;
+
+    UPROPERTY(VisibleAnywhere, Category = "Grid Map")
+    FIntPoint BoundsMin = FIntPoint::ZeroValue;
+
+    UPROPERTY(VisibleAnywhere, Category = "Grid Map")
+    FIntPoint BoundsSize = FIntPoint::ZeroValue;
+
+    // 有效格子数量
+    UPROPERTY(VisibleAnywhere, Category = "Grid Map")
+    int32 NumValidCells = 0;
+
+    // 格子数据的 CRC，加载时校验
+    UPROPERTY(VisibleAnywhere, Category = "Grid Map")
+    uint32 CellDataCrc = 0;
+
+    // --- 格子外观（烘焙时从 GridCell 代理采集；打包版本中代理已被剔除，GridRenderer 从这里读取） ---
+
+    UPROPERTY(VisibleAnywhere, Category = "Grid Map|Render")
+    TObjectPtr<UStaticMesh> CellMesh;
+
+    UPROPERTY(VisibleAnywhere, Category = "Grid Map|Render")
+    TObjectPtr<UMaterialInterface> CellMaterial;
+
+    // 网格体相对格子地面位置的变换
+    UPROPERTY(VisibleAnywhere, Category = "Grid Map|Render")
+    FTransform CellMeshTransform;
+
+    // 写入格子数据（Cells/Attributes 按 BoundsMin/BoundsSize 行优先排列）
+    void SetCells(FIntPoint InBoundsMin, FIntPoint InBoundsSize, TConstArrayView<FGridCellRecord> Cells,
+        TConstArrayView<FGridCellAttributes> Attributes);
+
+    // 一次性读出全部格子（及属性层）；数据损坏（尺寸或 CRC 不符）时返回 false
+    bool ReadCells(TArray<FGridCellRecord>& OutCells, TArray<FGridCellAttributes>* OutAttributes = nullptr) const;
+
+    // 导出为逐行文本，便于离线 diff（'.' 无格子，'#' 阻挡，'0'~'9' 可行走/其他类型）
+    FString ExportText() const;
+
+    virtual void Serialize(FArchive& Ar) override;
+
+    static uint8 EncodeCell(const FGridCellRecord& Cell);
+    static FGridCellRecord DecodeCell(uint8 Encoded);
+
+private:
+    FByteBulkData CellBulkData;
+};
\ No newline at end of file
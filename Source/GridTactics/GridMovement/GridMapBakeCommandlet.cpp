@@ -0,0 +1,294 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridMapBakeCommandlet.h"
+#include "GridMapAsset.h"
+#include "GridManager.h"
+#include "GridCell.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Components/StaticMeshComponent.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+namespace GridMapBake
+{
+#if WITH_EDITOR
+    static bool SavePackageToDisk(UPackage* Package, UObject* Asset, const FString& Extension)
+    {
+        const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), Extension);
+
+        FSavePackageArgs SaveArgs;
+        SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+        SaveArgs.SaveFlags = SAVE_NoError;
+        if (!UPackage::SavePackage(Package, Asset, *Filename, SaveArgs))
+        {
+            UE_LOG(LogTemp, Error, TEXT("GridMapBake: Failed to save %s"), *Filename);
+            return false;
+        }
+        UE_LOG(LogTemp, Display, TEXT("GridMapBake: Saved %s"), *Filename);
+        return true;
+    }
+
+    // 从第一个带网格体的 GridCell 采集外观（与 AGridRenderer::CaptureAppearanceFromProxy 一致，高度不计入变换）
+    static bool CaptureAppearance(UWorld* World, UGridMapAsset* Asset)
+    {
+        for (AActor* Actor : World->PersistentLevel->Actors)
+        {
+            const AGridCell* GridCell = Cast<AGridCell>(Actor);
+            const UStaticMeshComponent* VisualMesh = GridCell ? GridCell->GetVisualMesh() : nullptr;
+            if (VisualMesh && VisualMesh->GetStaticMesh())
+            {
+                Asset->CellMesh = VisualMesh->GetStaticMesh();
+                Asset->CellMaterial = VisualMesh->GetMaterial(0);
+                Asset->CellMeshTransform = VisualMesh->GetRelativeTransform();
+                return true;
+            }
+        }
+        return false;
+    }
+#endif
+}
+
+UGridMapBakeCommandlet::UGridMapBakeCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UGridMapBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    FString MapName;
+    if (!FParse::Value(*Params, TEXT("Map="), MapName))
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridMapBake: Missing -Map=<long package name>"));
+        return 1;
+    }
+
+    FString OutputName;
+    if (!FParse::Value(*Params, TEXT("Output="), OutputName))
+    {
+        OutputName = MapName + TEXT("_GridMap");
+    }
+    const FString AssetName = FPackageName::GetLongPackageAssetName(OutputName);
+
+    const bool bValidateOnly = FParse::Param(*Params, TEXT("Validate"));
+    const bool bKeepProxies = FParse::Param(*Params, TEXT("KeepProxies"));
+    FString DumpFile;
+    FParse::Value(*Params, TEXT("Dump="), DumpFile);
+
+    UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+    UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+    if (!World || !World->PersistentLevel)
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridMapBake: Failed to load map %s"), *MapName);
+        return 1;
+    }
+
+    FIntPoint Min, Size;
+    TArray<FGridCellRecord> Cells;
+    TArray<FGridCellAttributes> Attributes;
+    const int32 NumProxies = GatherCells(World, Min, Size, Cells, Attributes);
+    if (NumProxies == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridMapBake: No GridCell in %s"), *MapName);
+        return 1;
+    }
+
+    UGridMapAsset* Asset = nullptr;
+    if (bValidateOnly)
+    {
+        // 离线校验：现有资产与关卡逐格对比
+        Asset = LoadObject<UGridMapAsset>(nullptr, *(OutputName + TEXT(".") + AssetName));
+        if (!Asset)
+        {
+            UE_LOG(LogTemp, Error, TEXT("GridMapBake: Grid map asset %s not found"), *OutputName);
+            return 1;
+        }
+
+        const int32 MismatchCount = CompareWithAsset(Asset, Min, Size, Cells, Attributes);
+        UE_LOG(LogTemp, Display, TEXT("GridMapBake: %s vs %s, %d mismatches"), *OutputName, *MapName, MismatchCount);
+        if (!DumpFile.IsEmpty())
+        {
+            FFileHelper::SaveStringToFile(Asset->ExportText(), *DumpFile);
+        }
+        return MismatchCount == 0 ? 0 : 1;
+    }
+
+    UPackage* AssetPackage = CreatePackage(*OutputName);
+    AssetPackage->FullyLoad();
+    Asset = FindObject<UGridMapAsset>(AssetPackage, *AssetName);
+    if (!Asset)
+    {
+        Asset = NewObject<UGridMapAsset>(AssetPackage, *AssetName, RF_Public | RF_Standalone);
+    }
+    Asset->SourceMap = FSoftObjectPath(World);
+    Asset->SetCells(Min, Size, Cells, Attributes);
+    if (!GridMapBake::CaptureAppearance(World, Asset))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("GridMapBake: No GridCell with a mesh in %s, cooked builds will not draw cells"), *MapName);
+    }
+    Asset->MarkPackageDirty();
+
+    UE_LOG(LogTemp, Display, TEXT("GridMapBake: %d GridCells -> %d cells, bounds %s size %s, crc %08x"),
+        NumProxies, Asset->NumValidCells, *Min.ToString(), *Size.ToString(), Asset->CellDataCrc);
+
+    if (!GridMapBake::SavePackageToDisk(AssetPackage, Asset, FPackageName::GetAssetPackageExtension()))
+    {
+        return 1;
+    }
+
+    // 关卡中的 GridManager 指向烘焙资产，GridCell 标记为编辑器专用（烘焙时剔除）
+    bool bMapDirty = false;
+    for (AActor* Actor : World->PersistentLevel->Actors)
+    {
+        if (AGridManager* GridManager = Cast<AGridManager>(Actor))
+        {
+            GridManager->SetGridMapAsset(Asset);
+            bMapDirty = true;
+        }
+        else if (AGridCell* GridCell = Cast<AGridCell>(Actor))
+        {
+            if (!bKeepProxies && !GridCell->bBakedToGridMap)
+            {
+                GridCell->bBakedToGridMap = true;
+                bMapDirty = true;
+            }
+        }
+    }
+    if (bMapDirty && !GridMapBake::SavePackageToDisk(MapPackage, World, FPackageName::GetMapPackageExtension()))
+    {
+        return 1;
+    }
+
+    if (!DumpFile.IsEmpty())
+    {
+        FFileHelper::SaveStringToFile(Asset->ExportText(), *DumpFile);
+    }
+    return 0;
+#else
+    UE_LOG(LogTemp, Error, TEXT("GridMapBake: Requires an editor build"));
+    return 1;
+#endif
+}
+
+int32 UGridMapBakeCommandlet::GatherCells(UWorld* World, FIntPoint& OutMin, FIntPoint& OutSize, TArray<FGridCellRecord>& OutCells,
+    TArray<FGridCellAttributes>& OutAttributes)
+{
+    // 与运行时 GridManager::WorldToGrid 一致的坐标换算
+    const float GridSizeCM = 100.0f;
+
+    TArray<TPair<FIntPoint, const AGridCell*>> CellsWithCoord;
+    FIntPoint Min(MAX_int32, MAX_int32);
+    FIntPoint Max(MIN_int32, MIN_int32);
+    for (AActor* Actor : World->PersistentLevel->Actors)
+    {
+        if (const AGridCell* GridCell = Cast<AGridCell>(Actor))
+        {
+            const FVector Location = GridCell->GetActorLocation();
+            const FIntPoint Coord(FMath::RoundToInt(Location.X / GridSizeCM), FMath::RoundToInt(Location.Y / GridSizeCM));
+            CellsWithCoord.Emplace(Coord, GridCell);
+
+            Min = FIntPoint(FMath::Min(Min.X, Coord.X), FMath::Min(Min.Y, Coord.Y));
+            Max = FIntPoint(FMath::Max(Max.X, Coord.X), FMath::Max(Max.Y, Coord.Y));
+        }
+    }
+
+    OutCells.Reset();
+    OutAttributes.Reset();
+    if (CellsWithCoord.Num() == 0)
+    {
+        OutMin = OutSize = FIntPoint::ZeroValue;
+        return 0;
+    }
+
+    OutMin = Min;
+    OutSize = Max - Min + FIntPoint(1, 1);
+    OutCells.SetNum(OutSize.X * OutSize.Y);
+    OutAttributes.SetNum(OutSize.X * OutSize.Y);
+
+    for (const TPair<FIntPoint, const AGridCell*>& Pair : CellsWithCoord)
+    {
+        const int32 Index = (Pair.Key.Y - Min.Y) * OutSize.X + (Pair.Key.X - Min.X);
+        FGridCellRecord& Record = OutCells[Index];
+        const AGridCell* GridCell = Pair.Value;
+
+        // 与 GridManager 的规则一致：叠放时只要有一个可行走就视为可行走，属性层取自同一个 GridCell
+        if (!Record.IsValid() || GridCell->IsWalkable())
+        {
+            Record.Type = GridCell->CellType;
+            OutAttributes[Index] = GridCell->GetCellAttributes();
+        }
+        Record.Flags |= EGridCellFlags::Valid;
+        if (GridCell->IsWalkable())
+        {
+            Record.Flags |= EGridCellFlags::Walkable;
+        }
+    }
+    return CellsWithCoord.Num();
+}
+
+int32 UGridMapBakeCommandlet::CompareWithAsset(const UGridMapAsset* Asset, FIntPoint Min, FIntPoint Size, const TArray<FGridCellRecord>& Cells,
+    const TArray<FGridCellAttributes>& Attributes)
+{
+    TArray<FGridCellRecord> AssetCells;
+    TArray<FGridCellAttributes> AssetAttributes;
+    if (!Asset->ReadCells(AssetCells, &AssetAttributes))
+    {
+        return FMath::Max(1, Cells.Num());
+    }
+
+    // 在两者包围盒的并集上逐格对比
+    const FIntPoint UnionMin(FMath::Min(Min.X, Asset->BoundsMin.X), FMath::Min(Min.Y, Asset->BoundsMin.Y));
+    const FIntPoint UnionMax(
+        FMath::Max(Min.X + Size.X, Asset->BoundsMin.X + Asset->BoundsSize.X) - 1,
+        FMath::Max(Min.Y + Size.Y, Asset->BoundsMin.Y + Asset->BoundsSize.Y) - 1);
+
+    // 返回格子在数组中的下标，不在包围盒内返回 INDEX_NONE
+    auto Lookup = [](FIntPoint SourceMin, FIntPoint SourceSize, FIntPoint Grid)
+    {
+        const FIntPoint Local = Grid - SourceMin;
+        if (Local.X < 0 || Local.Y < 0 || Local.X >= SourceSize.X || Local.Y >= SourceSize.Y)
+        {
+            return (int32)INDEX_NONE;
+        }
+        return Local.Y * SourceSize.X + Local.X;
+    };
+
+    int32 MismatchCount = 0;
+    for (int32 Y = UnionMin.Y; Y <= UnionMax.Y; ++Y)
+    {
+        for (int32 X = UnionMin.X; X <= UnionMax.X; ++X)
+        {
+            const FIntPoint Grid(X, Y);
+            const int32 LevelIndex = Lookup(Min, Size, Grid);
+            const int32 AssetIndex = Lookup(Asset->BoundsMin, Asset->BoundsSize, Grid);
+            const uint8 LevelCell = LevelIndex != INDEX_NONE ? UGridMapAsset::EncodeCell(Cells[LevelIndex]) : 0;
+            const uint8 AssetCell = AssetIndex != INDEX_NONE ? UGridMapAsset::EncodeCell(AssetCells[AssetIndex]) : 0;
+
+            bool bMismatch = LevelCell != AssetCell;
+            if (!bMismatch && LevelCell != 0)
+            {
+                const FGridCellAttributes& LevelAttributes = Attributes[LevelIndex];
+                const FGridCellAttributes& AssetAttributesAtGrid = AssetAttributes[AssetIndex];
+                bMismatch = LevelAttributes.MoveCost != AssetAttributesAtGrid.MoveCost
+                    || LevelAttributes.Height != AssetAttributesAtGrid.Height
+                    || LevelAttributes.Faction != AssetAttributesAtGrid.Faction
+                    || LevelAttributes.Hazard != AssetAttributesAtGrid.Hazard;
+            }
+
+            if (bMismatch)
+            {
+                ++MismatchCount;
+                UE_LOG(LogTemp, Warning, TEXT("GridMapBake: Mismatch at %s (level 0x%02x, asset 0x%02x)"),
+                    *Grid.ToString(), LevelCell, AssetCell);
+            }
+        }
+    }
+    return MismatchCount;
+}
\ No newline at end of file
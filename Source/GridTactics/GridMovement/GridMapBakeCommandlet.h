@@ -0,0 +1,42 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GridType.h"
+#include "GridMapBakeCommandlet.generated.h"
+
+class UGridMapAsset;
+class UWorld;
+
+/**
+ * 从关卡中的 GridCell 烘焙 UGridMapAsset
+ *
+ * 用法：
+ *   UnrealEditor-Cmd.exe GridTactics.uproject -run=GridMapBake -Map=/Game/Maps/Level1 [-Output=/Game/Maps/Level1_GridMap]
+ *       [-Validate]      只对比现有资产与关卡，不写入
+ *       [-Dump=<文件>]   导出逐行文本，便于 diff
+ *       [-KeepProxies]   不把 GridCell 标记为编辑器专用（默认标记后烘焙时会被剔除）
+ *
+ * 只读取持久关卡中的 GridCell；流式子关卡仍在运行时按 GridCell 加载
+ */
+UCLASS()
+class GRIDTACTICS_API UGridMapBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGridMapBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// 从关卡收集格子，返回 GridCell 数量
+	static int32 GatherCells(UWorld* World, FIntPoint& OutMin, FIntPoint& OutSize, TArray<FGridCellRecord>& OutCells,
+		TArray<FGridCellAttributes>& OutAttributes);
+
+	// 对比资产与关卡，返回不一致的格子数量
+	static int32 CompareWithAsset(const UGridMapAsset* Asset, FIntPoint Min, FIntPoint Size, const TArray<FGridCellRecord>& Cells,
+		const TArray<FGridCellAttributes>& Attributes);
+};
\ No newline at end of file
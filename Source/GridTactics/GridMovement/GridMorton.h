@@ -0,0 +1,122 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Morton（Z 序）编码：X 占偶数位，Y 占奇数位，二维上相邻的格子在一维下标上也大多相邻
+ * 用位掩码交错实现（与 PDEP/PEXT 结果相同，但不依赖 BMI2）；区块内坐标另有查表版本 EncodeLocal
+ */
+struct FGridMorton
+{
+    // 低 16 位交错到偶数位
+    static constexpr uint32 Spread(uint32 Value)
+    {
+        Value &= 0x0000FFFFu;
+        Value = (Value | (Value << 8)) & 0x00FF00FFu;
+        Value = (Value | (Value << 4)) & 0x0F0F0F0Fu;
+        Value = (Value | (Value << 2)) & 0x33333333u;
+        Value = (Value | (Value << 1)) & 0x55555555u;
+        return Value;
+    }
+
+    // Spread 的逆运算：取出偶数位压回低 16 位
+    static constexpr uint32 Compact(uint32 Value)
+    {
+        Value &= 0x55555555u;
+        Value = (Value | (Value >> 1)) & 0x33333333u;
+        Value = (Value | (Value >> 2)) & 0x0F0F0F0Fu;
+        Value = (Value | (Value >> 4)) & 0x00FF00FFu;
+        Value = (Value | (Value >> 8)) & 0x0000FFFFu;
+        return Value;
+    }
+
+    static constexpr uint32 Encode(uint32 X, uint32 Y) { return Spread(X) | (Spread(Y) << 1); }
+
+    // 区块内坐标（0~31）的查表编码：每维 5 位只需 32 项的表，省掉 Spread 的移位掩码链
+    static uint32 EncodeLocal(uint32 X, uint32 Y) { return LocalSpreadTable[X & 31] | (LocalSpreadTable[Y & 31] << 1); }
+    static constexpr uint32 DecodeX(uint32 Code) { return Compact(Code); }
+    static constexpr uint32 DecodeY(uint32 Code) { return Compact(Code >> 1); }
+
+    /**
+     * 按 Z 序遍历矩形 [Min, Max]（含边界）内的格子，不分配内存
+     * 从同时包含 Min 与 Max 的对齐方块开始四分，完全落在矩形内的方块直接按 Morton 码顺序展开
+     */
+    template<typename FunctorType>
+    static void ForEachInRect(FIntPoint Min, FIntPoint Max, FunctorType&& Visitor)
+    {
+        if (Max.X < Min.X || Max.Y < Min.Y)
+        {
+            return;
+        }
+
+        int32 RootLog2 = 0;
+        while (RootLog2 < MaxBlockLog2 && ((Min.X >> RootLog2) != (Max.X >> RootLog2) || (Min.Y >> RootLog2) != (Max.Y >> RootLog2)))
+        {
+            ++RootLog2;
+        }
+        if ((Min.X >> RootLog2) != (Max.X >> RootLog2) || (Min.Y >> RootLog2) != (Max.Y >> RootLog2))
+        {
+            // 跨越坐标范围一半以上的矩形退化为行优先遍历
+            for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+            {
+                for (int32 X = Min.X; X <= Max.X; ++X)
+                {
+                    Visitor(FIntPoint(X, Y));
+                }
+            }
+            return;
+        }
+
+        struct FBlock
+        {
+            FIntPoint Origin;
+            int32 Log2;
+        };
+
+        // 每下降一层最多净增 3 个待处理方块
+        FBlock Stack[3 * MaxBlockLog2 + 1];
+        int32 NumBlocks = 0;
+        Stack[NumBlocks++] = { FIntPoint((Min.X >> RootLog2) << RootLog2, (Min.Y >> RootLog2) << RootLog2), RootLog2 };
+
+        while (NumBlocks > 0)
+        {
+            const FBlock Block = Stack[--NumBlocks];
+            const int32 Extent = (1 << Block.Log2) - 1;
+            const FIntPoint BlockMax = Block.Origin + FIntPoint(Extent, Extent);
+            if (BlockMax.X < Min.X || BlockMax.Y < Min.Y || Block.Origin.X > Max.X || Block.Origin.Y > Max.Y)
+            {
+                continue;
+            }
+
+            const bool bContained = Block.Origin.X >= Min.X && Block.Origin.Y >= Min.Y && BlockMax.X <= Max.X && BlockMax.Y <= Max.Y;
+            if (bContained && Block.Log2 <= 15)
+            {
+                const uint32 NumCells = 1u << (2 * Block.Log2);
+                for (uint32 Code = 0; Code < NumCells; ++Code)
+                {
+                    Visitor(Block.Origin + FIntPoint((int32)DecodeX(Code), (int32)DecodeY(Code)));
+                }
+                continue;
+            }
+
+            // 子方块按 Z 序的逆序入栈，出栈顺序为 (0,0) (1,0) (0,1) (1,1)
+            const int32 Half = 1 << (Block.Log2 - 1);
+            Stack[NumBlocks++] = { Block.Origin + FIntPoint(Half, Half), Block.Log2 - 1 };
+            Stack[NumBlocks++] = { Block.Origin + FIntPoint(0, Half), Block.Log2 - 1 };
+            Stack[NumBlocks++] = { Block.Origin + FIntPoint(Half, 0), Block.Log2 - 1 };
+            Stack[NumBlocks++] = { Block.Origin, Block.Log2 - 1 };
+        }
+    }
+
+private:
+    static constexpr int32 MaxBlockLog2 = 30;
+
+    // LocalSpreadTable[V] == Spread(V)
+    static constexpr uint16 LocalSpreadTable[32] =
+    {
+        0x000, 0x001, 0x004, 0x005, 0x010, 0x011, 0x014, 0x015, 0x040, 0x041, 0x044, 0x045, 0x050, 0x051, 0x054, 0x055,
+        0x100, 0x101, 0x104, 0x105, 0x110, 0x111, 0x114, 0x115, 0x140, 0x141, 0x144, 0x145, 0x150, 0x151, 0x154, 0x155
+    };
+};
\ No newline at end of file
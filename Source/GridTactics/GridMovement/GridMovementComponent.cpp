@@ -4,6 +4,8 @@
 #include "GridTactics/AttributesComponent.h"
 #include "GridCell.h"
 #include "GridManager.h"
+#include "GridTopology.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
 #include "GameFramework/Character.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/CapsuleComponent.h"
@@ -38,6 +40,43 @@ void UGridMovementComponent::BeginPlay()
     {
         UE_LOG(LogTemp, Error, TEXT("GridMovementComponent: AttributesComponent not found on owner!"));
     }
+
+    // 注册到占位索引
+    int32 StartX, StartY;
+    GetCurrentGrid(StartX, StartY);
+    CommitOccupiedGrid(FIntPoint(StartX, StartY));
+}
+
+void UGridMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (AGridManager* GridManager = GetGridManager())
+    {
+        GridManager->RemoveActorOccupancy(GetOwner());
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+AGridManager* UGridMovementComponent::GetGridManager() const
+{
+    return UGridTacticsWorldSubsystem::GetGridManagerFor(this);
+}
+
+float UGridMovementComponent::GetTerrainHeightDelta(FIntPoint From, FIntPoint To) const
+{
+    if (AGridManager* GridManager = GetGridManager())
+    {
+        return GridManager->GetGridLayerValue(To, EGridCellLayer::Height) - GridManager->GetGridLayerValue(From, EGridCellLayer::Height);
+    }
+    return 0.0f;
+}
+
+void UGridMovementComponent::CommitOccupiedGrid(FIntPoint NewGrid)
+{
+    if (AGridManager* GridManager = GetGridManager())
+    {
+        GridManager->UpdateActorOccupancy(GetOwner(), NewGrid, FootprintSize);
+    }
 }
 
 // Called every frame
@@ -86,11 +125,23 @@ FVector UGridMovementComponent::GridToWorld(int32 X, int32 Y) const
     return FVector(X * GridSizeCM, Y * GridSizeCM, 0.0f);
 }
 
+FVector UGridMovementComponent::GetFootprintCenterOffset() const
+{
+    const float HalfExtent = (FootprintSize - 1) * GridSizeCM * 0.5f;
+    return FVector(HalfExtent, HalfExtent, 0.0f);
+}
+
+FVector UGridMovementComponent::FootprintToWorld(FIntPoint Anchor) const
+{
+    return GridToWorld(Anchor.X, Anchor.Y) + GetFootprintCenterOffset();
+}
+
 void UGridMovementComponent::GetCurrentGrid(int32& OutX, int32& OutY) const
 {
     if (OwnerCharacter)
     {
-        WorldToGrid(OwnerCharacter->GetActorLocation(), OutX, OutY);
+        // 多格角色位于占地区域中心，先还原到最小角格子
+        WorldToGrid(OwnerCharacter->GetActorLocation() - GetFootprintCenterOffset(), OutX, OutY);
     }
     else
     {
@@ -120,14 +171,12 @@ bool UGridMovementComponent::TryMoveOneStep(int32 DeltaX, int32 DeltaY)
     CurrentTargetGrid = FIntPoint(TargetX, TargetY);
 
     // 获取 GridManager（如果需要网格预定功能）
-    AGridManager* GridManager = Cast<AGridManager>(
-        UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass())
-    );
+    AGridManager* GridManager = GetGridManager();
 
     if (GridManager)
     {
         // 向 GridManager 请求预定目标格子
-        if (!GridManager->ReserveGrid(OwnerCharacter, CurrentTargetGrid))
+        if (!GridManager->ReserveFootprint(OwnerCharacter, CurrentTargetGrid, FootprintSize))
         {
             UE_LOG(LogTemp, Warning, TEXT("Grid (%d, %d) is reserved. Cannot move."), TargetX, TargetY);
             return false;
@@ -135,23 +184,28 @@ bool UGridMovementComponent::TryMoveOneStep(int32 DeltaX, int32 DeltaY)
     }
 
     // 转换为目标世界坐标
-    FVector TargetWorld = GridToWorld(TargetX, TargetY);
+    FVector TargetWorld = FootprintToWorld(CurrentTargetGrid);
 
-    // 检查目标格子是否可行走（使用简化检测）
-    if (!IsGridWalkableSimple(TargetX, TargetY))
+    // 检查目标格子是否可行走（GridCell 代理运行时会被合并销毁，优先查 GridManager；多格角色查净空图）
+    const bool bTargetWalkable = GridManager
+        ? GridManager->CanFootprintStandAt(CurrentTargetGrid, FootprintSize)
+        : IsGridWalkableSimple(TargetX, TargetY);
+    if (!bTargetWalkable)
     {
         UE_LOG(LogTemp, Verbose, TEXT("Target grid is blocked."));
-        if (GridManager) GridManager->ReleaseGrid(CurrentTargetGrid);
+        if (GridManager) GridManager->ReleaseFootprintIfOwner(OwnerCharacter, CurrentTargetGrid, FootprintSize);
         return false;
     }
 
     // 检查目标格子是否被其他角色占据
-    AActor* OccupyingActor = GetActorAtGridSimple(TargetX, TargetY);
+    AActor* OccupyingActor = (GridManager && FootprintSize > 1)
+        ? GridManager->GetActorInFootprint(CurrentTargetGrid, FootprintSize, GetOwner())
+        : GetActorAtGridSimple(TargetX, TargetY);
     if (OccupyingActor && OccupyingActor != GetOwner())
     {
         UE_LOG(LogTemp, Warning, TEXT("Grid (%d, %d) is occupied by %s. Cannot move."),
             TargetX, TargetY, *OccupyingActor->GetName());
-        if (GridManager) GridManager->ReleaseGrid(CurrentTargetGrid);
+        if (GridManager) GridManager->ReleaseFootprintIfOwner(OwnerCharacter, CurrentTargetGrid, FootprintSize);
         return false;
     }
 
@@ -163,6 +217,9 @@ bool UGridMovementComponent::TryMoveOneStep(int32 DeltaX, int32 DeltaY)
     CurrentState = EMovementState::Moving;
     TargetRotation = UKismetMathLibrary::MakeRotFromX(FVector(DeltaX, DeltaY, 0));
 
+    // 步进被接受即提交逻辑格子
+    CommitOccupiedGrid(CurrentTargetGrid);
+
     return true;
 }
 
@@ -188,13 +245,16 @@ void UGridMovementComponent::ExecuteDisplacementPath(const TArray<FIntPoint>& Pa
     DisplacementWorldPath.Empty();
     for (const FIntPoint& Grid : Path)
     {
-        FVector WorldPos = GridToWorld(Grid.X, Grid.Y);
+        FVector WorldPos = FootprintToWorld(Grid);
         DisplacementWorldPath.Add(WorldPos);
     }
 
-    // 修复：重置高度参数为 0（Dash 不需要改变高度）
+    // 位移开始即提交终点格子
+    CommitOccupiedGrid(Path.Last());
+
+    // 修复：重置高度参数为 0（Dash 不需要改变高度），终点只跟随地形高度差
     DisplacementStartHeight = 0.0f;
-    DisplacementEndHeight = 0.0f;
+    DisplacementEndHeight = GetTerrainHeightDelta(Path[0], Path.Last());
     DisplacementArcHeight = 0.0f;
 
     // 初始化位移状态
@@ -226,6 +286,11 @@ void UGridMovementComponent::StopDisplacement()
         DisplacementWorldPath.Empty();
         DisplacementElapsedTime = 0.0f;
 
+        // 中途停止时，逻辑格子回退到实际所在格子
+        int32 StopX, StopY;
+        GetCurrentGrid(StopX, StopY);
+        CommitOccupiedGrid(FIntPoint(StopX, StopY));
+
         UE_LOG(LogTemp, Log, TEXT("Displacement stopped manually"));
     }
 }
@@ -251,12 +316,10 @@ void UGridMovementComponent::HandleMovement(float DeltaTime)
         CurrentState = EMovementState::Idle;
 
         // 释放网格预定
-        AGridManager* GridManager = Cast<AGridManager>(
-            UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass())
-        );
+        AGridManager* GridManager = GetGridManager();
         if (GridManager)
         {
-            GridManager->ReleaseGrid(CurrentTargetGrid);
+            GridManager->ReleaseFootprintIfOwner(OwnerCharacter, CurrentTargetGrid, FootprintSize);
         }
     }
     else
@@ -343,33 +406,9 @@ void UGridMovementComponent::HandleDisplacementMovement(float DeltaTime)
 
 FRotator UGridMovementComponent::SnapRotationToFourDirections(const FRotator& Rotation)
 {
-    float Yaw = Rotation.Yaw;
-
-    // 规范化到 [0, 360)
-    while (Yaw < 0.0f) Yaw += 360.0f;
-    while (Yaw >= 360.0f) Yaw -= 360.0f;
-
     // 对齐到最接近的四个方向（0°, 90°, 180°, 270°）
-    float SnappedYaw;
-
-    if (Yaw >= 315.0f || Yaw < 45.0f)
-    {
-        SnappedYaw = 0.0f;   // 东
-    }
-    else if (Yaw >= 45.0f && Yaw < 135.0f)
-    {
-        SnappedYaw = 90.0f;  // 北
-    }
-    else if (Yaw >= 135.0f && Yaw < 225.0f)
-    {
-        SnappedYaw = 180.0f; // 西
-    }
-    else
-    {
-        SnappedYaw = 270.0f; // 南
-    }
-
-    return FRotator(0.0f, SnappedYaw, 0.0f);
+    const int32 DirectionIndex = FGridTopology4::DirectionIndexFromYaw(Rotation.Yaw);
+    return FRotator(0.0f, FGridTopology4::GetDirectionYaw(DirectionIndex), 0.0f);
 }
 
 void UGridMovementComponent::ExecuteDisplacementPathWithHeight(
@@ -395,13 +434,16 @@ void UGridMovementComponent::ExecuteDisplacementPathWithHeight(
     DisplacementWorldPath.Empty();
     for (const FIntPoint& Grid : Path)
     {
-        FVector WorldPos = GridToWorld(Grid.X, Grid.Y);
+        FVector WorldPos = FootprintToWorld(Grid);
         DisplacementWorldPath.Add(WorldPos);
     }
 
+    // 位移开始即提交终点格子
+    CommitOccupiedGrid(Path.Last());
+
     // 保存高度参数
     DisplacementStartHeight = StartHeightOffset;
-    DisplacementEndHeight = EndHeightOffset;
+    DisplacementEndHeight = EndHeightOffset + GetTerrainHeightDelta(Path[0], Path.Last());
     DisplacementArcHeight = ArcPeakHeight;
 
     // 初始化位移状态
@@ -470,6 +512,19 @@ AActor* UGridMovementComponent::GetActorAtGridSimple(int32 GridX, int32 GridY) c
 {
     if (!GetWorld()) return nullptr;
 
+    // 优先使用 GridManager 的占位索引
+    if (AGridManager* GridManager = GetGridManager())
+    {
+        for (AActor* Actor : GridManager->GetActorsAtGrid(FIntPoint(GridX, GridY)))
+        {
+            if (Actor != GetOwner())
+            {
+                return Actor;
+            }
+        }
+        return nullptr;
+    }
+
     FVector CheckPos = GridToWorld(GridX, GridY);
     TArray<AActor*> ActorsToIgnore;
     ActorsToIgnore.Add(GetOwner());
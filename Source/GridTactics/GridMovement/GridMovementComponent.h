@@ -88,8 +88,17 @@ public:
     UFUNCTION(BlueprintPure, Category = "Grid Movement")
     static FRotator SnapRotationToFourDirections(const FRotator& Rotation);
 
+    /** 提交角色的逻辑格子（更新 GridManager 占位索引，瞬移等直接设置位置的逻辑需调用） */
+    UFUNCTION(BlueprintCallable, Category = "Grid Movement")
+    void CommitOccupiedGrid(FIntPoint NewGrid);
+
+    /** 占地边长（K x K），角色位置位于占地区域中心，逻辑格子为区域的最小角 */
+    UFUNCTION(BlueprintPure, Category = "Grid Movement")
+    int32 GetFootprintSize() const { return FootprintSize; }
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
     UPROPERTY()
@@ -120,6 +129,22 @@ private:
     UPROPERTY(EditDefaultsOnly, Category = "Movement")
     float GridSizeCM = 100.0f;
 
+    // 占地边长：1 为普通单格角色，Boss 可设为 2 / 3
+    UPROPERTY(EditDefaultsOnly, Category = "Movement", meta = (ClampMin = "1", ClampMax = "8"))
+    int32 FootprintSize = 1;
+
+    // 占地区域中心相对最小角格子中心的偏移
+    FVector GetFootprintCenterOffset() const;
+
+    // 以 Anchor 为最小角的占地区域中心的世界坐标
+    FVector FootprintToWorld(FIntPoint Anchor) const;
+
+    // 通过 GridTacticsWorldSubsystem 获取 GridManager
+    AGridManager* GetGridManager() const;
+
+    // 两个格子的地面高度差（高度层），没有 GridManager 时为 0
+    float GetTerrainHeightDelta(FIntPoint From, FIntPoint To) const;
+
     // Tick处理函数
     void HandleMovement(float DeltaTime);
     void HandleDisplacementMovement(float DeltaTime);
@@ -0,0 +1,112 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridObstacleDistance.h"
+#include "GridBitboard.h"
+
+void FGridObstacleDistance::Init(FIntPoint InMin, FIntPoint InSize)
+{
+    Min = InMin;
+    Size = FIntPoint(FMath::Max(InSize.X, 0), FMath::Max(InSize.Y, 0));
+    for (TArray<uint16>& Table : Distances)
+    {
+        Table.SetNumZeroed(Size.X * Size.Y);
+    }
+    DirtyRows.Init(true, Size.Y);
+    DirtyColumns.Init(true, Size.X);
+    bAnyDirty = Size.X > 0 && Size.Y > 0;
+}
+
+void FGridObstacleDistance::MarkDirty(FIntPoint Grid)
+{
+    const FIntPoint Local = Grid - Min;
+    if (Local.X < 0 || Local.Y < 0 || Local.X >= Size.X || Local.Y >= Size.Y)
+    {
+        return;
+    }
+    DirtyRows[Local.Y] = true;
+    DirtyColumns[Local.X] = true;
+    bAnyDirty = true;
+}
+
+void FGridObstacleDistance::Update(const FGridBitboard& Source, bool bBlockedWhenSet)
+{
+    if (!bAnyDirty)
+    {
+        return;
+    }
+
+    auto IsOpen = [&](int32 X, int32 Y)
+    {
+        return Source.TestBit(Min + FIntPoint(X, Y)) != bBlockedWhenSet;
+    };
+    auto Extend = [](uint16 Next) -> uint16
+    {
+        return Next < MAX_uint16 ? static_cast<uint16>(Next + 1) : MAX_uint16;
+    };
+
+    // 方向下标与 FGridTopology4 一致：0 东 (X+)，1 北 (Y+)，2 西 (X-)，3 南 (Y-)
+    uint16* East = Distances[0].GetData();
+    uint16* North = Distances[1].GetData();
+    uint16* West = Distances[2].GetData();
+    uint16* South = Distances[3].GetData();
+
+    for (TConstSetBitIterator<> It(DirtyRows); It; ++It)
+    {
+        const int32 Y = It.GetIndex();
+        const int32 Row = Y * Size.X;
+        East[Row + Size.X - 1] = 0;
+        for (int32 X = Size.X - 2; X >= 0; --X)
+        {
+            East[Row + X] = IsOpen(X + 1, Y) ? Extend(East[Row + X + 1]) : 0;
+        }
+        West[Row] = 0;
+        for (int32 X = 1; X < Size.X; ++X)
+        {
+            West[Row + X] = IsOpen(X - 1, Y) ? Extend(West[Row + X - 1]) : 0;
+        }
+    }
+
+    for (TConstSetBitIterator<> It(DirtyColumns); It; ++It)
+    {
+        const int32 X = It.GetIndex();
+        North[(Size.Y - 1) * Size.X + X] = 0;
+        for (int32 Y = Size.Y - 2; Y >= 0; --Y)
+        {
+            North[Y * Size.X + X] = IsOpen(X, Y + 1) ? Extend(North[(Y + 1) * Size.X + X]) : 0;
+        }
+        South[X] = 0;
+        for (int32 Y = 1; Y < Size.Y; ++Y)
+        {
+            South[Y * Size.X + X] = IsOpen(X, Y - 1) ? Extend(South[(Y - 1) * Size.X + X]) : 0;
+        }
+    }
+
+    DirtyRows.SetRange(0, Size.Y, false);
+    DirtyColumns.SetRange(0, Size.X, false);
+    bAnyDirty = false;
+}
+
+int32 FGridObstacleDistance::GetDistance(FIntPoint Grid, int32 DirectionIndex) const
+{
+    checkSlow(!bAnyDirty);
+
+    const FIntPoint Local = Grid - Min;
+    if (Local.X < 0 || Local.Y < 0 || Local.X >= Size.X || Local.Y >= Size.Y
+        || DirectionIndex < 0 || DirectionIndex >= FGridTopology4::NumDirections)
+    {
+        return 0;
+    }
+    return Distances[DirectionIndex][Local.Y * Size.X + Local.X];
+}
+
+int32 FGridObstacleDistance::GetDirectionIndex(FIntPoint Direction)
+{
+    for (int32 Index = 0; Index < FGridTopology4::NumDirections; ++Index)
+    {
+        if (FGridTopology4::GetDirection(Index) == Direction)
+        {
+            return Index;
+        }
+    }
+    return INDEX_NONE;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridTopology.h"
+
+struct FGridBitboard;
+
+/**
+ * 四方向障碍距离表（JPS+ 式）：每格记录沿东/北/西/南能连续经过多少个畅通格子（不含自身），直线位移的可达距离 O(1) 查出
+ * 格子变化只标记所在行（东西向）和列（南北向），下次 Update 时只重算这些行列
+ */
+struct GRIDTACTICS_API FGridObstacleDistance
+{
+    // 按包围盒分配，整表标记为脏
+    void Init(FIntPoint InMin, FIntPoint InSize);
+
+    void MarkDirty(FIntPoint Grid);
+    bool IsDirty() const { return bAnyDirty; }
+
+    // 从 Source 重算脏行列；bBlockedWhenSet 为 true 时置位格子是障碍（占位），否则未置位格子是障碍（可行走）
+    void Update(const FGridBitboard& Source, bool bBlockedWhenSet);
+
+    // 从 Grid 沿 FGridTopology4 第 DirectionIndex 个方向的畅通格数，包围盒外返回 0；调用前需 Update
+    int32 GetDistance(FIntPoint Grid, int32 DirectionIndex) const;
+
+    // 四方向单位向量对应的方向下标，其他向量返回 INDEX_NONE
+    static int32 GetDirectionIndex(FIntPoint Direction);
+
+private:
+    FIntPoint Min = FIntPoint::ZeroValue;
+    FIntPoint Size = FIntPoint::ZeroValue;
+
+    // 每个方向一张行优先表，超过 uint16 上限时截断
+    TArray<uint16> Distances[FGridTopology4::NumDirections];
+
+    TBitArray<> DirtyRows;
+    TBitArray<> DirtyColumns;
+    bool bAnyDirty = false;
+};
\ No newline at end of file
@@ -0,0 +1,513 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridPathService.h"
+#include "GridAStar.h"
+#include "GridManager.h"
+#include "GridTactics/GridTactics.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+
+DECLARE_CYCLE_STAT(TEXT("Path Service Tick"), STAT_GridPathServiceTick, STATGROUP_GridTactics);
+DECLARE_CYCLE_STAT(TEXT("Async Path Solve"), STAT_GridPathAsyncSolve, STATGROUP_GridTactics);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Queue Depth"), STAT_GridPathQueueDepth, STATGROUP_GridTactics);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Paths In Flight"), STAT_GridPathInFlight, STATGROUP_GridTactics);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Path Latency (ms)"), STAT_GridPathLatency, STATGROUP_GridTactics);
+
+UGridPathService* UGridPathService::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    const UWorld* World = WorldContextObject->GetWorld();
+    return World ? World->GetSubsystem<UGridPathService>() : nullptr;
+}
+
+FGridPathRequestHandle UGridPathService::RequestPath(
+    FIntPoint StartGrid,
+    FIntPoint GoalGrid,
+    const FGridPathConstraints& Constraints,
+    EGridPathPriority Priority,
+    FOnGridPathSolved OnSolved)
+{
+    return EnqueueRequest(StartGrid, GoalGrid, Constraints, Priority, MoveTemp(OnSolved), FOnGridPathSolvedDynamic());
+}
+
+FGridPathRequestHandle UGridPathService::RequestPathAsync(
+    FIntPoint StartGrid,
+    FIntPoint GoalGrid,
+    const FGridPathConstraints& Constraints,
+    EGridPathPriority Priority,
+    FOnGridPathSolvedDynamic OnSolved)
+{
+    return EnqueueRequest(StartGrid, GoalGrid, Constraints, Priority, FOnGridPathSolved(), MoveTemp(OnSolved));
+}
+
+bool UGridPathService::CancelRequest(FGridPathRequestHandle Handle)
+{
+    if (Requests.Remove(Handle.Id) > 0)
+    {
+        Queue.Remove(Handle.Id);
+        return true;
+    }
+    return CompletedResults.Remove(Handle.Id) > 0;
+}
+
+bool UGridPathService::TryGetResult(FGridPathRequestHandle Handle, FGridPathResult& OutResult)
+{
+    FCompletedResult Completed;
+    if (!CompletedResults.RemoveAndCopyValue(Handle.Id, Completed))
+    {
+        return false;
+    }
+    OutResult = MoveTemp(Completed.Result);
+    return true;
+}
+
+bool UGridPathService::IsRequestPending(FGridPathRequestHandle Handle) const
+{
+    return Requests.Contains(Handle.Id);
+}
+
+void UGridPathService::SetFrameBudget(float InFrameBudgetMs, int32 InMaxRequestsPerFrame)
+{
+    FrameBudgetMs = FMath::Max(InFrameBudgetMs, 0.0f);
+    MaxRequestsPerFrame = FMath::Max(InMaxRequestsPerFrame, 1);
+}
+
+FGridPathResult UGridPathService::SolveOnSnapshot(const FGridPathSnapshot& Snapshot, FIntPoint StartGrid, FIntPoint GoalGrid,
+    const FGridPathConstraints& Constraints, int32 FootprintSize, FIntPoint IgnoreAnchor, int32 IgnoreFootprintSize)
+{
+    SCOPE_CYCLE_COUNTER(STAT_GridPathAsyncSolve);
+
+    FGridPathResult Result;
+    if (!Snapshot.Terrain.IsValid())
+    {
+        return Result;
+    }
+    const FGridPathSnapshot::FTerrain& Terrain = *Snapshot.Terrain;
+
+    // 占地范围内有不属于寻路角色自身的占位
+    auto IsOccupiedByOthers = [&](FIntPoint Anchor)
+    {
+        for (int32 Y = 0; Y < FootprintSize; ++Y)
+        {
+            for (int32 X = 0; X < FootprintSize; ++X)
+            {
+                const FIntPoint Cell = Anchor + FIntPoint(X, Y);
+                if (!Snapshot.Occupancy.TestBit(Cell))
+                {
+                    continue;
+                }
+                const FIntPoint Own = Cell - IgnoreAnchor;
+                if (Own.X < 0 || Own.Y < 0 || Own.X >= IgnoreFootprintSize || Own.Y >= IgnoreFootprintSize)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    // 与 UPathPlanner::GetPathEnterCost 共用同一条规则，只是数据来自快照
+    auto GetEnterCost = [&](FIntPoint Grid)
+    {
+        int32 LocalIndex = 0;
+        const FGridPathSnapshot::FTerrainTile* Tile = Terrain.FindTile(Grid, LocalIndex);
+        return GetGridPathEnterCost(Constraints, Grid, GoalGrid,
+            [&]()
+            {
+                return Tile && Tile->MoveCosts[LocalIndex] > 0
+                    && (FootprintSize <= 1 || Tile->Clearance[LocalIndex] >= FootprintSize);
+            },
+            [&]() { return (int32)Tile->MoveCosts[LocalIndex]; },
+            [&]() { return IsOccupiedByOthers(Grid); });
+    };
+
+    // 每个工作线程有自己的 FGridAStar 实例
+    FGridAStar& Search = FGridAStar::Get();
+    Result.bFound = Search.FindPath(Terrain.Min, Terrain.Size, StartGrid, GoalGrid, GetEnterCost,
+        Result.Path, Result.Cost, Constraints.MaxExpandedNodes);
+    Result.ExpandedNodes = Search.GetExpandedCount();
+
+    // 工作线程由所有 UE::Tasks 共享，大地图的节点数组不常驻
+    if (!IsInGameThread())
+    {
+        Search.Trim(FGridAStar::WorkerRetainedBytes);
+    }
+    return Result;
+}
+
+void UGridPathService::Deinitialize()
+{
+    // 求解中的任务只持有快照副本，不引用子系统，直接放弃结果即可
+    Requests.Reset();
+    Queue.Reset();
+    InFlight.Reset();
+    CompletedResults.Reset();
+    TerrainBuilder.Reset();
+
+    Super::Deinitialize();
+}
+
+void UGridPathService::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_GridPathServiceTick);
+
+    const double FrameStartTime = FPlatformTime::Seconds();
+    DeliverCompleted(FrameStartTime);
+    DispatchQueued(FrameStartTime);
+
+    // 丢弃长时间无人取走的结果
+    for (auto It = CompletedResults.CreateIterator(); It; ++It)
+    {
+        if (GFrameCounter - It->Value.CompletedFrame > ResultRetentionFrames)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    SET_DWORD_STAT(STAT_GridPathQueueDepth, Queue.Num());
+    SET_DWORD_STAT(STAT_GridPathInFlight, InFlight.Num());
+    SET_FLOAT_STAT(STAT_GridPathLatency, AverageLatencyMs);
+}
+
+TStatId UGridPathService::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UGridPathService, STATGROUP_Tickables);
+}
+
+bool UGridPathService::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // 只在游戏和 PIE 世界中创建
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FGridPathRequestHandle UGridPathService::EnqueueRequest(FIntPoint StartGrid, FIntPoint GoalGrid, const FGridPathConstraints& Constraints,
+    EGridPathPriority Priority, FOnGridPathSolved&& OnSolved, FOnGridPathSolvedDynamic&& OnSolvedDynamic)
+{
+    FRequest Request;
+    Request.StartGrid = StartGrid;
+    Request.GoalGrid = GoalGrid;
+    Request.Constraints = Constraints;
+    Request.Priority = Priority;
+    Request.SubmitTime = FPlatformTime::Seconds();
+    Request.OnSolved = MoveTemp(OnSolved);
+    Request.OnSolvedDynamic = MoveTemp(OnSolvedDynamic);
+
+    // 角色的占地在提交时解析，工作线程只拿到坐标
+    const AGridManager* GridManager = UGridTacticsWorldSubsystem::GetGridManagerFor(this);
+    AActor* IgnoreActor = Constraints.IgnoreActor;
+    if (GridManager && IgnoreActor)
+    {
+        Request.FootprintSize = GridManager->GetActorFootprintSize(IgnoreActor);
+        if (!GridManager->GetActorFootprint(IgnoreActor, Request.IgnoreAnchor, Request.IgnoreFootprintSize))
+        {
+            Request.IgnoreFootprintSize = 0;
+        }
+    }
+    Request.Constraints.IgnoreActor = nullptr;
+
+    FGridPathRequestHandle Handle;
+    Handle.Id = NextRequestId++;
+    if (NextRequestId <= 0)
+    {
+        NextRequestId = 1;
+    }
+
+    Requests.Add(Handle.Id, MoveTemp(Request));
+    Queue.Add(Handle.Id);
+    return Handle;
+}
+
+void UGridPathService::DeliverCompleted(double FrameStartTime)
+{
+    const double BudgetSeconds = FrameBudgetMs / 1000.0;
+    int32 NumDelivered = 0;
+    for (int32 Index = 0; Index < InFlight.Num();)
+    {
+        if (!InFlight[Index].Task.IsCompleted())
+        {
+            ++Index;
+            continue;
+        }
+        if (NumDelivered > 0 && FPlatformTime::Seconds() - FrameStartTime > BudgetSeconds)
+        {
+            break;
+        }
+
+        // 先移出再回调：回调里可能提交或取消请求
+        const int32 Id = InFlight[Index].Id;
+        const FGridPathResult Result = InFlight[Index].Task.GetResult();
+        InFlight.RemoveAt(Index);
+        Deliver(Id, Result);
+        ++NumDelivered;
+    }
+}
+
+void UGridPathService::DispatchQueued(double FrameStartTime)
+{
+    if (Queue.Num() == 0)
+    {
+        return;
+    }
+
+    // GridManager 尚未注册时请求继续排队
+    const AGridManager* GridManager = UGridTacticsWorldSubsystem::GetGridManagerFor(this);
+    if (!GridManager)
+    {
+        return;
+    }
+
+    // 高优先级在前，同优先级保持提交顺序
+    Queue.StableSort([this](int32 A, int32 B)
+    {
+        return Requests[A].Priority > Requests[B].Priority;
+    });
+
+    // 本帧派发的请求共享同一份快照；地形修补超出本帧预算时整批留到下一帧
+    const TSharedPtr<const FGridPathSnapshot> Snapshot = MakeSnapshot(GridManager, FrameStartTime);
+    if (!Snapshot.IsValid())
+    {
+        return;
+    }
+    const double BudgetSeconds = FrameBudgetMs / 1000.0;
+    int32 NumDispatched = 0;
+    while (NumDispatched < Queue.Num() && NumDispatched < MaxRequestsPerFrame)
+    {
+        if (NumDispatched > 0 && FPlatformTime::Seconds() - FrameStartTime > BudgetSeconds)
+        {
+            break;
+        }
+
+        const int32 Id = Queue[NumDispatched++];
+        const FRequest& Request = Requests[Id];
+        FInFlightRequest& Entry = InFlight.AddDefaulted_GetRef();
+        Entry.Id = Id;
+        Entry.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+            [Snapshot, StartGrid = Request.StartGrid, GoalGrid = Request.GoalGrid, Constraints = Request.Constraints,
+            FootprintSize = Request.FootprintSize, IgnoreAnchor = Request.IgnoreAnchor, IgnoreFootprintSize = Request.IgnoreFootprintSize]()
+            {
+                return SolveOnSnapshot(*Snapshot, StartGrid, GoalGrid, Constraints, FootprintSize, IgnoreAnchor, IgnoreFootprintSize);
+            });
+    }
+    Queue.RemoveAt(0, NumDispatched, EAllowShrinking::No);
+}
+
+void UGridPathService::Deliver(int32 Id, const FGridPathResult& Result)
+{
+    // 已取消的请求不再交付
+    FRequest Request;
+    if (!Requests.RemoveAndCopyValue(Id, Request))
+    {
+        return;
+    }
+
+    const float LatencyMs = (float)((FPlatformTime::Seconds() - Request.SubmitTime) * 1000.0);
+    AverageLatencyMs = AverageLatencyMs > 0.0f ? FMath::Lerp(AverageLatencyMs, LatencyMs, 0.1f) : LatencyMs;
+
+    FGridPathRequestHandle Handle;
+    Handle.Id = Id;
+    if (Request.OnSolved.IsBound())
+    {
+        Request.OnSolved.Execute(Handle, Result);
+    }
+    else if (Request.OnSolvedDynamic.IsBound())
+    {
+        Request.OnSolvedDynamic.Execute(Handle, Result);
+    }
+    else
+    {
+        FCompletedResult& Completed = CompletedResults.Add(Id);
+        Completed.Result = Result;
+        Completed.CompletedFrame = GFrameCounter;
+    }
+}
+
+TSharedPtr<const FGridPathSnapshot> UGridPathService::MakeSnapshot(const AGridManager* GridManager, double FrameStartTime)
+{
+    if (!TerrainBuilder.Update(GridManager, FrameStartTime + FrameBudgetMs / 1000.0))
+    {
+        return nullptr;
+    }
+
+    TSharedRef<FGridPathSnapshot> Snapshot = MakeShared<FGridPathSnapshot>();
+    Snapshot->Terrain = TerrainBuilder.GetTerrain();
+    Snapshot->Occupancy = GridManager->GetOccupancyBoard();
+    return Snapshot;
+}
+
+bool FGridPathTerrainBuilder::Update(const AGridManager* GridManager, double DeadlineSeconds)
+{
+    const FGridPathSnapshot::FTerrain* Latest = PendingTerrain.IsValid() ? PendingTerrain.Get() : Terrain.Get();
+    if (!Latest || TerrainGridManager.Get() != GridManager || Latest->GridVersion != GridManager->GetGridVersion())
+    {
+        QueueChanges(GridManager);
+    }
+
+    int32 NumProcessed = 0;
+    while (PendingTileBuilds.Num() > 0 || PendingCellPatches.Num() > 0)
+    {
+        if (NumProcessed > 0 && FPlatformTime::Seconds() > DeadlineSeconds)
+        {
+            return false;
+        }
+
+        if (PendingTileBuilds.Num() > 0)
+        {
+            BuildTile(GridManager, PendingTileBuilds.Pop(EAllowShrinking::No));
+        }
+        else
+        {
+            PatchCell(GridManager, PendingCellPatches.Pop(EAllowShrinking::No));
+        }
+        ++NumProcessed;
+    }
+
+    if (PendingTerrain.IsValid())
+    {
+        Terrain = PendingTerrain;
+        PendingTerrain.Reset();
+        PendingOwnedTiles.Empty();
+    }
+    return true;
+}
+
+void FGridPathTerrainBuilder::Reset()
+{
+    Terrain.Reset();
+    TerrainGridManager.Reset();
+    PendingTerrain.Reset();
+    PendingOwnedTiles.Empty();
+    PendingTileBuilds.Empty();
+    PendingCellPatches.Empty();
+}
+
+void FGridPathTerrainBuilder::QueueChanges(const AGridManager* GridManager)
+{
+    using FTerrainTile = FGridPathSnapshot::FTerrainTile;
+
+    const FIntPoint Min = GridManager->GetGridBoundsMin();
+    const FIntPoint Size = GridManager->GetGridBoundsSize();
+
+    // 增量的基准：修补中的地形，否则为最近一份完整地形
+    const FGridPathSnapshot::FTerrain* Base = PendingTerrain.IsValid() ? PendingTerrain.Get() : Terrain.Get();
+    TArray<FIntPoint> ChangedGrids;
+    const bool bIncremental = Base && TerrainGridManager.Get() == GridManager && Base->Min == Min && Base->Size == Size
+        && GridManager->GetCellsChangedSince(Base->GridVersion, ChangedGrids);
+    TerrainGridManager = GridManager;
+
+    if (!bIncremental || !PendingTerrain.IsValid())
+    {
+        TSharedRef<FGridPathSnapshot::FTerrain> NewTerrain = MakeShared<FGridPathSnapshot::FTerrain>();
+        NewTerrain->Min = Min;
+        NewTerrain->Size = Size;
+        NewTerrain->NumTiles = FIntPoint(
+            FMath::DivideAndRoundUp(FMath::Max(Size.X, 0), FTerrainTile::TileSize),
+            FMath::DivideAndRoundUp(FMath::Max(Size.Y, 0), FTerrainTile::TileSize));
+
+        const int32 NumTiles = NewTerrain->NumTiles.X * NewTerrain->NumTiles.Y;
+        if (bIncremental)
+        {
+            // 先与上一份完整地形共享所有块，修补时再逐块复制
+            NewTerrain->Tiles = Terrain->Tiles;
+        }
+        else
+        {
+            NewTerrain->Tiles.SetNum(NumTiles);
+            PendingCellPatches.Reset();
+            PendingTileBuilds.Reset(NumTiles);
+            for (int32 TileIndex = NumTiles - 1; TileIndex >= 0; --TileIndex)
+            {
+                PendingTileBuilds.Add(TileIndex);
+            }
+        }
+        PendingOwnedTiles.Init(false, NumTiles);
+        PendingTerrain = NewTerrain;
+    }
+    PendingTerrain->GridVersion = GridManager->GetGridVersion();
+
+    // 同一格子可能变化多次，只修补一次
+    Algo::Sort(ChangedGrids, [](const FIntPoint& A, const FIntPoint& B)
+    {
+        return A.Y != B.Y ? A.Y < B.Y : A.X < B.X;
+    });
+    ChangedGrids.SetNum(Algo::Unique(ChangedGrids), EAllowShrinking::No);
+    PendingCellPatches.Append(ChangedGrids);
+}
+
+FGridPathSnapshot::FTerrainTile& FGridPathTerrainBuilder::GetWritableTile(int32 TileIndex)
+{
+    // 块可能仍被已发布的地形共享，第一次修改前复制
+    TSharedPtr<FGridPathSnapshot::FTerrainTile>& Tile = PendingTerrain->Tiles[TileIndex];
+    if (!PendingOwnedTiles[TileIndex])
+    {
+        Tile = Tile.IsValid()
+            ? MakeShared<FGridPathSnapshot::FTerrainTile>(*Tile)
+            : MakeShared<FGridPathSnapshot::FTerrainTile>();
+        PendingOwnedTiles[TileIndex] = true;
+    }
+    return *Tile;
+}
+
+void FGridPathTerrainBuilder::BuildTile(const AGridManager* GridManager, int32 TileIndex)
+{
+    using FTerrainTile = FGridPathSnapshot::FTerrainTile;
+
+    FTerrainTile& Tile = GetWritableTile(TileIndex);
+    const FGridPathSnapshot::FTerrain& Target = *PendingTerrain;
+    const FIntPoint TileMin = Target.Min
+        + FIntPoint(TileIndex % Target.NumTiles.X, TileIndex / Target.NumTiles.X) * FTerrainTile::TileSize;
+    const FIntPoint TileMax = (TileMin + FIntPoint(FTerrainTile::TileSize)).ComponentMin(Target.Min + Target.Size) - 1;
+
+    // 移动消耗按行整段读取
+    TArray<int32> MoveCosts;
+    GridManager->ReadLayerRect(EGridCellLayer::MoveCost, TileMin, TileMax, MoveCosts);
+
+    const FGridBitboard& Walkable = GridManager->GetWalkableBoard();
+    const int32 Width = TileMax.X - TileMin.X + 1;
+    for (int32 Y = TileMin.Y; Y <= TileMax.Y; ++Y)
+    {
+        for (int32 X = TileMin.X; X <= TileMax.X; ++X)
+        {
+            const FIntPoint Grid(X, Y);
+            const int32 LocalIndex = ((Y - TileMin.Y) << FTerrainTile::TileSizeLog2) + (X - TileMin.X);
+            const int32 MoveCost = MoveCosts[(Y - TileMin.Y) * Width + (X - TileMin.X)];
+            Tile.MoveCosts[LocalIndex] = Walkable.TestBit(Grid) ? (uint8)FMath::Clamp(MoveCost, 1, MAX_uint8) : 0;
+            Tile.Clearance[LocalIndex] = (uint8)GridManager->GetGridClearance(Grid);
+        }
+    }
+}
+
+void FGridPathTerrainBuilder::PatchCell(const AGridManager* GridManager, FIntPoint Grid)
+{
+    FGridPathSnapshot::FTerrain& Target = *PendingTerrain;
+
+    int32 LocalIndex = 0;
+    const int32 TileIndex = Target.GetTileIndex(Grid, LocalIndex);
+    if (TileIndex == INDEX_NONE)
+    {
+        return;
+    }
+    GetWritableTile(TileIndex).MoveCosts[LocalIndex] = GridManager->GetWalkableBoard().TestBit(Grid)
+        ? (uint8)FMath::Clamp(GridManager->GetGridLayerValue(Grid, EGridCellLayer::MoveCost), 1, MAX_uint8)
+        : 0;
+
+    // 净空以格子为最小角，本格的变化只影响 X、Y 都不大于它的 MaxClearance x MaxClearance 范围
+    for (int32 DY = 0; DY < FGridClearanceMap::MaxClearance; ++DY)
+    {
+        for (int32 DX = 0; DX < FGridClearanceMap::MaxClearance; ++DX)
+        {
+            const FIntPoint Anchor = Grid - FIntPoint(DX, DY);
+            const int32 AnchorTileIndex = Target.GetTileIndex(Anchor, LocalIndex);
+            if (AnchorTileIndex != INDEX_NONE)
+            {
+                GetWritableTile(AnchorTileIndex).Clearance[LocalIndex] = (uint8)GridManager->GetGridClearance(Anchor);
+            }
+        }
+    }
+}
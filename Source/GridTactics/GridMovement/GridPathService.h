@@ -0,0 +1,244 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "GridBitboard.h"
+#include "GridPathTypes.h"
+#include "GridPathService.generated.h"
+
+class AGridManager;
+
+/**
+ * 寻路用的只读网格快照：工作线程只读快照，不访问 GridManager
+ * 地形部分由 FGridPathTerrainBuilder 增量维护并在多批之间共享，占位位图每批拷贝一次
+ */
+struct GRIDTACTICS_API FGridPathSnapshot
+{
+    // 地形块（TileSize x TileSize），块内行优先
+    struct FTerrainTile
+    {
+        static constexpr int32 TileSizeLog2 = 5;
+        static constexpr int32 TileSize = 1 << TileSizeLog2;
+        static constexpr int32 TileMask = TileSize - 1;
+        static constexpr int32 NumCells = TileSize * TileSize;
+
+        // 进入格子的移动消耗（>= 1），0 为不可行走
+        TStaticArray<uint8, NumCells> MoveCosts;
+
+        // 与 AGridManager::GetGridClearance 相同
+        TStaticArray<uint8, NumCells> Clearance;
+
+        FTerrainTile()
+        {
+            FMemory::Memzero(MoveCosts.GetData(), NumCells);
+            FMemory::Memzero(Clearance.GetData(), NumCells);
+        }
+    };
+
+    struct FTerrain
+    {
+        FIntPoint Min = FIntPoint::ZeroValue;
+        FIntPoint Size = FIntPoint::ZeroValue;
+        FIntPoint NumTiles = FIntPoint::ZeroValue;
+        int32 GridVersion = INDEX_NONE;
+
+        // 行优先；未变化的块在前后两份地形之间共享，发布后不再修改
+        TArray<TSharedPtr<FTerrainTile>> Tiles;
+
+        // Grid 所在块的下标与块内下标，包围盒外返回 INDEX_NONE
+        int32 GetTileIndex(FIntPoint Grid, int32& OutLocalIndex) const
+        {
+            const FIntPoint Local = Grid - Min;
+            if (Local.X < 0 || Local.Y < 0 || Local.X >= Size.X || Local.Y >= Size.Y)
+            {
+                return INDEX_NONE;
+            }
+            OutLocalIndex = ((Local.Y & FTerrainTile::TileMask) << FTerrainTile::TileSizeLog2) | (Local.X & FTerrainTile::TileMask);
+            return (Local.Y >> FTerrainTile::TileSizeLog2) * NumTiles.X + (Local.X >> FTerrainTile::TileSizeLog2);
+        }
+
+        const FTerrainTile* FindTile(FIntPoint Grid, int32& OutLocalIndex) const
+        {
+            const int32 TileIndex = GetTileIndex(Grid, OutLocalIndex);
+            return TileIndex != INDEX_NONE ? Tiles[TileIndex].Get() : nullptr;
+        }
+    };
+
+    TSharedPtr<const FTerrain> Terrain;
+    FGridBitboard Occupancy;
+};
+
+/**
+ * 快照地形的增量维护（游戏线程）：格子版本号变化后按 AGridManager::GetCellsChangedSince 只修补变化的格子，
+ * 被修补的块先复制一份再改（写时复制），仍被求解中的任务持有的旧地形不受影响；布局变化或变化记录不完整时才整图重建
+ * 修补可以分多次 Update 完成，完成前 GetTerrain 仍返回上一份完整地形
+ */
+class GRIDTACTICS_API FGridPathTerrainBuilder
+{
+public:
+    // 把地形推进到 GridManager 的当前版本；每次至少处理一项，之后超过 DeadlineSeconds（FPlatformTime::Seconds）就停下
+    // 返回 true 表示 GetTerrain 已是当前版本
+    bool Update(const AGridManager* GridManager, double DeadlineSeconds);
+
+    // 最近一份完整的地形
+    const TSharedPtr<const FGridPathSnapshot::FTerrain>& GetTerrain() const { return Terrain; }
+
+    bool IsUpdatePending() const { return PendingTerrain.IsValid(); }
+
+    void Reset();
+
+private:
+    TSharedPtr<const FGridPathSnapshot::FTerrain> Terrain;
+    TWeakObjectPtr<const AGridManager> TerrainGridManager;
+
+    // 修补中的地形，PendingOwnedTiles 为本次已复制、可以原地修改的块
+    TSharedPtr<FGridPathSnapshot::FTerrain> PendingTerrain;
+    TBitArray<> PendingOwnedTiles;
+
+    // 待整块构建的块与待修补的格子（整图重建时只有前者）
+    TArray<int32> PendingTileBuilds;
+    TArray<FIntPoint> PendingCellPatches;
+
+    // 把 GridManager 当前版本之前的变化加入待处理列表
+    void QueueChanges(const AGridManager* GridManager);
+    FGridPathSnapshot::FTerrainTile& GetWritableTile(int32 TileIndex);
+    void BuildTile(const AGridManager* GridManager, int32 TileIndex);
+    void PatchCell(const AGridManager* GridManager, FIntPoint Grid);
+};
+
+/**
+ * 异步寻路服务：调用方提交请求得到句柄，完成后在游戏线程回调（或用句柄轮询结果）
+ * 每帧按优先级取出一批请求，基于同一份网格快照派发到 UE::Tasks 工作线程求解；
+ * 交付结果、快照地形修补与派发都受每帧时间预算约束，超出部分顺延到下一帧
+ */
+UCLASS()
+class GRIDTACTICS_API UGridPathService : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    static UGridPathService* Get(const UObject* WorldContextObject);
+
+    // 提交请求；OnSolved 未绑定时结果保留到 TryGetResult 取走（或超过保留帧数后丢弃）
+    FGridPathRequestHandle RequestPath(
+        FIntPoint StartGrid,
+        FIntPoint GoalGrid,
+        const FGridPathConstraints& Constraints,
+        EGridPathPriority Priority = EGridPathPriority::Normal,
+        FOnGridPathSolved OnSolved = FOnGridPathSolved()
+    );
+
+    UFUNCTION(BlueprintCallable, Category = "Grid|PathService", meta = (AutoCreateRefTerm = "Constraints"))
+    FGridPathRequestHandle RequestPathAsync(
+        FIntPoint StartGrid,
+        FIntPoint GoalGrid,
+        const FGridPathConstraints& Constraints,
+        EGridPathPriority Priority,
+        FOnGridPathSolvedDynamic OnSolved
+    );
+
+    // 取消排队中或求解中的请求（求解中的结果完成后直接丢弃），也会丢弃未取走的结果
+    UFUNCTION(BlueprintCallable, Category = "Grid|PathService")
+    bool CancelRequest(FGridPathRequestHandle Handle);
+
+    // 取走已完成的结果（只对未绑定回调的请求有效）
+    UFUNCTION(BlueprintCallable, Category = "Grid|PathService")
+    bool TryGetResult(FGridPathRequestHandle Handle, FGridPathResult& OutResult);
+
+    // 排队中或求解中
+    UFUNCTION(BlueprintPure, Category = "Grid|PathService")
+    bool IsRequestPending(FGridPathRequestHandle Handle) const;
+
+    // 每帧游戏线程上交付、快照地形修补与派发共用的时间预算（毫秒），以及每帧最多派发的请求数
+    UFUNCTION(BlueprintCallable, Category = "Grid|PathService")
+    void SetFrameBudget(float InFrameBudgetMs, int32 InMaxRequestsPerFrame);
+
+    UFUNCTION(BlueprintPure, Category = "Grid|PathService")
+    int32 GetQueueDepth() const { return Queue.Num(); }
+
+    UFUNCTION(BlueprintPure, Category = "Grid|PathService")
+    int32 GetInFlightCount() const { return InFlight.Num(); }
+
+    // 从提交到交付的平均延迟（指数滑动平均）
+    UFUNCTION(BlueprintPure, Category = "Grid|PathService")
+    float GetAverageLatencyMs() const { return AverageLatencyMs; }
+
+    // 在快照上求解，规则与 UPathPlanner::FindPath 相同（占位只看位图）；工作线程调用
+    static FGridPathResult SolveOnSnapshot(const FGridPathSnapshot& Snapshot, FIntPoint StartGrid, FIntPoint GoalGrid,
+        const FGridPathConstraints& Constraints, int32 FootprintSize, FIntPoint IgnoreAnchor, int32 IgnoreFootprintSize);
+
+    // --- USubsystem / FTickableGameObject ---
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    struct FRequest
+    {
+        FIntPoint StartGrid = FIntPoint::ZeroValue;
+        FIntPoint GoalGrid = FIntPoint::ZeroValue;
+
+        // IgnoreActor 只在游戏线程解析成占地范围，不带到工作线程
+        FGridPathConstraints Constraints;
+        int32 FootprintSize = 1;
+        FIntPoint IgnoreAnchor = FIntPoint::ZeroValue;
+        int32 IgnoreFootprintSize = 0;
+
+        EGridPathPriority Priority = EGridPathPriority::Normal;
+        double SubmitTime = 0.0;
+        FOnGridPathSolved OnSolved;
+        FOnGridPathSolvedDynamic OnSolvedDynamic;
+    };
+
+    struct FInFlightRequest
+    {
+        int32 Id = 0;
+        UE::Tasks::TTask<FGridPathResult> Task;
+    };
+
+    struct FCompletedResult
+    {
+        FGridPathResult Result;
+        uint64 CompletedFrame = 0;
+    };
+
+    // 未绑定回调的结果最多保留的帧数
+    static constexpr uint64 ResultRetentionFrames = 120;
+
+    float FrameBudgetMs = 1.0f;
+    int32 MaxRequestsPerFrame = 64;
+
+    int32 NextRequestId = 1;
+
+    // 尚未交付的请求（排队中与求解中）
+    TMap<int32, FRequest> Requests;
+
+    // 排队中的请求编号，按提交顺序
+    TArray<int32> Queue;
+
+    // 求解中的请求，按派发顺序
+    TArray<FInFlightRequest> InFlight;
+
+    TMap<int32, FCompletedResult> CompletedResults;
+
+    FGridPathTerrainBuilder TerrainBuilder;
+
+    float AverageLatencyMs = 0.0f;
+
+    FGridPathRequestHandle EnqueueRequest(FIntPoint StartGrid, FIntPoint GoalGrid, const FGridPathConstraints& Constraints,
+        EGridPathPriority Priority, FOnGridPathSolved&& OnSolved, FOnGridPathSolvedDynamic&& OnSolvedDynamic);
+
+    // 交付与派发都至少处理一个，之后超出 FrameBudgetMs 就留到下一帧
+    void DeliverCompleted(double FrameStartTime);
+    void DispatchQueued(double FrameStartTime);
+    void Deliver(int32 Id, const FGridPathResult& Result);
+
+    // 地形修补计入本帧预算，未完成时返回 nullptr，请求留到下一帧派发
+    TSharedPtr<const FGridPathSnapshot> MakeSnapshot(const AGridManager* GridManager, double FrameStartTime);
+};
\ No newline at end of file
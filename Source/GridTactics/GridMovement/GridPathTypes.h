@@ -0,0 +1,133 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridPathTypes.generated.h"
+
+// 寻路约束
+USTRUCT(BlueprintType)
+struct GRIDTACTICS_API FGridPathConstraints
+{
+    GENERATED_BODY()
+
+    // 按移动消耗层计算代价，关闭时每步代价为 1
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Path")
+    bool bUseMoveCost = true;
+
+    // 被其他角色占据的格子视为障碍
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Path")
+    bool bAvoidOccupied = true;
+
+    // 终点被占据时仍规划到终点（追击目标时终点上就是目标本身）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Path")
+    bool bAllowOccupiedGoal = true;
+
+    // 寻路的角色本身（不算占位障碍，多格角色按其登记的占地边长寻路）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Path")
+    TObjectPtr<AActor> IgnoreActor = nullptr;
+
+    // 最多扩展的节点数（0 = 不限制），超出时视为找不到路径
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Path", meta = (ClampMin = "0"))
+    int32 MaxExpandedNodes = 0;
+};
+
+// 进入格子的代价规则：不可站立或被其他角色占据返回 0，否则按约束取移动消耗（至少为 1）或 1
+// UPathPlanner::GetPathEnterCost（读 GridManager）与 UGridPathService::SolveOnSnapshot（读快照）都只通过这里判断，规则只在一处维护
+// 三个谓词按需调用：CanStand() 占地范围可站立，GetMoveCost() 移动消耗层的值，IsOccupiedByOthers() 占地范围内有寻路角色以外的占位
+template<typename CanStandType, typename GetMoveCostType, typename IsOccupiedType>
+int32 GetGridPathEnterCost(const FGridPathConstraints& Constraints, FIntPoint Grid, FIntPoint GoalGrid,
+    CanStandType&& CanStand, GetMoveCostType&& GetMoveCost, IsOccupiedType&& IsOccupiedByOthers)
+{
+    if (!CanStand())
+    {
+        return 0;
+    }
+    if (Constraints.bAvoidOccupied && !(Constraints.bAllowOccupiedGoal && Grid == GoalGrid) && IsOccupiedByOthers())
+    {
+        return 0;
+    }
+    return Constraints.bUseMoveCost ? FMath::Max(GetMoveCost(), 1) : 1;
+}
+
+// 寻路结果
+USTRUCT(BlueprintType)
+struct GRIDTACTICS_API FGridPathResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    bool bFound = false;
+
+    // 包含起点与终点
+    UPROPERTY(BlueprintReadOnly)
+    TArray<FIntPoint> Path;
+
+    // 路径总代价（不含起点）
+    UPROPERTY(BlueprintReadOnly)
+    int32 Cost = 0;
+
+    // 本次查询扩展的节点数
+    UPROPERTY(BlueprintReadOnly)
+    int32 ExpandedNodes = 0;
+};
+
+// 分层寻路结果：抽象路径一次算出，逐格路径按段细化
+USTRUCT(BlueprintType)
+struct GRIDTACTICS_API FGridHierarchicalPath
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    bool bFound = false;
+
+    // 起点、经过的簇入口、终点
+    UPROPERTY(BlueprintReadOnly)
+    TArray<FIntPoint> AbstractPath;
+
+    // 已细化的逐格路径（包含起点）
+    UPROPERTY(BlueprintReadOnly)
+    TArray<FIntPoint> Path;
+
+    // 下一段待细化的抽象路径下标（AbstractPath[NextSegment] -> AbstractPath[NextSegment + 1]）
+    UPROPERTY(BlueprintReadOnly)
+    int32 NextSegment = 0;
+
+    // 抽象层算出的完整路径步数（细化段按移动消耗或占位绕行时实际步数可能更多）
+    UPROPERTY(BlueprintReadOnly)
+    int32 Cost = 0;
+
+    // 抽象搜索扩展的节点数
+    UPROPERTY(BlueprintReadOnly)
+    int32 ExpandedNodes = 0;
+
+    bool IsFullyRefined() const { return NextSegment >= AbstractPath.Num() - 1; }
+};
+
+// 异步寻路请求的优先级，同一帧内高优先级先派发
+UENUM(BlueprintType)
+enum class EGridPathPriority : uint8
+{
+    Low,
+    Normal,
+    High
+};
+
+// 异步寻路请求句柄（UGridPathService 分配，0 为无效）
+USTRUCT(BlueprintType)
+struct GRIDTACTICS_API FGridPathRequestHandle
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 Id = 0;
+
+    bool IsValid() const { return Id != 0; }
+    void Invalidate() { Id = 0; }
+
+    bool operator==(const FGridPathRequestHandle& Other) const { return Id == Other.Id; }
+};
+
+// 异步寻路完成回调（游戏线程）
+DECLARE_DELEGATE_TwoParams(FOnGridPathSolved, FGridPathRequestHandle, const FGridPathResult&);
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnGridPathSolvedDynamic, FGridPathRequestHandle, Handle, const FGridPathResult&, Result);
\ No newline at end of file
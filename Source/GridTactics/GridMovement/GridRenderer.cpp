@@ -0,0 +1,136 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridRenderer.h"
+#include "GridManager.h"
+#include "GridCell.h"
+#include "GridMapAsset.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+
+AGridRenderer::AGridRenderer()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+    CellInstances = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("CellInstances"));
+    CellInstances->NumCustomDataFloats = 1;
+    CellInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);    // 格子查询走 GridManager，不需要碰撞
+    CellInstances->SetCanEverAffectNavigation(false);
+    CellInstances->SetMobility(EComponentMobility::Movable);               // 运行时重建实例（关卡流式加载）
+    RootComponent = CellInstances;
+}
+
+void AGridRenderer::BeginPlay()
+{
+	Super::BeginPlay();
+
+    ApplyMeshSettings();
+}
+
+void AGridRenderer::CaptureAppearanceFromMapAsset(const UGridMapAsset* MapAsset)
+{
+    if (CellMesh || !MapAsset || !MapAsset->CellMesh)
+    {
+        return;
+    }
+
+    CellMesh = MapAsset->CellMesh;
+    if (!CellMaterial)
+    {
+        CellMaterial = MapAsset->CellMaterial;
+    }
+    CellMeshTransform = MapAsset->CellMeshTransform;
+
+    ApplyMeshSettings();
+}
+
+void AGridRenderer::CaptureAppearanceFromProxy(const AGridCell* Proxy)
+{
+    if (CellMesh || !Proxy)
+    {
+        return;
+    }
+
+    const UStaticMeshComponent* ProxyMesh = Proxy->GetVisualMesh();
+    if (!ProxyMesh || !ProxyMesh->GetStaticMesh())
+    {
+        return;
+    }
+
+    CellMesh = ProxyMesh->GetStaticMesh();
+    if (!CellMaterial)
+    {
+        CellMaterial = ProxyMesh->GetMaterial(0);
+    }
+
+    // 只保留网格体相对代理的变换，摆放高度逐格取自高度层（烘焙时即代理的 Z）
+    CellMeshTransform = ProxyMesh->GetRelativeTransform();
+
+    ApplyMeshSettings();
+}
+
+void AGridRenderer::ApplyMeshSettings()
+{
+    if (CellMesh && CellInstances->GetStaticMesh() != CellMesh)
+    {
+        CellInstances->SetStaticMesh(CellMesh);
+    }
+    if (CellMaterial)
+    {
+        CellInstances->SetMaterial(0, CellMaterial);
+    }
+}
+
+void AGridRenderer::RebuildInstances(AGridManager* GridManager)
+{
+    CellInstances->ClearInstances();
+    InstanceIndices.Reset();
+    if (!GridManager || !CellMesh)
+    {
+        return;
+    }
+
+    TArray<FTransform> InstanceTransforms;
+    TArray<float> InstanceCellTypes;
+    GridManager->ForEachLoadedCell([&](FIntPoint Grid, const FGridCellRecord& Cell)
+    {
+        InstanceIndices.Add(Grid, InstanceTransforms.Num());
+        InstanceTransforms.Add(CellMeshTransform * FTransform(GridManager->GetGridSurfaceLocation(Grid)));
+        InstanceCellTypes.Add((float)Cell.Type);
+    });
+
+    CellInstances->AddInstances(InstanceTransforms, false, true);
+    for (int32 InstanceIndex = 0; InstanceIndex < InstanceCellTypes.Num(); ++InstanceIndex)
+    {
+        CellInstances->SetCustomDataValue(InstanceIndex, 0, InstanceCellTypes[InstanceIndex], false);
+    }
+    CellInstances->MarkRenderStateDirty();
+
+    UE_LOG(LogTemp, Log, TEXT("GridRenderer: %d cell instances"), InstanceTransforms.Num());
+}
+
+void AGridRenderer::UpdateInstances(const AGridManager* GridManager, const TArray<FIntPoint>& ChangedCells)
+{
+    if (!GridManager)
+    {
+        return;
+    }
+
+    bool bAnyUpdated = false;
+    for (const FIntPoint& Grid : ChangedCells)
+    {
+        if (const int32* InstanceIndex = InstanceIndices.Find(Grid))
+        {
+            // 类型与高度层都可能变化
+            CellInstances->SetCustomDataValue(*InstanceIndex, 0, (float)GridManager->GetGridCellType(Grid), false);
+            CellInstances->UpdateInstanceTransform(*InstanceIndex,
+                CellMeshTransform * FTransform(GridManager->GetGridSurfaceLocation(Grid)), true, false, true);
+            bAnyUpdated = true;
+        }
+    }
+
+    if (bAnyUpdated)
+    {
+        CellInstances->MarkRenderStateDirty();
+    }
+}
\ No newline at end of file
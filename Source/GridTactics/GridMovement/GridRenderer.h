@@ -0,0 +1,62 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GridRenderer.generated.h"
+
+class AGridManager;
+class AGridCell;
+class UGridMapAsset;
+class UHierarchicalInstancedStaticMeshComponent;
+
+/**
+ * 用一个 HISM 组件绘制所有格子，替代逐格的 GridCell Actor
+ * 每个实例带 1 个自定义数据：CustomData[0] = (float)EGridCellType，材质用 PerInstanceCustomData 区分格子类型
+ */
+UCLASS()
+class GRIDTACTICS_API AGridRenderer : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGridRenderer();
+
+    // 按 GridManager 当前已加载的格子重建全部实例（格子布局变化时由 GridManager 调用）
+    UFUNCTION(BlueprintCallable, Category = "Grid|Render")
+    void RebuildInstances(AGridManager* GridManager);
+
+    // 只刷新变化格子的实例数据（由 GridManager 的变化日志驱动）
+    void UpdateInstances(const AGridManager* GridManager, const TArray<FIntPoint>& ChangedCells);
+
+    // 未指定 CellMesh 时，使用烘焙地图中保存的网格体、材质与相对变换（打包版本中唯一的外观来源）
+    void CaptureAppearanceFromMapAsset(const UGridMapAsset* MapAsset);
+
+    // 未指定 CellMesh 时，从第一个 GridCell 代理采集网格体、材质与相对变换（未烘焙的关卡使用）
+    void CaptureAppearanceFromProxy(const AGridCell* Proxy);
+
+protected:
+    UPROPERTY(VisibleAnywhere, Category = "Components")
+    TObjectPtr<UHierarchicalInstancedStaticMeshComponent> CellInstances;
+
+    // 格子网格体，为空时取自烘焙地图或 GridCell 代理
+    UPROPERTY(EditAnywhere, Category = "Grid|Render")
+    TObjectPtr<UStaticMesh> CellMesh;
+
+    // 格子材质，为空时使用网格体自带材质
+    UPROPERTY(EditAnywhere, Category = "Grid|Render")
+    TObjectPtr<UMaterialInterface> CellMaterial;
+
+    // 网格体相对格子地面位置（GridManager::GetGridSurfaceLocation）的变换
+    UPROPERTY(EditAnywhere, Category = "Grid|Render")
+    FTransform CellMeshTransform;
+
+    virtual void BeginPlay() override;
+
+private:
+    void ApplyMeshSettings();
+
+    // 格子 -> 实例下标
+    TMap<FIntPoint, int32> InstanceIndices;
+};
\ No newline at end of file
@@ -0,0 +1,208 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridSpawnPlacement.h"
+#include "GridManager.h"
+#include "GridTopology.h"
+#include "GridMovementComponent.h"
+#include "GridTactics/GridTactics.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spawn Wave Placement"), STAT_GridSpawnWavePlacement, STATGROUP_GridTactics);
+
+bool UGridSpawnPlacement::ReserveSpawnGrid(AGridManager* GridManager, AActor* Requester, FIntPoint PreferredGrid,
+    int32 MaxSearchRadius, FIntPoint& OutGrid, int32 FootprintSize)
+{
+    if (!GridManager || !Requester)
+    {
+        return false;
+    }
+    FootprintSize = FMath::Max(FootprintSize, 1);
+
+    auto IsInRange = [PreferredGrid, MaxSearchRadius](FIntPoint Grid)
+    {
+        return FGridTopology4::Distance(Grid, PreferredGrid) <= MaxSearchRadius;
+    };
+
+    // 期望格子站不下（墙里、地图外、多格角色贴墙）时，先按曼哈顿距离逐圈找最近能站的锚点作为起点
+    FIntPoint Origin = PreferredGrid;
+    if (!GridManager->CanFootprintStandAt(Origin, FootprintSize)
+        && !FindNearestStandableGrid(GridManager, PreferredGrid, MaxSearchRadius, FootprintSize, Origin))
+    {
+        return false;
+    }
+
+    // BFS 只穿过能站立的锚点（单格角色即可行走格子），结果与起点在同一连通区域（不会隔墙生成到够不着的地方），先找到的步数最少
+    TArray<FIntPoint, TInlineAllocator<64>> Queue;
+    TSet<FIntPoint> Visited;
+    Queue.Add(Origin);
+    Visited.Add(Origin);
+
+    for (int32 Head = 0; Head < Queue.Num(); ++Head)
+    {
+        const FIntPoint Grid = Queue[Head];
+
+        // 预定是原子的，GetActorInFootprint 只做快速过滤；区域内有格子被别人抢先预定时继续向外找
+        if (!GridManager->GetActorInFootprint(Grid, FootprintSize, Requester)
+            && GridManager->ReserveFootprint(Requester, Grid, FootprintSize))
+        {
+            OutGrid = Grid;
+            return true;
+        }
+
+        FGridTopology4::ForEachNeighbor(Grid, [&](FIntPoint Next, int32)
+        {
+            if (!IsInRange(Next) || !GridManager->CanFootprintStandAt(Next, FootprintSize))
+            {
+                return;
+            }
+
+            bool bAlreadyVisited = false;
+            Visited.Add(Next, &bAlreadyVisited);
+            if (!bAlreadyVisited)
+            {
+                Queue.Add(Next);
+            }
+        });
+    }
+
+    return false;
+}
+
+bool UGridSpawnPlacement::FindNearestStandableGrid(const AGridManager* GridManager, FIntPoint Center, int32 MaxRadius,
+    int32 FootprintSize, FIntPoint& OutGrid)
+{
+    for (int32 Radius = 1; Radius <= MaxRadius; ++Radius)
+    {
+        // 曼哈顿距离为 Radius 的菱形边界
+        for (int32 DX = -Radius; DX <= Radius; ++DX)
+        {
+            const int32 DY = Radius - FMath::Abs(DX);
+            for (const int32 SignedDY : { DY, -DY })
+            {
+                const FIntPoint Grid = Center + FIntPoint(DX, SignedDY);
+                if (GridManager->CanFootprintStandAt(Grid, FootprintSize))
+                {
+                    OutGrid = Grid;
+                    return true;
+                }
+                if (DY == 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+int32 UGridSpawnPlacement::GetActorFootprintSize(const AActor* Actor)
+{
+    const UGridMovementComponent* MovementComponent = Actor ? Actor->FindComponentByClass<UGridMovementComponent>() : nullptr;
+    return MovementComponent ? MovementComponent->GetFootprintSize() : 1;
+}
+
+AActor* UGridSpawnPlacement::SpawnAndReserve(UWorld* World, AGridManager* GridManager, const FGridSpawnRequest& Request,
+    int32 MaxSearchRadius, FIntPoint& OutGrid)
+{
+    if (!Request.ActorClass)
+    {
+        return nullptr;
+    }
+
+    // 延迟生成：先拿到 Actor 作为预定者，BeginPlay 之前就把格子锁住
+    AActor* Actor = World->SpawnActorDeferred<AActor>(Request.ActorClass, FTransform(Request.Rotation), nullptr,
+        nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+    if (!Actor)
+    {
+        return nullptr;
+    }
+
+    // 组件在延迟生成时已创建，可以先读出占地边长
+    const int32 FootprintSize = GetActorFootprintSize(Actor);
+    if (!ReserveSpawnGrid(GridManager, Actor, Request.PreferredGrid, MaxSearchRadius, OutGrid, FootprintSize))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("GridSpawnPlacement: No free grid within %d of (%d, %d) for %s"),
+            MaxSearchRadius, Request.PreferredGrid.X, Request.PreferredGrid.Y, *Request.ActorClass->GetName());
+        Actor->Destroy();
+        return nullptr;
+    }
+
+    // 精确落在占地区域中心（与 UGridMovementComponent::FootprintToWorld 一致），高度取锚点格子的地面，不再依赖碰撞推挤
+    FVector SpawnLocation = GridManager->GetGridSurfaceLocation(OutGrid);
+    const FVector FarCorner = GridManager->GridToWorld(OutGrid + FIntPoint(FootprintSize - 1, FootprintSize - 1));
+    SpawnLocation.X = (SpawnLocation.X + FarCorner.X) * 0.5f;
+    SpawnLocation.Y = (SpawnLocation.Y + FarCorner.Y) * 0.5f;
+    SpawnLocation.Z += Request.HeightOffset;
+    Actor->FinishSpawning(FTransform(Request.Rotation, SpawnLocation));
+
+    if (!IsValid(Actor))
+    {
+        GridManager->ReleaseFootprintIfOwner(Actor, OutGrid, FootprintSize);
+        return nullptr;
+    }
+
+    return Actor;
+}
+
+AActor* UGridSpawnPlacement::SpawnAtGrid(UObject* WorldContextObject, const FGridSpawnRequest& Request, int32 MaxSearchRadius)
+{
+    UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+    AGridManager* GridManager = UGridTacticsWorldSubsystem::GetGridManagerFor(WorldContextObject);
+    if (!World || !GridManager)
+    {
+        return nullptr;
+    }
+
+    FIntPoint Grid;
+    AActor* Actor = SpawnAndReserve(World, GridManager, Request, MaxSearchRadius, Grid);
+
+    // BeginPlay 中已登记占用，预定可以释放
+    if (Actor)
+    {
+        GridManager->ReleaseFootprintIfOwner(Actor, Grid, GetActorFootprintSize(Actor));
+    }
+    return Actor;
+}
+
+void UGridSpawnPlacement::SpawnWave(UObject* WorldContextObject, const TArray<FGridSpawnRequest>& Requests,
+    TArray<AActor*>& OutActors, int32 MaxSearchRadius)
+{
+    SCOPE_CYCLE_COUNTER(STAT_GridSpawnWavePlacement);
+
+    OutActors.Reset(Requests.Num());
+
+    UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+    AGridManager* GridManager = UGridTacticsWorldSubsystem::GetGridManagerFor(WorldContextObject);
+    if (!World || !GridManager)
+    {
+        OutActors.SetNumZeroed(Requests.Num());
+        return;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    // 整波生成完之前保留所有预定，避免同一波的角色互相抢格
+    TArray<TPair<AActor*, FIntPoint>, TInlineAllocator<16>> Reserved;
+    for (const FGridSpawnRequest& Request : Requests)
+    {
+        FIntPoint Grid;
+        AActor* Actor = SpawnAndReserve(World, GridManager, Request, MaxSearchRadius, Grid);
+        OutActors.Add(Actor);
+        if (Actor)
+        {
+            Reserved.Emplace(Actor, Grid);
+        }
+    }
+
+    for (const TPair<AActor*, FIntPoint>& Entry : Reserved)
+    {
+        GridManager->ReleaseFootprintIfOwner(Entry.Key, Entry.Value, GetActorFootprintSize(Entry.Key));
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("GridSpawnPlacement: Placed %d/%d actors in %.3f ms"),
+        Reserved.Num(), Requests.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "GridSpawnPlacement.generated.h"
+
+class AGridManager;
+
+// 一次生成请求（用于整波批量生成）
+USTRUCT(BlueprintType)
+struct FGridSpawnRequest
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn")
+    TSubclassOf<AActor> ActorClass;
+
+    // 期望的格子，被占用或不可行走时就近查找
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn")
+    FIntPoint PreferredGrid = FIntPoint::ZeroValue;
+
+    // 相对格子地面的抬高（避免穿模）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn")
+    float HeightOffset = 100.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawn")
+    FRotator Rotation = FRotator::ZeroRotator;
+};
+
+/**
+ * 格子生成放置：从期望格子沿可行走格子 BFS 找最近的空闲格子，在 GridManager 中原子预定后精确生成在格子中心
+ * 单一职责：只负责选格子与生成，不处理波次逻辑
+ */
+UCLASS()
+class GRIDTACTICS_API UGridSpawnPlacement : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    // 查找并为 Requester 预定离 PreferredGrid 最近的空闲可行走格子（曼哈顿距离 <= MaxSearchRadius）
+    // 只沿可行走格子扩展，结果与 PreferredGrid（不可行走时为离它最近的可行走格子）在同一连通区域
+    // FootprintSize > 1 时按 K x K 占地查找并预定整个区域，OutGrid 为区域的最小角
+    static bool ReserveSpawnGrid(AGridManager* GridManager, AActor* Requester, FIntPoint PreferredGrid,
+        int32 MaxSearchRadius, FIntPoint& OutGrid, int32 FootprintSize = 1);
+
+    // 角色的占地边长（取自 GridMovementComponent，没有该组件为 1）
+    static int32 GetActorFootprintSize(const AActor* Actor);
+
+    // 生成单个角色，找不到空闲格子时不生成并返回 nullptr
+    UFUNCTION(BlueprintCallable, Category = "Grid|Spawn", meta = (WorldContext = "WorldContextObject"))
+    static AActor* SpawnAtGrid(UObject* WorldContextObject, const FGridSpawnRequest& Request, int32 MaxSearchRadius = 8);
+
+    // 整波生成：按顺序放置，同一波内的角色不会落在同一格；OutActors 与 Requests 一一对应（失败为 nullptr）
+    UFUNCTION(BlueprintCallable, Category = "Grid|Spawn", meta = (WorldContext = "WorldContextObject"))
+    static void SpawnWave(UObject* WorldContextObject, const TArray<FGridSpawnRequest>& Requests,
+        TArray<AActor*>& OutActors, int32 MaxSearchRadius = 8);
+
+private:
+    // 按曼哈顿距离逐圈查找离 Center 最近的、K x K 角色能站立的锚点（不含 Center 本身）
+    static bool FindNearestStandableGrid(const AGridManager* GridManager, FIntPoint Center, int32 MaxRadius,
+        int32 FootprintSize, FIntPoint& OutGrid);
+
+    // 延迟生成 -> 预定格子（多格角色预定整个占地区域） -> 在占地区域中心完成生成；成功时预定保持到调用方释放
+    static AActor* SpawnAndReserve(UWorld* World, AGridManager* GridManager, const FGridSpawnRequest& Request,
+        int32 MaxSearchRadius, FIntPoint& OutGrid);
+};
\ No newline at end of file
@@ -0,0 +1,64 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridSummedAreaTable.h"
+#include "GridBitboard.h"
+
+void FGridSummedAreaTable::Init(FIntPoint InMin, FIntPoint InSize)
+{
+    Min = InMin;
+    Size = FIntPoint(FMath::Max(InSize.X, 0), FMath::Max(InSize.Y, 0));
+    Sums.SetNumZeroed((Size.X + 1) * (Size.Y + 1));
+    DirtyStart = FIntPoint::ZeroValue;
+}
+
+void FGridSummedAreaTable::MarkDirty(FIntPoint Grid)
+{
+    const FIntPoint Local = Grid - Min;
+    if (Local.X < 0 || Local.Y < 0 || Local.X >= Size.X || Local.Y >= Size.Y)
+    {
+        return;
+    }
+    DirtyStart = FIntPoint(FMath::Min(DirtyStart.X, Local.X), FMath::Min(DirtyStart.Y, Local.Y));
+}
+
+void FGridSummedAreaTable::Update(const FGridBitboard& Source, bool bCountClearBits)
+{
+    if (!IsDirty())
+    {
+        return;
+    }
+
+    // 只有脏区起点右下方的前缀和会变化：逐行重算 [DirtyStart.X, Size.X) 这一段
+    const int32 Stride = Size.X + 1;
+    for (int32 Y = DirtyStart.Y; Y < Size.Y; ++Y)
+    {
+        int32* Row = Sums.GetData() + (Y + 1) * Stride;
+        const int32* PrevRow = Row - Stride;
+
+        // 本行脏区左侧的行内累计值 = 当前前缀和 - 上一行前缀和
+        int32 RowSum = Row[DirtyStart.X] - PrevRow[DirtyStart.X];
+        for (int32 X = DirtyStart.X; X < Size.X; ++X)
+        {
+            const bool bSet = Source.TestBit(Min + FIntPoint(X, Y));
+            RowSum += (bSet != bCountClearBits) ? 1 : 0;
+            Row[X + 1] = PrevRow[X + 1] + RowSum;
+        }
+    }
+    DirtyStart = FIntPoint(MAX_int32, MAX_int32);
+}
+
+int32 FGridSummedAreaTable::Sum(FIntPoint RectMin, FIntPoint RectMax) const
+{
+    checkSlow(!IsDirty());
+
+    // 裁剪到包围盒，转为前缀和下标（右下角 + 1）
+    const int32 X0 = FMath::Clamp(RectMin.X - Min.X, 0, Size.X);
+    const int32 Y0 = FMath::Clamp(RectMin.Y - Min.Y, 0, Size.Y);
+    const int32 X1 = FMath::Clamp(RectMax.X - Min.X + 1, 0, Size.X);
+    const int32 Y1 = FMath::Clamp(RectMax.Y - Min.Y + 1, 0, Size.Y);
+    if (X1 <= X0 || Y1 <= Y0)
+    {
+        return 0;
+    }
+    return At(X1, Y1) - At(X0, Y1) - At(X1, Y0) + At(X0, Y0);
+}
\ No newline at end of file
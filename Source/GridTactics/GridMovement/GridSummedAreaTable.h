@@ -0,0 +1,38 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FGridBitboard;
+
+/**
+ * 位图的积分图（summed-area table）：任意矩形内置位格子数 O(1) 求出
+ * 格子变化只记录脏区起点，下次 Update 时只重算起点右下方的行段
+ */
+struct GRIDTACTICS_API FGridSummedAreaTable
+{
+    // 按包围盒分配，整表标记为脏
+    void Init(FIntPoint InMin, FIntPoint InSize);
+
+    void MarkDirty(FIntPoint Grid);
+    bool IsDirty() const { return DirtyStart.X < Size.X && DirtyStart.Y < Size.Y; }
+
+    // 从 Source 重算脏区；bCountClearBits 为 true 时统计未置位的格子
+    void Update(const FGridBitboard& Source, bool bCountClearBits = false);
+
+    // 矩形 [RectMin, RectMax]（含边界）内的计数，超出包围盒的部分按 0 计；调用前需 Update
+    int32 Sum(FIntPoint RectMin, FIntPoint RectMax) const;
+
+private:
+    FIntPoint Min = FIntPoint::ZeroValue;
+    FIntPoint Size = FIntPoint::ZeroValue;
+
+    // (Size.Y + 1) 行 x (Size.X + 1) 列，第 0 行与第 0 列恒为 0
+    TArray<int32> Sums;
+
+    // 脏区起点（包围盒内的局部坐标），无脏区时为 MAX_int32
+    FIntPoint DirtyStart = FIntPoint(MAX_int32, MAX_int32);
+
+    int32 At(int32 X, int32 Y) const { return Sums[Y * (Size.X + 1) + X]; }
+};
\ No newline at end of file
@@ -0,0 +1,177 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 网格邻接方式，作为 TGridTopology 的模板参数
+enum class EGridTopology : uint8
+{
+    FourWay,    // 四方向（上下左右）
+    EightWay,   // 八方向（含对角）
+    Hex         // 六边形（轴坐标 q = X, r = Y，尖顶朝上）
+};
+
+template<EGridTopology Topology>
+struct TGridTopology;
+
+/**
+ * 拓扑策略的公共部分：方向表按逆时针排列、从东 (X+) 开始，第 i 个方向的朝向为 i * 360 / NumDirections 度
+ * 派生策略需提供 NumDirections、DirectionX/DirectionY、NumRotations、Distance、Rotate、GridToLocal、LocalToGrid
+ */
+template<typename Derived>
+struct TGridTopologyBase
+{
+    static FIntPoint GetDirection(int32 Index)
+    {
+        const int32 Wrapped = WrapDirectionIndex(Index);
+        return FIntPoint(Derived::DirectionX[Wrapped], Derived::DirectionY[Wrapped]);
+    }
+
+    static FIntPoint GetNeighbor(FIntPoint Grid, int32 Index) { return Grid + GetDirection(Index); }
+
+    static constexpr int32 WrapDirectionIndex(int32 Index)
+    {
+        return ((Index % Derived::NumDirections) + Derived::NumDirections) % Derived::NumDirections;
+    }
+
+    // 方向下标 -> 朝向（度）
+    static constexpr float GetDirectionYaw(int32 Index) { return WrapDirectionIndex(Index) * (360.0f / Derived::NumDirections); }
+
+    // 朝向（度） -> 最接近的方向下标，分界点归入逆时针一侧
+    static int32 DirectionIndexFromYaw(float Yaw) { return SnapYaw(Yaw, Derived::NumDirections); }
+
+    // 朝向（度） -> 模板旋转次数（以 360 / NumRotations 度为单位）
+    static int32 RotationTurnsFromYaw(float Yaw) { return SnapYaw(Yaw, Derived::NumRotations); }
+
+    static FIntPoint UnrotateOffset(FIntPoint Offset, int32 Turns) { return Derived::Rotate(Offset, -Turns); }
+
+    static bool AreNeighbors(FIntPoint A, FIntPoint B) { return Derived::Distance(A, B) == 1; }
+
+    // 按方向表顺序遍历邻居，方向数为编译期常量
+    template<typename FunctorType>
+    static void ForEachNeighbor(FIntPoint Grid, FunctorType&& Visitor)
+    {
+        for (int32 Index = 0; Index < Derived::NumDirections; ++Index)
+        {
+            Visitor(FIntPoint(Grid.X + Derived::DirectionX[Index], Grid.Y + Derived::DirectionY[Index]), Index);
+        }
+    }
+
+private:
+    static int32 SnapYaw(float Yaw, int32 NumSteps)
+    {
+        const float StepYaw = 360.0f / NumSteps;
+        const float NormalizedYaw = FMath::Fmod(FMath::Fmod(Yaw, 360.0f) + 360.0f, 360.0f);
+        return FMath::FloorToInt((NormalizedYaw + StepYaw * 0.5f) / StepYaw) % NumSteps;
+    }
+};
+
+// 四方向：曼哈顿距离，90° 旋转
+template<>
+struct TGridTopology<EGridTopology::FourWay> : TGridTopologyBase<TGridTopology<EGridTopology::FourWay>>
+{
+    static constexpr int32 NumDirections = 4;
+    static constexpr int32 NumRotations = 4;
+    static constexpr int8 DirectionX[NumDirections] = { 1, 0, -1, 0 };
+    static constexpr int8 DirectionY[NumDirections] = { 0, 1, 0, -1 };
+
+    static int32 Distance(FIntPoint A, FIntPoint B) { return FMath::Abs(A.X - B.X) + FMath::Abs(A.Y - B.Y); }
+
+    // 与 FRotator(0, 90 * Turns, 0).RotateVector 取整结果相同
+    static FIntPoint Rotate(FIntPoint Offset, int32 Turns)
+    {
+        switch (Turns & 3)
+        {
+        case 1:  return FIntPoint(-Offset.Y, Offset.X);   // 90°
+        case 2:  return FIntPoint(-Offset.X, -Offset.Y);  // 180°
+        case 3:  return FIntPoint(Offset.Y, -Offset.X);   // 270°
+        default: return Offset;
+        }
+    }
+
+    static FVector2D GridToLocal(FIntPoint Grid, float CellSize) { return FVector2D(Grid.X * CellSize, Grid.Y * CellSize); }
+
+    static FIntPoint LocalToGrid(FVector2D Local, float CellSize)
+    {
+        return FIntPoint(FMath::RoundToInt(Local.X / CellSize), FMath::RoundToInt(Local.Y / CellSize));
+    }
+};
+
+// 八方向：切比雪夫距离；格子坐标只在 90° 旋转下保持整数，因此模板旋转仍以 90° 为单位
+template<>
+struct TGridTopology<EGridTopology::EightWay> : TGridTopologyBase<TGridTopology<EGridTopology::EightWay>>
+{
+    static constexpr int32 NumDirections = 8;
+    static constexpr int32 NumRotations = 4;
+    static constexpr int8 DirectionX[NumDirections] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+    static constexpr int8 DirectionY[NumDirections] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+    static int32 Distance(FIntPoint A, FIntPoint B) { return FMath::Max(FMath::Abs(A.X - B.X), FMath::Abs(A.Y - B.Y)); }
+
+    static FIntPoint Rotate(FIntPoint Offset, int32 Turns) { return TGridTopology<EGridTopology::FourWay>::Rotate(Offset, Turns); }
+
+    static FVector2D GridToLocal(FIntPoint Grid, float CellSize) { return TGridTopology<EGridTopology::FourWay>::GridToLocal(Grid, CellSize); }
+    static FIntPoint LocalToGrid(FVector2D Local, float CellSize) { return TGridTopology<EGridTopology::FourWay>::LocalToGrid(Local, CellSize); }
+};
+
+// 六边形：轴坐标 (q, r)，立方坐标 s = -q - r；60° 旋转
+template<>
+struct TGridTopology<EGridTopology::Hex> : TGridTopologyBase<TGridTopology<EGridTopology::Hex>>
+{
+    static constexpr int32 NumDirections = 6;
+    static constexpr int32 NumRotations = 6;
+    static constexpr int8 DirectionX[NumDirections] = { 1, 0, -1, -1, 0, 1 };
+    static constexpr int8 DirectionY[NumDirections] = { 0, 1, 1, 0, -1, -1 };
+
+    static int32 Distance(FIntPoint A, FIntPoint B)
+    {
+        const int32 DQ = A.X - B.X;
+        const int32 DR = A.Y - B.Y;
+        return (FMath::Abs(DQ) + FMath::Abs(DR) + FMath::Abs(DQ + DR)) / 2;
+    }
+
+    // 逆时针每次 60°：(q, r) -> (-r, q + r)
+    static FIntPoint Rotate(FIntPoint Offset, int32 Turns)
+    {
+        for (int32 Step = ((Turns % NumRotations) + NumRotations) % NumRotations; Step > 0; --Step)
+        {
+            Offset = FIntPoint(-Offset.Y, Offset.X + Offset.Y);
+        }
+        return Offset;
+    }
+
+    // CellSize 为相邻格子中心距离
+    static FVector2D GridToLocal(FIntPoint Grid, float CellSize)
+    {
+        return FVector2D(CellSize * (Grid.X + Grid.Y * 0.5f), CellSize * Grid.Y * UE_HALF_SQRT_3);
+    }
+
+    static FIntPoint LocalToGrid(FVector2D Local, float CellSize)
+    {
+        const double R = Local.Y / (CellSize * UE_HALF_SQRT_3);
+        const double Q = Local.X / CellSize - R * 0.5;
+
+        // 立方坐标取整：舍入误差最大的分量由另外两个分量推出
+        const double S = -Q - R;
+        int32 RoundQ = FMath::RoundToInt(Q);
+        int32 RoundR = FMath::RoundToInt(R);
+        const int32 RoundS = FMath::RoundToInt(S);
+        const double ErrorQ = FMath::Abs(RoundQ - Q);
+        const double ErrorR = FMath::Abs(RoundR - R);
+        const double ErrorS = FMath::Abs(RoundS - S);
+        if (ErrorQ > ErrorR && ErrorQ > ErrorS)
+        {
+            RoundQ = -RoundR - RoundS;
+        }
+        else if (ErrorR > ErrorS)
+        {
+            RoundR = -RoundQ - RoundS;
+        }
+        return FIntPoint(RoundQ, RoundR);
+    }
+};
+
+using FGridTopology4 = TGridTopology<EGridTopology::FourWay>;
+using FGridTopology8 = TGridTopology<EGridTopology::EightWay>;
+using FGridTopologyHex = TGridTopology<EGridTopology::Hex>;
\ No newline at end of file
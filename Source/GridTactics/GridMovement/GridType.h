@@ -7,4 +7,63 @@ enum class EGridCellType : uint8
     Blocked,
     Water,      // δչ
     Lava        // δչ
+};
+
+// ռλӪ GridManager Ӫλͼ
+UENUM(BlueprintType)
+enum class EGridTeam : uint8
+{
+    None,
+    Player,
+    Enemy,
+    MAX         UMETA(Hidden)
+};
+
+// Բ㣨SoAÿţ
+UENUM(BlueprintType)
+enum class EGridCellLayer : uint8
+{
+    MoveCost,   // uint8ƶģ0 = Чӣ
+    Height,     // int16߶ȣף
+    Faction,    // uint8Ӫ/Ʒ
+    Hazard      // uint8Σ ID0 = ޣ
+};
+
+// ڵϣ
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EGridSightBlocker : uint8
+{
+    None        = 0         UMETA(Hidden),
+    Walls       = 1 << 0,   // Blocked ͵ĸ
+    Unwalkable  = 1 << 1,   // вߵĸӣˮ桢ҽն
+    Actors      = 1 << 2    // ɫռݵĸ
+};
+ENUM_CLASS_FLAGS(EGridSightBlocker);
+
+// ӵԲȡֵд決ʱʹã
+struct FGridCellAttributes
+{
+    uint8 MoveCost = 1;
+    int16 Height = 0;
+    uint8 Faction = 0;
+    uint8 Hazard = 0;
+};
+
+// Ӵ洢е״̬λ
+enum class EGridCellFlags : uint8
+{
+    None        = 0,
+    Valid       = 1 << 0,   //  GridCell
+    Walkable    = 1 << 1    // һߵ GridCell
+};
+ENUM_CLASS_FLAGS(EGridCellFlags);
+
+// GridManager ոӴ洢еĵ¼
+struct FGridCellRecord
+{
+    EGridCellType Type = EGridCellType::Blocked;
+    EGridCellFlags Flags = EGridCellFlags::None;
+
+    bool IsValid() const { return EnumHasAnyFlags(Flags, EGridCellFlags::Valid); }
+    bool IsWalkable() const { return EnumHasAnyFlags(Flags, EGridCellFlags::Walkable); }
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "PathPlanner.h"
 #include "GridManager.h"
+#include "GridAStar.h"
 
 FPathValidationResult UPathPlanner::PlanDashPath(
     AGridManager* GridManager,
@@ -23,11 +24,24 @@ FPathValidationResult UPathPlanner::PlanDashPath(
         return Result;
     }
 
+    // 多格角色（Boss）按占地区域检查，StartGrid 为区域最小角
+    const int32 FootprintSize = GridManager->GetActorFootprintSize(IgnoreActor);
+
     FIntPoint CurrentGrid = StartGrid;
     Result.ValidPath.Add(CurrentGrid); // 起点
 
     for (int32 Step = 1; Step <= MaxDistance; ++Step)
     {
+        // 0. 障碍距离表：前方连续的空格子整段加入，只在遇到阻挡时逐格检查（多格角色取占地前沿各通道的最小值）
+        const int32 FreeSteps = FMath::Min(
+            GridManager->GetFootprintObstacleDistance(CurrentGrid, Direction, FootprintSize), MaxDistance - Step + 1);
+        if (FreeSteps > 0)
+        {
+            AppendStraightPath(Result.ValidPath, CurrentGrid, Direction, FreeSteps);
+            Step += FreeSteps - 1;
+            continue;
+        }
+
         FIntPoint NextGrid = CurrentGrid + Direction;
 
         // 1. 边界检查
@@ -39,7 +53,7 @@ FPathValidationResult UPathPlanner::PlanDashPath(
         }
 
         // 2. 静态障碍物检查
-        if (!GridManager->IsGridWalkable(NextGrid))
+        if (!GridManager->CanFootprintStandAt(NextGrid, FootprintSize))
         {
             Result.BlockReason = EKnockbackBlockReason::StaticObstacle;
             Result.BlockedAtGrid = NextGrid;
@@ -47,7 +61,7 @@ FPathValidationResult UPathPlanner::PlanDashPath(
         }
 
         // 3. 动态角色检查
-        AActor* ActorAtGrid = GetActorAtGrid(GridManager, NextGrid, IgnoreActor);
+        AActor* ActorAtGrid = GetActorAtGrid(GridManager, NextGrid, IgnoreActor, FootprintSize);
         if (ActorAtGrid)
         {
             if (bCanCollide)
@@ -119,6 +133,14 @@ bool UPathPlanner::ValidateKnockbackPath(
     int32 Distance,
     AActor* IgnoreActor)
 {
+    // 被撞的多格角色从自身占地区域的最小角开始击退
+    FIntPoint Anchor;
+    int32 FootprintSize;
+    if (GridManager->GetActorFootprint(IgnoreActor, Anchor, FootprintSize) && FootprintSize > 1)
+    {
+        StartGrid = Anchor;
+    }
+
     FPathValidationResult KnockbackResult = PlanKnockbackPath(
         GridManager,
         StartGrid,
@@ -147,11 +169,22 @@ FPathValidationResult UPathPlanner::PlanKnockbackPath(
         return Result;
     }
 
+    const int32 FootprintSize = GridManager->GetActorFootprintSize(IgnoreActor);
+
     FIntPoint CurrentGrid = StartGrid;
     Result.ValidPath.Add(CurrentGrid);
 
     for (int32 Step = 1; Step <= Distance; ++Step)
     {
+        const int32 FreeSteps = FMath::Min(
+            GridManager->GetFootprintObstacleDistance(CurrentGrid, Direction, FootprintSize), Distance - Step + 1);
+        if (FreeSteps > 0)
+        {
+            AppendStraightPath(Result.ValidPath, CurrentGrid, Direction, FreeSteps);
+            Step += FreeSteps - 1;
+            continue;
+        }
+
         FIntPoint NextGrid = CurrentGrid + Direction;
 
         // 遇到阻挡时，停在当前有效位置
@@ -164,7 +197,7 @@ FPathValidationResult UPathPlanner::PlanKnockbackPath(
             break;
         }
 
-        if (!GridManager->IsGridWalkable(NextGrid))
+        if (!GridManager->CanFootprintStandAt(NextGrid, FootprintSize))
         {
             Result.BlockReason = EKnockbackBlockReason::StaticObstacle;
             Result.BlockedAtGrid = NextGrid;
@@ -173,7 +206,7 @@ FPathValidationResult UPathPlanner::PlanKnockbackPath(
             break;
         }
 
-        AActor* ActorAtGrid = GetActorAtGrid(GridManager, NextGrid, IgnoreActor);
+        AActor* ActorAtGrid = GetActorAtGrid(GridManager, NextGrid, IgnoreActor, FootprintSize);
         if (ActorAtGrid)
         {
             // 击退路径上有其他角色
@@ -226,6 +259,7 @@ FPathValidationResult UPathPlanner::PlanTeleportPath(
         return Result;
     }
 
+    const int32 FootprintSize = GridManager->GetActorFootprintSize(IgnoreActor);
     Result.ValidPath.Add(StartGrid);
 
     // 传送只检查目标点
@@ -236,14 +270,14 @@ FPathValidationResult UPathPlanner::PlanTeleportPath(
         return Result;
     }
 
-    if (!GridManager->IsGridWalkable(TargetGrid))
+    if (!GridManager->CanFootprintStandAt(TargetGrid, FootprintSize))
     {
         Result.BlockReason = EKnockbackBlockReason::StaticObstacle;
         Result.BlockedAtGrid = TargetGrid;
         return Result;
     }
 
-    AActor* ActorAtTarget = GetActorAtGrid(GridManager, TargetGrid, IgnoreActor);
+    AActor* ActorAtTarget = GetActorAtGrid(GridManager, TargetGrid, IgnoreActor, FootprintSize);
     if (ActorAtTarget)
     {
         Result.BlockReason = EKnockbackBlockReason::AnotherActor;
@@ -256,6 +290,318 @@ FPathValidationResult UPathPlanner::PlanTeleportPath(
     return Result;
 }
 
+FGridPathResult UPathPlanner::FindPath(
+    AGridManager* GridManager,
+    FIntPoint StartGrid,
+    FIntPoint GoalGrid,
+    const FGridPathConstraints& Constraints)
+{
+    FGridPathResult Result;
+    if (!GridManager)
+    {
+        return Result;
+    }
+
+    const int32 FootprintSize = GridManager->GetActorFootprintSize(Constraints.IgnoreActor);
+
+    // 统一代价（不按移动消耗，或地图上移动消耗全为 1）且不避让角色时走 JPS+
+    const bool bUniformCost = !Constraints.bUseMoveCost || GridManager->HasUniformMoveCost();
+    if (bUniformCost && !Constraints.bAvoidOccupied && FootprintSize == 1)
+    {
+        return FindPathJPS(GridManager, StartGrid, GoalGrid, Constraints.MaxExpandedNodes);
+    }
+
+    auto GetEnterCost = [&](FIntPoint Grid)
+    {
+        return GetPathEnterCost(GridManager, Grid, GoalGrid, Constraints, FootprintSize);
+    };
+
+    FGridAStar& Search = FGridAStar::Get();
+    Result.bFound = Search.FindPath(GridManager->GetGridBoundsMin(), GridManager->GetGridBoundsSize(),
+        StartGrid, GoalGrid, GetEnterCost, Result.Path, Result.Cost, Constraints.MaxExpandedNodes);
+    Result.ExpandedNodes = Search.GetExpandedCount();
+    return Result;
+}
+
+int32 UPathPlanner::GetPathEnterCost(AGridManager* GridManager, FIntPoint Grid, FIntPoint GoalGrid,
+    const FGridPathConstraints& Constraints, int32 FootprintSize)
+{
+    return GetGridPathEnterCost(Constraints, Grid, GoalGrid,
+        [&]() { return GridManager->CanFootprintStandAt(Grid, FootprintSize); },
+        [&]() { return GridManager->GetGridLayerValue(Grid, EGridCellLayer::MoveCost); },
+        [&]()
+        {
+            // 占位先查位图，只有置位的格子才查角色列表
+            const bool bMayBeOccupied = FootprintSize > 1 || GridManager->GetOccupancyBoard().TestBit(Grid);
+            return bMayBeOccupied && GetActorAtGrid(GridManager, Grid, Constraints.IgnoreActor, FootprintSize) != nullptr;
+        });
+}
+
+FGridPathResult UPathPlanner::FindPathJPS(
+    AGridManager* GridManager,
+    FIntPoint StartGrid,
+    FIntPoint GoalGrid,
+    int32 MaxExpandedNodes)
+{
+    FGridPathResult Result;
+    if (!GridManager)
+    {
+        return Result;
+    }
+
+    const FGridJumpPointTable& JumpPoints = GridManager->GetJumpPointTable();
+    auto ExpandJumpPoints = [&JumpPoints, GoalGrid](FIntPoint Grid, FIntPoint ParentGrid, auto&& AddSuccessor)
+    {
+        JumpPoints.ForEachSuccessor(Grid, ParentGrid, GoalGrid, AddSuccessor);
+    };
+
+    FGridAStar& Search = FGridAStar::Get();
+    TArray<FIntPoint> Nodes;
+    Result.bFound = Search.Search(GridManager->GetGridBoundsMin(), GridManager->GetGridBoundsSize(),
+        StartGrid, GoalGrid, ExpandJumpPoints, Nodes, Result.Cost, MaxExpandedNodes);
+    Result.ExpandedNodes = Search.GetExpandedCount();
+
+    // 跳点之间都是直线，逐格展开
+    if (Result.bFound)
+    {
+        Result.Path.Reserve(Result.Cost + 1);
+        Result.Path.Add(Nodes[0]);
+        for (int32 Index = 1; Index < Nodes.Num(); ++Index)
+        {
+            const FIntPoint Delta = Nodes[Index] - Nodes[Index - 1];
+            FIntPoint CurrentGrid = Nodes[Index - 1];
+            AppendStraightPath(Result.Path, CurrentGrid, FIntPoint(FMath::Sign(Delta.X), FMath::Sign(Delta.Y)),
+                FMath::Abs(Delta.X) + FMath::Abs(Delta.Y));
+        }
+    }
+    return Result;
+}
+
+int32 UPathPlanner::ValidateJumpPointSearch(AGridManager* GridManager, int32 NumSamples, int32 Seed)
+{
+    if (!GridManager)
+    {
+        return 0;
+    }
+
+    TArray<FIntPoint> WalkableGrids;
+    GridManager->ForEachLoadedCell([&WalkableGrids](FIntPoint Grid, const FGridCellRecord& Cell)
+    {
+        if (Cell.IsWalkable())
+        {
+            WalkableGrids.Add(Grid);
+        }
+    });
+    if (WalkableGrids.Num() == 0)
+    {
+        return 0;
+    }
+
+    FRandomStream Random(Seed);
+    int32 MismatchCount = 0;
+    for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+    {
+        const FIntPoint Start = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+        const FIntPoint Goal = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+
+        const FGridPathResult JumpResult = FindPathJPS(GridManager, Start, Goal);
+        const int32 Expected = GetBreadthFirstDistance(GridManager, Start, Goal);
+        const int32 Actual = JumpResult.bFound ? JumpResult.Cost : INDEX_NONE;
+
+        // 路径长度一致，且展开后每一步都相邻并落在可行走格子上
+        bool bPathValid = !JumpResult.bFound || JumpResult.Path.Num() == JumpResult.Cost + 1;
+        for (int32 Index = 1; bPathValid && Index < JumpResult.Path.Num(); ++Index)
+        {
+            const FIntPoint Delta = JumpResult.Path[Index] - JumpResult.Path[Index - 1];
+            bPathValid = FMath::Abs(Delta.X) + FMath::Abs(Delta.Y) == 1 && GridManager->IsGridWalkable(JumpResult.Path[Index]);
+        }
+
+        if (Actual != Expected || !bPathValid)
+        {
+            ++MismatchCount;
+            UE_LOG(LogTemp, Error, TEXT("ValidateJumpPointSearch: %s -> %s JPS+ %d, BFS %d, path valid %d"),
+                *Start.ToString(), *Goal.ToString(), Actual, Expected, bPathValid);
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("ValidateJumpPointSearch: %d mismatches in %d samples"), MismatchCount, NumSamples);
+    return MismatchCount;
+}
+
+FGridHierarchicalPath UPathPlanner::FindHierarchicalPath(
+    AGridManager* GridManager,
+    FIntPoint StartGrid,
+    FIntPoint GoalGrid,
+    const FGridPathConstraints& Constraints,
+    int32 RefineSegments)
+{
+    FGridHierarchicalPath Result;
+    if (!GridManager)
+    {
+        return Result;
+    }
+
+    const FGridClusterGraph& ClusterGraph = GridManager->GetClusterGraph();
+    Result.bFound = ClusterGraph.FindAbstractPath(StartGrid, GoalGrid, Result.AbstractPath, Result.Cost, Result.ExpandedNodes,
+        Constraints.MaxExpandedNodes);
+    if (Result.bFound)
+    {
+        Result.Path.Add(StartGrid);
+        RefineHierarchicalPath(GridManager, Result, Constraints, RefineSegments > 0 ? RefineSegments : Result.AbstractPath.Num());
+    }
+    return Result;
+}
+
+bool UPathPlanner::RefineHierarchicalPath(AGridManager* GridManager, FGridHierarchicalPath& Path,
+    const FGridPathConstraints& Constraints, int32 NumSegments)
+{
+    if (!GridManager || !Path.bFound)
+    {
+        return false;
+    }
+
+    const FIntPoint GoalGrid = Path.AbstractPath.Last();
+    auto GetEnterCost = [&](FIntPoint Grid)
+    {
+        return GetPathEnterCost(GridManager, Grid, GoalGrid, Constraints, 1);
+    };
+
+    const FGridClusterGraph& ClusterGraph = GridManager->GetClusterGraph();
+    for (int32 Count = 0; Count < NumSegments && !Path.IsFullyRefined(); ++Count)
+    {
+        if (!ClusterGraph.RefineSegment(Path.AbstractPath[Path.NextSegment], Path.AbstractPath[Path.NextSegment + 1],
+            GetEnterCost, Path.Path, Constraints.MaxExpandedNodes))
+        {
+            Path.bFound = false;
+            return false;
+        }
+        ++Path.NextSegment;
+    }
+    return true;
+}
+
+int32 UPathPlanner::ValidateHierarchicalPaths(AGridManager* GridManager, int32 NumSamples, int32 Seed)
+{
+    if (!GridManager)
+    {
+        return 0;
+    }
+
+    TArray<FIntPoint> WalkableGrids;
+    GridManager->ForEachLoadedCell([&WalkableGrids](FIntPoint Grid, const FGridCellRecord& Cell)
+    {
+        if (Cell.IsWalkable())
+        {
+            WalkableGrids.Add(Grid);
+        }
+    });
+    if (WalkableGrids.Num() == 0)
+    {
+        return 0;
+    }
+
+    const double BuildStartTime = FPlatformTime::Seconds();
+    const FGridClusterGraph& ClusterGraph = GridManager->GetClusterGraph();
+    const double BuildMs = (FPlatformTime::Seconds() - BuildStartTime) * 1000.0;
+
+    // 两边都只看地形、统一代价
+    FGridPathConstraints TerrainOnly;
+    TerrainOnly.bUseMoveCost = false;
+    TerrainOnly.bAvoidOccupied = false;
+
+    auto GetEnterCost = [GridManager](FIntPoint Grid)
+    {
+        return GridManager->IsGridWalkable(Grid) ? 1 : 0;
+    };
+
+    FRandomStream Random(Seed);
+    int32 FailureCount = 0;
+    int32 ComparedPaths = 0;
+    int64 HierarchicalSteps = 0;
+    int64 OptimalSteps = 0;
+    double HierarchicalSeconds = 0.0;
+    double FlatSeconds = 0.0;
+    for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+    {
+        const FIntPoint Start = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+        const FIntPoint Goal = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+
+        double StartTime = FPlatformTime::Seconds();
+        const FGridHierarchicalPath Hierarchical = FindHierarchicalPath(GridManager, Start, Goal, TerrainOnly, 0);
+        HierarchicalSeconds += FPlatformTime::Seconds() - StartTime;
+
+        // 平面 A* 对照
+        TArray<FIntPoint> FlatPath;
+        int32 FlatCost = 0;
+        StartTime = FPlatformTime::Seconds();
+        const bool bFlatFound = FGridAStar::Get().FindPath(GridManager->GetGridBoundsMin(), GridManager->GetGridBoundsSize(),
+            Start, Goal, GetEnterCost, FlatPath, FlatCost);
+        FlatSeconds += FPlatformTime::Seconds() - StartTime;
+
+        bool bPathValid = Hierarchical.Path.Num() == Hierarchical.Cost + 1 && Hierarchical.Path.Last() == Goal;
+        for (int32 Index = 1; bPathValid && Index < Hierarchical.Path.Num(); ++Index)
+        {
+            const FIntPoint Delta = Hierarchical.Path[Index] - Hierarchical.Path[Index - 1];
+            bPathValid = FMath::Abs(Delta.X) + FMath::Abs(Delta.Y) == 1 && GridManager->IsGridWalkable(Hierarchical.Path[Index]);
+        }
+
+        if (Hierarchical.bFound != bFlatFound || (Hierarchical.bFound && !bPathValid))
+        {
+            ++FailureCount;
+            UE_LOG(LogTemp, Error, TEXT("ValidateHierarchicalPaths: %s -> %s HPA* found %d (cost %d, path valid %d), A* found %d (cost %d)"),
+                *Start.ToString(), *Goal.ToString(), Hierarchical.bFound, Hierarchical.Cost, bPathValid, bFlatFound, FlatCost);
+        }
+        else if (Hierarchical.bFound)
+        {
+            ++ComparedPaths;
+            HierarchicalSteps += Hierarchical.Cost;
+            OptimalSteps += FlatCost;
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("ValidateHierarchicalPaths: %d failures in %d samples, path length %.3fx optimal over %d paths"),
+        FailureCount, NumSamples, OptimalSteps > 0 ? (double)HierarchicalSteps / OptimalSteps : 1.0, ComparedPaths);
+    UE_LOG(LogTemp, Log, TEXT("ValidateHierarchicalPaths: HPA* %.3f ms/query, flat A* %.3f ms/query, graph build %.2f ms"),
+        HierarchicalSeconds * 1000.0 / FMath::Max(NumSamples, 1), FlatSeconds * 1000.0 / FMath::Max(NumSamples, 1), BuildMs);
+    UE_LOG(LogTemp, Log, TEXT("ValidateHierarchicalPaths: %d clusters, %d nodes, graph %llu bytes + abstract search pool %llu bytes, flat A* node pool %llu bytes"),
+        ClusterGraph.GetNumClusters(), ClusterGraph.GetNumNodes(), (uint64)ClusterGraph.GetAllocatedSize(),
+        (uint64)ClusterGraph.GetSearchAllocatedSize(), (uint64)FGridAStar::Get().GetAllocatedSize());
+    return FailureCount;
+}
+
+int32 UPathPlanner::GetBreadthFirstDistance(AGridManager* GridManager, FIntPoint StartGrid, FIntPoint GoalGrid)
+{
+    if (StartGrid == GoalGrid)
+    {
+        return 0;
+    }
+
+    TMap<FIntPoint, int32> Distances;
+    TArray<FIntPoint> Queue;
+    Distances.Add(StartGrid, 0);
+    Queue.Add(StartGrid);
+    for (int32 Head = 0; Head < Queue.Num(); ++Head)
+    {
+        const FIntPoint Grid = Queue[Head];
+        const int32 Distance = Distances[Grid];
+        bool bReachedGoal = false;
+        FGridTopology4::ForEachNeighbor(Grid, [&](FIntPoint Next, int32)
+        {
+            if (!bReachedGoal && GridManager->IsGridWalkable(Next) && !Distances.Contains(Next))
+            {
+                Distances.Add(Next, Distance + 1);
+                Queue.Add(Next);
+                bReachedGoal = Next == GoalGrid;
+            }
+        });
+        if (bReachedGoal)
+        {
+            return Distance + 1;
+        }
+    }
+    return INDEX_NONE;
+}
+
 bool UPathPlanner::ValidatePath(
     AGridManager* GridManager,
     const TArray<FIntPoint>& Path,
@@ -286,11 +632,31 @@ bool UPathPlanner::IsGridPassable(
     return ActorAtGrid == nullptr;
 }
 
+void UPathPlanner::AppendStraightPath(
+    TArray<FIntPoint>& Path,
+    FIntPoint& CurrentGrid,
+    FIntPoint Direction,
+    int32 Steps)
+{
+    Path.Reserve(Path.Num() + Steps);
+    for (int32 Step = 0; Step < Steps; ++Step)
+    {
+        CurrentGrid += Direction;
+        Path.Add(CurrentGrid);
+    }
+}
+
 AActor* UPathPlanner::GetActorAtGrid(
     AGridManager* GridManager,
     FIntPoint Grid,
-    AActor* IgnoreActor)
+    AActor* IgnoreActor,
+    int32 FootprintSize)
 {
+    if (FootprintSize > 1)
+    {
+        return GridManager->GetActorInFootprint(Grid, FootprintSize, IgnoreActor);
+    }
+
     AActor* ActorAtGrid = GridManager->GetActorAtGrid(Grid);
     if (ActorAtGrid == IgnoreActor)
     {
@@ -3,10 +3,11 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "GridDisplacementRequest.h"
+#include "GridPathTypes.h"
 #include "PathPlanner.generated.h"
 
 /**
- * ·滮λ͵·
+ * ·滮λ͵·ԼɫڸӼߵѰ·
  * һְֻ·㣬ͻ
  */
 UCLASS()
@@ -47,6 +48,49 @@ public:
         AActor* IgnoreActor = nullptr
     );
 
+    // ķ A* Ѱ·ƶĲ + ɫռλõǰ̵߳ĽڵأԤȺѯڴ
+    // ᰴ GridManager ľͼȱϷ̣߳߳ UGridPathService
+    UFUNCTION(BlueprintCallable, Category = "PathPlanner")
+    static FGridPathResult FindPath(
+        AGridManager* GridManager,
+        FIntPoint StartGrid,
+        FIntPoint GoalGrid,
+        const FGridPathConstraints& Constraints
+    );
+
+    // JPS+ Ѱ·ֻΡÿΪ 1ص·չͳһҲýɫʱ FindPath Զ
+    UFUNCTION(BlueprintCallable, Category = "PathPlanner")
+    static FGridPathResult FindPathJPS(
+        AGridManager* GridManager,
+        FIntPoint StartGrid,
+        FIntPoint GoalGrid,
+        int32 MaxExpandedNodes = 0
+    );
+
+    // ԣȡ߸ӶԣȽ JPS+ ·ȣزһµĴ
+    UFUNCTION(BlueprintCallable, Category = "PathPlanner|Debug")
+    static int32 ValidateJumpPointSearch(AGridManager* GridManager, int32 NumSamples = 256, int32 Seed = 0);
+
+    // HPA* ֲѰ·1x1 ɫڴͼϰβMaxExpandedNodes Ƴͼչϸǰ RefineSegments Σ<= 0 ʾȫϸ
+    // ϸʱÿڴڰ FindPath ͬĹƶġռλ⣬߲ͨĶʹ bFound Ϊ false
+    UFUNCTION(BlueprintCallable, Category = "PathPlanner", meta = (AutoCreateRefTerm = "Constraints"))
+    static FGridHierarchicalPath FindHierarchicalPath(
+        AGridManager* GridManager,
+        FIntPoint StartGrid,
+        FIntPoint GoalGrid,
+        const FGridPathConstraints& Constraints,
+        int32 RefineSegments = 1
+    );
+
+    // ϸ NumSegments ΣConstraints Ӧ滮ʱͬӱ仯ռλĳ߲ͨʱ false÷Ӧ¹滮
+    UFUNCTION(BlueprintCallable, Category = "PathPlanner", meta = (AutoCreateRefTerm = "Constraints"))
+    static bool RefineHierarchicalPath(AGridManager* GridManager, UPARAM(ref) FGridHierarchicalPath& Path,
+        const FGridPathConstraints& Constraints, int32 NumSegments = 1);
+
+    // ԣӶϱȽϷֲ·ֻΣƽ A* ĿɴԺͲʱڴԱȣҲ··ЧĴ
+    UFUNCTION(BlueprintCallable, Category = "PathPlanner|Debug")
+    static int32 ValidateHierarchicalPaths(AGridManager* GridManager, int32 NumSamples = 64, int32 Seed = 0);
+
     // ֤·ǷȻЧ֤
     UFUNCTION(BlueprintCallable, Category = "PathPlanner")
     static bool ValidatePath(
@@ -55,7 +99,14 @@ public:
         AActor* IgnoreActor = nullptr
     );
 
+    // ӵĴۣFindPath ֲ·ϸãվɫռݷ 0ԼȡƶĻ 1
+    static int32 GetPathEnterCost(AGridManager* GridManager, FIntPoint Grid, FIntPoint GoalGrid,
+        const FGridPathConstraints& Constraints, int32 FootprintSize);
+
 private:
+    // ̲ValidateJumpPointSearch Ĳգɴﷵ INDEX_NONE
+    static int32 GetBreadthFirstDistance(AGridManager* GridManager, FIntPoint StartGrid, FIntPoint GoalGrid);
+
     // 鵥Ƿͨ
     static bool IsGridPassable(
         AGridManager* GridManager,
@@ -63,11 +114,20 @@ private:
         AActor* IgnoreActor
     );
 
-    // ϵĽɫ
+    //  Direction ǰ Steps ·÷ͨϰȷЩӳͨ
+    static void AppendStraightPath(
+        TArray<FIntPoint>& Path,
+        FIntPoint& CurrentGrid,
+        FIntPoint Direction,
+        int32 Steps
+    );
+
+    // ϵĽɫFootprintSize > 1 ʱ Grid ΪСǵռ
     static AActor* GetActorAtGrid(
         AGridManager* GridManager,
         FIntPoint Grid,
-        AActor* IgnoreActor
+        AActor* IgnoreActor,
+        int32 FootprintSize = 1
     );
 
     // ֤·
@@ -0,0 +1,104 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridTacticsWorldSubsystem.h"
+#include "GridMovement/GridManager.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "EngineUtils.h"
+
+UGridTacticsWorldSubsystem* UGridTacticsWorldSubsystem::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    const UWorld* World = WorldContextObject->GetWorld();
+    return World ? World->GetSubsystem<UGridTacticsWorldSubsystem>() : nullptr;
+}
+
+AGridManager* UGridTacticsWorldSubsystem::GetGridManagerFor(const UObject* WorldContextObject)
+{
+    const UGridTacticsWorldSubsystem* Subsystem = Get(WorldContextObject);
+    return Subsystem ? Subsystem->GetGridManager() : nullptr;
+}
+
+AGridManager* UGridTacticsWorldSubsystem::GetGridManager() const
+{
+    return GridManager.Get();
+}
+
+void UGridTacticsWorldSubsystem::RegisterGridManager(AGridManager* InGridManager)
+{
+    if (!InGridManager)
+    {
+        return;
+    }
+
+    if (GridManager.IsValid() && GridManager.Get() != InGridManager)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("GridTacticsWorldSubsystem: %s is already registered, ignoring %s"),
+            *GridManager->GetName(), *InGridManager->GetName());
+        return;
+    }
+
+    GridManager = InGridManager;
+    UE_LOG(LogTemp, Log, TEXT("GridTacticsWorldSubsystem: Registered %s"), *InGridManager->GetName());
+}
+
+void UGridTacticsWorldSubsystem::UnregisterGridManager(AGridManager* InGridManager)
+{
+    if (GridManager.Get() == InGridManager)
+    {
+        GridManager.Reset();
+        UE_LOG(LogTemp, Log, TEXT("GridTacticsWorldSubsystem: Unregistered %s"),
+            InGridManager ? *InGridManager->GetName() : TEXT("NULL"));
+    }
+}
+
+void UGridTacticsWorldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(
+        this, &UGridTacticsWorldSubsystem::HandleLevelRemovedFromWorld);
+
+    // 子系统晚于关卡 Actor 创建时（例如 PIE 重启），补登记已存在的 GridManager
+    if (UWorld* World = GetWorld())
+    {
+        for (TActorIterator<AGridManager> It(World); It; ++It)
+        {
+            RegisterGridManager(*It);
+            break;
+        }
+    }
+}
+
+void UGridTacticsWorldSubsystem::Deinitialize()
+{
+    FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+    GridManager.Reset();
+
+    Super::Deinitialize();
+}
+
+bool UGridTacticsWorldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // 只在游戏和 PIE 世界中创建
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGridTacticsWorldSubsystem::HandleLevelRemovedFromWorld(ULevel* InLevel, UWorld* InWorld)
+{
+    if (InWorld != GetWorld())
+    {
+        return;
+    }
+
+    // InLevel 为空表示整个世界的关卡都被移除
+    if (!GridManager.IsValid() || !InLevel || GridManager->GetLevel() == InLevel)
+    {
+        GridManager.Reset();
+    }
+}
\ No newline at end of file
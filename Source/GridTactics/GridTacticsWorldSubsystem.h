@@ -0,0 +1,55 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GridTacticsWorldSubsystem.generated.h"
+
+class AGridManager;
+class ULevel;
+
+/**
+ * 世界子系统：持有当前世界的 GridManager
+ * GridManager 在初始化时自行注册，调用方通过 Get() 以 O(1) 获取，
+ * 不再需要 GetActorOfClass 遍历场景
+ */
+UCLASS()
+class GRIDTACTICS_API UGridTacticsWorldSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /** 获取子系统（WorldContextObject 为空或不在游戏世界时返回 nullptr） */
+    static UGridTacticsWorldSubsystem* Get(const UObject* WorldContextObject);
+
+    /** 便捷接口：直接获取 GridManager */
+    static AGridManager* GetGridManagerFor(const UObject* WorldContextObject);
+
+    /** 获取当前注册的 GridManager */
+    UFUNCTION(BlueprintPure, Category = "Grid")
+    AGridManager* GetGridManager() const;
+
+    /** 注册 GridManager（由 AGridManager 调用） */
+    void RegisterGridManager(AGridManager* InGridManager);
+
+    /** 注销 GridManager（由 AGridManager 调用） */
+    void UnregisterGridManager(AGridManager* InGridManager);
+
+    // --- USubsystem ---
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    /** 当前世界的 GridManager */
+    UPROPERTY()
+    TWeakObjectPtr<AGridManager> GridManager;
+
+    /** GridManager 所在关卡被流式卸载时清空缓存 */
+    void HandleLevelRemovedFromWorld(ULevel* InLevel, UWorld* InWorld);
+
+    FDelegateHandle LevelRemovedHandle;
+};
\ No newline at end of file
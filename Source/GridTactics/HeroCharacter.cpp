@@ -284,13 +284,29 @@ void AHeroCharacter::UpdateTargetedSkillRange(const USkillDataAsset* SkillData,
     FIntPoint MouseGrid(MouseX, MouseY);
 
     // 如果鼠标在施法范围内，显示效果范围（红色）
-    if (CastRangeGrids.Contains(MouseGrid))
+    if (IsGridInSkillRange(SkillData, MouseGrid))
     {
         TArray<FIntPoint> EffectGrids = GetSkillRangeInWorldFromCenter(SkillData->EffectPattern, MouseGrid);
         ShowEffectIndicators(EffectGrids); // 需要在蓝图中实现
     }
 }
 
+bool AHeroCharacter::IsGridInSkillRange(const USkillDataAsset* SkillData, FIntPoint TargetGrid) const
+{
+    if (!SkillData || !GridMovementComponent)
+    {
+        return false;
+    }
+
+    int32 CurrentX, CurrentY;
+    GridMovementComponent->GetCurrentGrid(CurrentX, CurrentY);
+
+    // 把目标转回角色本地坐标，再查未旋转的范围位掩码
+    const int32 QuarterTurns = FGridPatternMask::YawToQuarterTurns(GetActorRotation().Yaw);
+    const FIntPoint LocalOffset = FGridPatternMask::UnrotateOffset(TargetGrid - FIntPoint(CurrentX, CurrentY), QuarterTurns);
+    return SkillData->GetRangePatternMask().Contains(LocalOffset);
+}
+
 // 基于特定中心点计算范围
 TArray<FIntPoint> AHeroCharacter::GetSkillRangeInWorldFromCenter(const TArray<FIntPoint>& Pattern, FIntPoint CenterGrid) const
 {
@@ -301,17 +317,13 @@ TArray<FIntPoint> AHeroCharacter::GetSkillRangeInWorldFromCenter(const TArray<FI
         return WorldGrids;
     }
 
-    // 修改：强制使用四向对齐的朝向
-    const FRotator CurrentRotation = GetActorRotation();
-    const FRotator SnappedRotation = UGridMovementComponent::SnapRotationToFourDirections(CurrentRotation);
+    // 强制使用四向对齐的朝向
+    const int32 QuarterTurns = FGridPatternMask::YawToQuarterTurns(GetActorRotation().Yaw);
 
+    WorldGrids.Reserve(Pattern.Num());
     for (const FIntPoint& RelativePos : Pattern)
     {
-        const FVector LocalPosVec(RelativePos.X, RelativePos.Y, 0);
-        const FVector RotatedVec = SnappedRotation.RotateVector(LocalPosVec);  // 使用对齐后的旋转
-        const FIntPoint RotatedOffset(FMath::RoundToInt(RotatedVec.X), FMath::RoundToInt(RotatedVec.Y));
-
-        WorldGrids.Add(CenterGrid + RotatedOffset);
+        WorldGrids.Add(CenterGrid + FGridPatternMask::RotateOffset(RelativePos, QuarterTurns));
     }
 
     return WorldGrids;
@@ -380,21 +392,13 @@ TArray<FIntPoint> AHeroCharacter::GetSkillRangeInWorld(const TArray<FIntPoint>&
 	GridMovementComponent->GetCurrentGrid(CurrentX, CurrentY);
 
 
-	const FRotator CurrentRotation = GetActorRotation();
-	const FRotator SnappedRotation = UGridMovementComponent::SnapRotationToFourDirections(CurrentRotation);
+	// 朝向对齐到四方向后按 90° 整数旋转，不再逐点做浮点旋转
+	const int32 QuarterTurns = FGridPatternMask::YawToQuarterTurns(GetActorRotation().Yaw);
 
+	WorldGrids.Reserve(Pattern.Num());
 	for (const FIntPoint& RelativePos : Pattern)
 	{
-		// 将模板中的本地坐标 (相对于+X) 转换为 FVector
-		const FVector LocalPosVec(RelativePos.X, RelativePos.Y, 0);
-
-		// 使用角色当前的旋转来旋转这个向量
-		// const FVector RotatedVec = CurrentRotation.RotateVector(LocalPosVec);
-		const FVector RotatedVec = SnappedRotation.RotateVector(LocalPosVec);  // 使用对齐后的旋转
-
-		// 将旋转后的世界空间偏移向量，四舍五入为网格偏移
-		const FIntPoint RotatedOffset(FMath::RoundToInt(RotatedVec.X), FMath::RoundToInt(RotatedVec.Y));
-
+		const FIntPoint RotatedOffset = FGridPatternMask::RotateOffset(RelativePos, QuarterTurns);
 		WorldGrids.Add(FIntPoint(CurrentX + RotatedOffset.X, CurrentY + RotatedOffset.Y));
 	}
 
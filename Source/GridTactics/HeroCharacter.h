@@ -116,6 +116,10 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Skills")
 	TArray<FIntPoint> GetSkillRangeInWorldFromCenter(const TArray<FIntPoint>& Pattern, FIntPoint CenterGrid) const;
 
+	// 目标格子是否在技能施法范围内（考虑朝向），直接查 RangePattern 位掩码
+	UFUNCTION(BlueprintPure, Category = "Skills")
+	bool IsGridInSkillRange(const USkillDataAsset* SkillData, FIntPoint TargetGrid) const;
+
 	UFUNCTION(BlueprintImplementableEvent, Category = "Skills")
 	void ShowRangeIndicators(const TArray<FIntPoint>& GridsToHighlight);
 
@@ -8,6 +8,8 @@
 #include "SkillComponent.h"
 #include "GridTactics/GridMovement/GridMovementComponent.h"
 #include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridTopology.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
 #include "GridTactics/AttributesComponent.h"
 #include "SkillEffect.h"
 #include "Kismet/KismetSystemLibrary.h"
@@ -207,9 +209,7 @@ FIntPoint UBaseSkill::GetTargetGrid() const
         return FIntPoint::ZeroValue;
     }
 
-    AGridManager* GridMgr = Cast<AGridManager>(
-        UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass())
-    );
+    AGridManager* GridMgr = UGridTacticsWorldSubsystem::GetGridManagerFor(GetWorld());
 
     if (!GridMgr)
     {
@@ -280,24 +280,9 @@ TArray<AActor*> UBaseSkill::GetAffectedActors(FIntPoint TargetGrid) const
         FRotator ActorRotation = OwnerCharacter->GetActorRotation();
         float Yaw = ActorRotation.Yaw;
         
-        // 将朝向转换为四向方向向量
-        FIntPoint Direction;
-        if (Yaw >= -45.0f && Yaw < 45.0f)
-        {
-            Direction = FIntPoint(1, 0);  // 东 (X+)
-        }
-        else if (Yaw >= 45.0f && Yaw < 135.0f)
-        {
-            Direction = FIntPoint(0, 1);  // 北 (Y+)
-        }
-        else if (Yaw >= 135.0f || Yaw < -135.0f)
-        {
-            Direction = FIntPoint(-1, 0);  // 西 (X-)
-        }
-        else
-        {
-            Direction = FIntPoint(0, -1);  // 南 (Y-)
-        }
+        // 将朝向转换为四向旋转次数（基准方向是 X+ (1, 0)）
+        const int32 QuarterTurns = FGridTopology4::RotationTurnsFromYaw(Yaw);
+        const FIntPoint Direction = FGridTopology4::GetDirection(QuarterTurns);
         
         UE_LOG(LogTemp, Log, TEXT("GetAffectedActors (Enemy): Yaw=%.1f, Direction=%s"), 
             Yaw, *Direction.ToString());
@@ -305,28 +290,7 @@ TArray<AActor*> UBaseSkill::GetAffectedActors(FIntPoint TargetGrid) const
         // 旋转 Pattern
         for (const FIntPoint& RelativePos : PatternToUse)
         {
-            FIntPoint RotatedPos = FIntPoint::ZeroValue;
-            
-            // 旋转逻辑（基准方向是 X+ (1, 0)）
-            if (Direction.X == 1 && Direction.Y == 0) // 东 (X+), 基准方向
-            {
-                RotatedPos = RelativePos;
-            }
-            else if (Direction.X == -1 && Direction.Y == 0) // 西 (X-), 旋转180度
-            {
-                RotatedPos.X = -RelativePos.X;
-                RotatedPos.Y = -RelativePos.Y;
-            }
-            else if (Direction.X == 0 && Direction.Y == 1) // 北 (Y+), 逆时针旋转90度
-            {
-                RotatedPos.X = -RelativePos.Y;
-                RotatedPos.Y = RelativePos.X;
-            }
-            else if (Direction.X == 0 && Direction.Y == -1) // 南 (Y-), 顺时针旋转90度
-            {
-                RotatedPos.X = RelativePos.Y;
-                RotatedPos.Y = -RelativePos.X;
-            }
+            const FIntPoint RotatedPos = FGridTopology4::Rotate(RelativePos, QuarterTurns);
             
             WorldGrids.Add(TargetGrid + RotatedPos);
             
@@ -372,31 +336,26 @@ TArray<AActor*> UBaseSkill::GetAffectedActors(FIntPoint TargetGrid) const
 
 
 
-    // 备选方案：遍历所有角色，检查其网格位置
-    TArray<AActor*> AllCharacters;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ACharacter::StaticClass(), AllCharacters);
-
-    UE_LOG(LogTemp, Warning, TEXT("=== GetAffectedActors (Grid-Based) ==="));
-    UE_LOG(LogTemp, Warning, TEXT("TargetType: %d, TargetGrid: %s"), 
-        static_cast<int32>(SkillData->TargetType), *TargetGrid.ToString());
-    UE_LOG(LogTemp, Warning, TEXT("WorldGrids: %d, AllCharacters: %d"), WorldGrids.Num(), AllCharacters.Num());
-
-    for (AActor* Actor : AllCharacters)
+    // 通过 GridManager 的占位索引逐格查询，开销只与 Pattern 大小相关
+    AGridManager* GridMgr = UGridTacticsWorldSubsystem::GetGridManagerFor(GetWorld());
+    if (!GridMgr)
     {
-        if (!Actor) continue;
-
-        // 获取角色所在的网格
-        int32 ActorGridX, ActorGridY;
-        MovementComp->WorldToGrid(Actor->GetActorLocation(), ActorGridX, ActorGridY);
-        FIntPoint ActorGrid(ActorGridX, ActorGridY);
+        UE_LOG(LogTemp, Error, TEXT("GetAffectedActors: GridManager not found"));
+        return AffectedActors;
+    }
 
-        UE_LOG(LogTemp, Log, TEXT("  Character %s at Grid %s"),
-            *Actor->GetName(), *ActorGrid.ToString());
+    UE_LOG(LogTemp, Log, TEXT("=== GetAffectedActors (Grid-Based) ==="));
+    UE_LOG(LogTemp, Log, TEXT("TargetType: %d, TargetGrid: %s, WorldGrids: %d"), 
+        static_cast<int32>(SkillData->TargetType), *TargetGrid.ToString(), WorldGrids.Num());
 
-        // 检查是否在目标网格列表中
-        if (WorldGrids.Contains(ActorGrid))
+    TArray<AActor*> ActorsInGrid;
+    for (const FIntPoint& Grid : WorldGrids)
+    {
+        GridMgr->GetActorsInRect(Grid, Grid, ActorsInGrid);
+        for (AActor* Actor : ActorsInGrid)
         {
-            UE_LOG(LogTemp, Warning, TEXT("    -> MATCHED! Adding to AffectedActors"));
+            UE_LOG(LogTemp, Log, TEXT("  Character %s at Grid %s -> MATCHED"),
+                *Actor->GetName(), *Grid.ToString());
             AffectedActors.AddUnique(Actor);
 
             // 可视化：绘制命中的角色（红色）
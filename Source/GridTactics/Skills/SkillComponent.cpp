@@ -5,6 +5,7 @@
 #include "SkillDataAsset.h"
 #include "SkillEffect.h"
 #include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
 #include "BaseSkill.h"
 #include "GridTactics/HeroCharacter.h"
 #include "GridTactics/EnemyCharacter.h"
@@ -120,8 +121,7 @@ void USkillComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActor
 				);
 
 				// 转换为网格坐标
-				if (AGridManager* GridMgr = Cast<AGridManager>(
-					UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass())))
+				if (AGridManager* GridMgr = UGridTacticsWorldSubsystem::GetGridManagerFor(GetWorld()))
 				{
 					AimingTargetGrid = GridMgr->WorldToGrid(MouseGroundPos);
 				}
@@ -201,13 +201,12 @@ void USkillComponent::TryConfirmSkill()
         // 获取当前瞄准的目标格子
         FIntPoint TargetGrid = GetAimingTargetGrid();
         
-        // 获取技能的有效施法范围
-        TArray<FIntPoint> ValidRangeGrids;
+        // 检查目标格子是否在有效施法范围内（考虑朝向）
+        bool bInRange = false;
         
         if (AHeroCharacter* HeroChar = Cast<AHeroCharacter>(OwnerCharacter))
         {
-            // 获取玩家角色的技能范围（考虑朝向）
-            ValidRangeGrids = HeroChar->GetSkillRangeInWorld(SkillData->RangePattern);
+            bInRange = HeroChar->IsGridInSkillRange(SkillData, TargetGrid);
         }
         else
         {
@@ -215,8 +214,7 @@ void USkillComponent::TryConfirmSkill()
             UE_LOG(LogTemp, Warning, TEXT("SkillComponent: Range validation not implemented for non-HeroCharacter"));
         }
         
-        // 检查目标格子是否在有效范围内
-        if (!ValidRangeGrids.Contains(TargetGrid))
+        if (!bInRange)
         {
             UE_LOG(LogTemp, Warning, TEXT("SkillComponent: Target grid %s is NOT in skill range! Cancelling."), 
                 *TargetGrid.ToString());
@@ -3,3 +3,40 @@
 
 #include "SkillDataAsset.h"
 
+
+const FGridPatternMask& USkillDataAsset::GetRangePatternMask(int32 QuarterTurns) const
+{
+	BuildPatternMasks();
+	return RangePatternMasks[QuarterTurns & 3];
+}
+
+const FGridPatternMask& USkillDataAsset::GetEffectPatternMask(int32 QuarterTurns) const
+{
+	BuildPatternMasks();
+	return EffectPatternMasks[QuarterTurns & 3];
+}
+
+void USkillDataAsset::BuildPatternMasks() const
+{
+	if (bPatternMasksBuilt)
+	{
+		return;
+	}
+
+	for (int32 QuarterTurns = 0; QuarterTurns < 4; ++QuarterTurns)
+	{
+		RangePatternMasks[QuarterTurns] = FGridPatternMask::Build(RangePattern, QuarterTurns);
+		EffectPatternMasks[QuarterTurns] = FGridPatternMask::Build(EffectPattern, QuarterTurns);
+	}
+	bPatternMasksBuilt = true;
+}
+
+#if WITH_EDITOR
+void USkillDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// 模板被编辑后下次访问时重新构建
+	bPatternMasksBuilt = false;
+}
+#endif
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
 #include "GridTactics/GridTacticsPlayerState.h"
+#include "GridTactics/GridMovement/GridBitboard.h"
 #include "SkillDataAsset.generated.h"
 
 // 技能目标类型
@@ -105,4 +106,19 @@ public:
 	UPROPERTY(EditAnywhere, Instanced, Category = "Skill Effects", meta = (DisplayName = "Skill Effects (Required)"))
 	TArray<TObjectPtr<class USkillEffect>> SkillEffects;
 
+	// 按朝向（90° 旋转次数）取 RangePattern / EffectPattern 的位掩码，首次访问时构建
+	const FGridPatternMask& GetRangePatternMask(int32 QuarterTurns = 0) const;
+	const FGridPatternMask& GetEffectPatternMask(int32 QuarterTurns = 0) const;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	void BuildPatternMasks() const;
+
+	mutable FGridPatternMask RangePatternMasks[4];
+	mutable FGridPatternMask EffectPatternMasks[4];
+	mutable bool bPatternMasksBuilt = false;
+
 };
@@ -2,6 +2,7 @@
 
 #include "SkillEffect.h"
 #include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridTacticsWorldSubsystem.h"
 #include "GridTactics/AttributesComponent.h"
 #include "BaseSkill.h"
 #include "Kismet/GameplayStatics.h"
@@ -34,9 +35,7 @@ AGridManager* USkillEffect::GetGridManager(AActor* WorldContextObject) const
         return nullptr;
     }
 
-    AGridManager* GridMgr = Cast<AGridManager>(
-        UGameplayStatics::GetActorOfClass(World, AGridManager::StaticClass())
-    );
+    AGridManager* GridMgr = UGridTacticsWorldSubsystem::GetGridManagerFor(World);
 
     if (!GridMgr)
     {
@@ -113,6 +113,9 @@ bool USkillEffect_Teleport::Execute_Implementation(AActor* Instigator, FIntPoint
             FRotator SnappedRotation = UGridMovementComponent::SnapRotationToFourDirections(CurrentRotation);
             Instigator->SetActorRotation(SnappedRotation);
             MovementComp->SetTargetRotation(SnappedRotation);
+
+            // 瞬移绕过了移动组件，需要手动提交逻辑格子
+            MovementComp->CommitOccupiedGrid(TargetGrid);
         }
 
         UE_LOG(LogTemp, Log, TEXT("SkillEffect_Teleport: %s instantly teleported to %s"), *Instigator->GetName(), *TargetGrid.ToString());
@@ -3,6 +3,7 @@
 #include "SkillEffect_VFX.h"
 #include "GridTactics/GridMovement/GridManager.h"
 #include "GridTactics/GridMovement/GridMovementComponent.h"
+#include "GridTactics/GridMovement/GridTopology.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraComponent.h"
 #include "Kismet/GameplayStatics.h"
@@ -240,67 +241,45 @@ FVector USkillEffect_VFX::CalculateProjectileEndLocation(AActor* Instigator, FIn
         return Instigator->GetActorLocation();
     }
 
+    const FIntPoint StartGrid = GridMgr->GetActorCurrentGrid(Instigator);
+    auto ClipToWalls = [this, GridMgr, StartGrid](FIntPoint EndGrid)
+    {
+        if (bStopProjectileAtWalls)
+        {
+            bool bBlocked = false;
+            EndGrid = GridMgr->TraceGridLine(StartGrid, EndGrid, EGridSightBlocker::Walls, bBlocked);
+        }
+        return GridMgr->GridToWorld(EndGrid);
+    };
+
     switch (ProjectileTargetMode)
     {
     case EProjectileTargetMode::ToTargetGrid:
         // 使用技能的目标格子
-        return GridMgr->GridToWorld(TargetGrid);
+        return ClipToWalls(TargetGrid);
 
     case EProjectileTargetMode::ToDirection:
         {
             // 沿角色朝向飞行指定网格距离
             
             // 1. 获取角色当前网格位置
-            FIntPoint CurrentGrid = GridMgr->GetActorCurrentGrid(Instigator);
+            const FIntPoint CurrentGrid = StartGrid;
             
             // 2. 获取角色朝向（转换为网格方向）
             FRotator ActorRotation = Instigator->GetActorRotation();
-            float Yaw = ActorRotation.Yaw;
             
-            // 3. 将朝向转换为网格方向向量
-            FIntPoint Direction;
-            if (Yaw >= -22.5f && Yaw < 22.5f)
-            {
-                Direction = FIntPoint(1, 0);   // 东
-            }
-            else if (Yaw >= 22.5f && Yaw < 67.5f)
-            {
-                Direction = FIntPoint(1, 1);   // 东北
-            }
-            else if (Yaw >= 67.5f && Yaw < 112.5f)
-            {
-                Direction = FIntPoint(0, 1);   // 北
-            }
-            else if (Yaw >= 112.5f && Yaw < 157.5f)
-            {
-                Direction = FIntPoint(-1, 1);  // 西北
-            }
-            else if (Yaw >= 157.5f || Yaw < -157.5f)
-            {
-                Direction = FIntPoint(-1, 0);  // 西
-            }
-            else if (Yaw >= -157.5f && Yaw < -112.5f)
-            {
-                Direction = FIntPoint(-1, -1); // 西南
-            }
-            else if (Yaw >= -112.5f && Yaw < -67.5f)
-            {
-                Direction = FIntPoint(0, -1);  // 南
-            }
-            else // -67.5f ~ -22.5f
-            {
-                Direction = FIntPoint(1, -1);  // 东南
-            }
+            // 3. 将朝向转换为网格方向向量（八方向）
+            const FIntPoint Direction = FGridTopology8::GetDirection(FGridTopology8::DirectionIndexFromYaw(ActorRotation.Yaw));
             
             // 4. 计算目标网格位置 = 当前位置 + 方向 × 距离
             FIntPoint TargetGridPos = CurrentGrid + (Direction * ProjectileGridDistance);
             
-            // 5. 转换为世界坐标
-            return GridMgr->GridToWorld(TargetGridPos);
+            // 5. 遇墙截断并转换为世界坐标
+            return ClipToWalls(TargetGridPos);
         }
 
     default:
-        return GridMgr->GridToWorld(TargetGrid);
+        return ClipToWalls(TargetGrid);
     }
 }
 
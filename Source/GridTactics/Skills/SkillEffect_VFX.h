@@ -121,6 +121,10 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VFX|Movement", meta = (EditCondition = "bEnableProjectileMovement"))
     float ProjectileSpeed = 1000.0f;
 
+    // 弹道在第一堵墙（Blocked 格子）前停下
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VFX|Movement", meta = (EditCondition = "bEnableProjectileMovement"))
+    bool bStopProjectileAtWalls = true;
+
     // 新增：弹道弧度（0 = 直线，1 = 高抛物线）
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VFX|Movement", meta = (EditCondition = "bEnableProjectileMovement", ClampMin = "0.0", ClampMax = "1.0"))
     float ProjectileArc = 0.3f;
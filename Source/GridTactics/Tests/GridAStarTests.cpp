@@ -0,0 +1,275 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridAStar.h"
+#include "GridTactics/GridMovement/GridTopology.h"
+#include "GridTactics/GridMovement/PathPlanner.h"
+#include "HAL/PlatformTime.h"
+
+namespace GridAStarTests
+{
+    // 独立的参照：在测试自己维护的代价表上跑 Dijkstra，进入格子的代价为其移动消耗，0 为不可进入
+    struct FReference
+    {
+        FIntPoint Size;
+        TArray<int32> EnterCosts;
+
+        int32 ToIndex(FIntPoint Grid) const
+        {
+            if (Grid.X < 0 || Grid.Y < 0 || Grid.X >= Size.X || Grid.Y >= Size.Y)
+            {
+                return INDEX_NONE;
+            }
+            return Grid.Y * Size.X + Grid.X;
+        }
+
+        int32 GetEnterCost(FIntPoint Grid) const
+        {
+            const int32 Index = ToIndex(Grid);
+            return Index != INDEX_NONE ? EnterCosts[Index] : 0;
+        }
+
+        // 最小总代价，不可达返回 INDEX_NONE
+        int32 ShortestCost(FIntPoint Start, FIntPoint Goal, int32 GoalEnterCost) const
+        {
+            TArray<int32> Costs;
+            Costs.Init(MAX_int32, Size.X * Size.Y);
+            TArray<TPair<int32, int32>> Open;
+            Costs[ToIndex(Start)] = 0;
+            Open.HeapPush(TPair<int32, int32>(0, ToIndex(Start)));
+            while (Open.Num() > 0)
+            {
+                TPair<int32, int32> Node;
+                Open.HeapPop(Node);
+                if (Node.Key != Costs[Node.Value])
+                {
+                    continue;
+                }
+                const FIntPoint Grid(Node.Value % Size.X, Node.Value / Size.X);
+                if (Grid == Goal)
+                {
+                    return Node.Key;
+                }
+                FGridTopology4::ForEachNeighbor(Grid, [&](FIntPoint Next, int32)
+                {
+                    const int32 NextIndex = ToIndex(Next);
+                    const int32 StepCost = Next == Goal ? GoalEnterCost : GetEnterCost(Next);
+                    if (NextIndex != INDEX_NONE && StepCost > 0 && Node.Key + StepCost < Costs[NextIndex])
+                    {
+                        Costs[NextIndex] = Node.Key + StepCost;
+                        Open.HeapPush(TPair<int32, int32>(Costs[NextIndex], NextIndex));
+                    }
+                });
+            }
+            return INDEX_NONE;
+        }
+    };
+
+    // 路径首尾正确、逐步相邻、都可进入，且代价之和等于报告的代价
+    bool IsPathConsistent(const FGridPathResult& Result, const FReference& Reference, FIntPoint Start, FIntPoint Goal, int32 GoalEnterCost)
+    {
+        if (Result.Path.Num() == 0 || Result.Path[0] != Start || Result.Path.Last() != Goal)
+        {
+            return false;
+        }
+        int32 Cost = 0;
+        for (int32 Index = 1; Index < Result.Path.Num(); ++Index)
+        {
+            const FIntPoint Step = Result.Path[Index] - Result.Path[Index - 1];
+            const int32 StepCost = Result.Path[Index] == Goal ? GoalEnterCost : Reference.GetEnterCost(Result.Path[Index]);
+            if (FMath::Abs(Step.X) + FMath::Abs(Step.Y) != 1 || StepCost <= 0)
+            {
+                return false;
+            }
+            Cost += StepCost;
+        }
+        return Cost == Result.Cost;
+    }
+
+    FIntPoint RandomWalkableGrid(const FGridTestWorld& TestWorld, FRandomStream& Random)
+    {
+        for (;;)
+        {
+            const FIntPoint Grid(Random.RandHelper(TestWorld.GetSize().X), Random.RandHelper(TestWorld.GetSize().Y));
+            if (FGridTestWorld::IsWalkableChar(TestWorld.GetCellChar(Grid)))
+            {
+                return Grid;
+            }
+        }
+    }
+}
+
+// 随机地图（带移动消耗与角色占位）上 FindPath 的代价与 Dijkstra 一致，路径本身合法
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridAStarMatchesDijkstraTest, "GridTactics.AStar.MatchesDijkstra",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridAStarMatchesDijkstraTest::RunTest(const FString& Parameters)
+{
+    using namespace GridAStarTests;
+
+    const FIntPoint Size(48, 40);
+    const int32 NumQueries = 200;
+
+    for (int32 Seed = 1; Seed <= 4; ++Seed)
+    {
+        FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.25f, 5, Seed));
+        AGridManager* GridManager = TestWorld.GetGridManager();
+        FRandomStream Random(Seed * 31);
+
+        TBitArray<> Occupied(false, Size.X * Size.Y);
+        for (int32 Index = 0; Index < 60; ++Index)
+        {
+            const FIntPoint Grid = RandomWalkableGrid(TestWorld, Random);
+            if (!Occupied[Grid.Y * Size.X + Grid.X])
+            {
+                Occupied[Grid.Y * Size.X + Grid.X] = true;
+                TestWorld.SpawnOccupant(Grid);
+            }
+        }
+
+        for (const bool bUseMoveCost : { true, false })
+        {
+            for (const bool bAvoidOccupied : { true, false })
+            {
+                FReference Reference;
+                Reference.Size = Size;
+                Reference.EnterCosts.SetNumZeroed(Size.X * Size.Y);
+                for (int32 Y = 0; Y < Size.Y; ++Y)
+                {
+                    for (int32 X = 0; X < Size.X; ++X)
+                    {
+                        const TCHAR Char = TestWorld.GetCellChar(FIntPoint(X, Y));
+                        const int32 Index = Y * Size.X + X;
+                        if (FGridTestWorld::IsWalkableChar(Char) && !(bAvoidOccupied && Occupied[Index]))
+                        {
+                            Reference.EnterCosts[Index] = bUseMoveCost ? Char - TEXT('0') : 1;
+                        }
+                    }
+                }
+
+                FGridPathConstraints Constraints;
+                Constraints.bUseMoveCost = bUseMoveCost;
+                Constraints.bAvoidOccupied = bAvoidOccupied;
+                Constraints.bAllowOccupiedGoal = true;
+
+                int32 MismatchCount = 0;
+                for (int32 Query = 0; Query < NumQueries; ++Query)
+                {
+                    const FIntPoint Start = RandomWalkableGrid(TestWorld, Random);
+                    const FIntPoint Goal = RandomWalkableGrid(TestWorld, Random);
+                    const TCHAR GoalChar = TestWorld.GetCellChar(Goal);
+                    const int32 GoalEnterCost = bUseMoveCost ? GoalChar - TEXT('0') : 1;
+
+                    const int32 Expected = Start == Goal ? 0 : Reference.ShortestCost(Start, Goal, GoalEnterCost);
+                    const FGridPathResult Result = UPathPlanner::FindPath(GridManager, Start, Goal, Constraints);
+
+                    const bool bMatches = Result.bFound
+                        ? Expected == Result.Cost && IsPathConsistent(Result, Reference, Start, Goal, GoalEnterCost)
+                        : Expected == INDEX_NONE;
+                    if (!bMatches && ++MismatchCount <= 8)
+                    {
+                        AddError(FString::Printf(TEXT("Seed %d cost %d avoid %d: %s -> %s found %d cost %d, expected %d"),
+                            Seed, bUseMoveCost, bAvoidOccupied, *Start.ToString(), *Goal.ToString(), Result.bFound, Result.Cost, Expected));
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// 节点池：Trim 超过上限时释放，之后的查询重新分配并得到相同结果
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridAStarTrimTest, "GridTactics.AStar.TrimReleasesPool",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridAStarTrimTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(64, 64);
+    auto GetEnterCost = [](FIntPoint Grid)
+    {
+        return (Grid.X == 32 && Grid.Y < 60) ? 0 : 1 + (Grid.X + Grid.Y) % 3;
+    };
+
+    FGridAStar Search;
+    TArray<FIntPoint> Path;
+    int32 Cost = 0;
+    TestTrue(TEXT("Found before trim"), Search.FindPath(FIntPoint::ZeroValue, Size, FIntPoint(0, 0), FIntPoint(63, 0), GetEnterCost, Path, Cost));
+    const int32 CostBeforeTrim = Cost;
+
+    const SIZE_T AllocatedSize = Search.GetAllocatedSize();
+    TestTrue(TEXT("Pool covers the search area"), AllocatedSize >= Size.X * Size.Y * sizeof(int32));
+
+    Search.Trim(AllocatedSize);
+    TestEqual(TEXT("Trim under the cap keeps the pool"), Search.GetAllocatedSize(), AllocatedSize);
+
+    Search.Trim(AllocatedSize - 1);
+    TestEqual(TEXT("Trim over the cap releases the pool"), Search.GetAllocatedSize(), (SIZE_T)0);
+
+    TestTrue(TEXT("Found after trim"), Search.FindPath(FIntPoint::ZeroValue, Size, FIntPoint(0, 0), FIntPoint(63, 0), GetEnterCost, Path, Cost));
+    TestEqual(TEXT("Same cost after trim"), Cost, CostBeforeTrim);
+    return true;
+}
+
+// 基准：64²、256²、1024² 随机带权地图上 FindPath（按移动消耗，不会分派到 JPS+）的单次耗时与扩展节点数
+// 同一组查询先跑一遍预热，计时的第二遍中节点池不再增长（预热后零分配）
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridAStarBenchmark, "GridTactics.Perf.AStar",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FGridAStarBenchmark::RunTest(const FString& Parameters)
+{
+    using namespace GridAStarTests;
+
+    const int32 MapSizes[] = { 64, 256, 1024 };
+    const int32 QueryCounts[] = { 1000, 256, 64 };
+    for (int32 SizeIndex = 0; SizeIndex < UE_ARRAY_COUNT(MapSizes); ++SizeIndex)
+    {
+        const FIntPoint Size(MapSizes[SizeIndex], MapSizes[SizeIndex]);
+        const int32 NumQueries = QueryCounts[SizeIndex];
+        FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.2f, 5, MapSizes[SizeIndex]));
+        AGridManager* GridManager = TestWorld.GetGridManager();
+        TestFalse(TEXT("Weighted map does not dispatch to JPS+"), GridManager->HasUniformMoveCost());
+
+        FRandomStream Random(MapSizes[SizeIndex]);
+        TArray<TPair<FIntPoint, FIntPoint>> Queries;
+        for (int32 Query = 0; Query < NumQueries; ++Query)
+        {
+            Queries.Emplace(RandomWalkableGrid(TestWorld, Random), RandomWalkableGrid(TestWorld, Random));
+        }
+
+        FGridPathConstraints Constraints;
+        Constraints.bUseMoveCost = true;
+
+        // 预热：节点数组按地图大小分配，开放堆增长到这组查询需要的最大值
+        for (const TPair<FIntPoint, FIntPoint>& Query : Queries)
+        {
+            UPathPlanner::FindPath(GridManager, Query.Key, Query.Value, Constraints);
+        }
+        const SIZE_T WarmAllocatedSize = FGridAStar::Get().GetAllocatedSize();
+
+        int64 ExpandedNodes = 0;
+        int32 NumFound = 0;
+        const double StartTime = FPlatformTime::Seconds();
+        for (const TPair<FIntPoint, FIntPoint>& Query : Queries)
+        {
+            const FGridPathResult Result = UPathPlanner::FindPath(GridManager, Query.Key, Query.Value, Constraints);
+            ExpandedNodes += Result.ExpandedNodes;
+            NumFound += Result.bFound ? 1 : 0;
+        }
+        const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+        TestEqual(FString::Printf(TEXT("%dx%d node pool does not grow after warm-up"), Size.X, Size.Y),
+            (int64)FGridAStar::Get().GetAllocatedSize(), (int64)WarmAllocatedSize);
+        AddInfo(FString::Printf(TEXT("%dx%d, %d queries (%d found): %.2f us per query, %.0f expanded nodes per query, node pool %llu bytes"),
+            Size.X, Size.Y, NumQueries, NumFound, ElapsedSeconds * 1000000.0 / NumQueries, (double)ExpandedNodes / NumQueries,
+            (uint64)WarmAllocatedSize));
+    }
+    return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,224 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/UnrealType.h"
+
+namespace GridBatchQueryTests
+{
+    // 范围指示器式的查询：以 Center 为中心的方形区域（含地图外的格子）
+    TArray<FIntPoint> MakeQueryGrids(FIntPoint Center, int32 Radius)
+    {
+        TArray<FIntPoint> Grids;
+        for (int32 Y = -Radius; Y <= Radius; ++Y)
+        {
+            for (int32 X = -Radius; X <= Radius; ++X)
+            {
+                Grids.Add(Center + FIntPoint(X, Y));
+            }
+        }
+        return Grids;
+    }
+
+    // 按反射调用 UFUNCTION（与蓝图 VM 调用原生函数的路径相同）
+    struct FReflectedCall
+    {
+        UObject* Target;
+        UFunction* Function;
+        TArray<uint8> Params;
+
+        FReflectedCall(UObject* InTarget, FName FunctionName)
+            : Target(InTarget)
+            , Function(InTarget->FindFunctionChecked(FunctionName))
+        {
+            Params.SetNumZeroed(Function->ParmsSize);
+            Function->InitializeStruct(Params.GetData());
+        }
+
+        ~FReflectedCall()
+        {
+            Function->DestroyStruct(Params.GetData());
+        }
+
+        template<typename T>
+        T& Param(FName Name)
+        {
+            return *Function->FindPropertyByName(Name)->ContainerPtrToValuePtr<T>(Params.GetData());
+        }
+
+        bool ReturnBool() const
+        {
+            return CastFieldChecked<FBoolProperty>(Function->GetReturnProperty())->GetPropertyValue_InContainer(Params.GetData());
+        }
+
+        void Invoke()
+        {
+            Target->ProcessEvent(Function, Params.GetData());
+        }
+    };
+}
+
+// 批量查询与逐格查询的结果一致（包括地图外与被占据的格子）
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridBatchQueryTest, "GridTactics.BatchQuery.MatchesPerCellQueries",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridBatchQueryTest::RunTest(const FString& Parameters)
+{
+    using namespace GridBatchQueryTests;
+
+    const FIntPoint Size(40, 40);
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.25f, 1, 3));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    FRandomStream Random(5);
+    for (int32 Index = 0; Index < 40; ++Index)
+    {
+        TestWorld.SpawnOccupant(FIntPoint(Random.RandHelper(Size.X), Random.RandHelper(Size.Y)));
+    }
+
+    const TArray<FIntPoint> Grids = MakeQueryGrids(FIntPoint(2, 20), 8);
+
+    TArray<bool> Valid, Walkable;
+    TArray<AActor*> Actors;
+    GridManager->BatchQueryGrids(Grids, Valid, Walkable, Actors);
+
+    TBitArray<> ValidBits, WalkableBits;
+    TArray<AActor*> BatchActors;
+    GridManager->BatchIsGridValid(Grids, ValidBits);
+    GridManager->BatchIsGridWalkable(Grids, WalkableBits);
+    GridManager->BatchGetActorAtGrid(Grids, BatchActors);
+
+    TArray<FIntPoint> Filtered, FilteredUnoccupied;
+    GridManager->FilterWalkableGrids(Grids, Filtered, false);
+    GridManager->FilterWalkableGrids(Grids, FilteredUnoccupied, true);
+
+    TArray<FIntPoint> ExpectedFiltered, ExpectedUnoccupied;
+    for (int32 Index = 0; Index < Grids.Num(); ++Index)
+    {
+        const FIntPoint Grid = Grids[Index];
+        const bool bValid = GridManager->IsGridValid(Grid);
+        const bool bWalkable = GridManager->IsGridWalkable(Grid);
+        AActor* Actor = GridManager->GetActorAtGrid(Grid);
+
+        if (Valid[Index] != bValid || ValidBits[Index] != bValid
+            || Walkable[Index] != bWalkable || WalkableBits[Index] != bWalkable
+            || Actors[Index] != Actor || BatchActors[Index] != Actor)
+        {
+            AddError(FString::Printf(TEXT("Batch result differs at %s"), *Grid.ToString()));
+        }
+
+        if (bWalkable)
+        {
+            ExpectedFiltered.Add(Grid);
+            if (!Actor)
+            {
+                ExpectedUnoccupied.Add(Grid);
+            }
+        }
+    }
+    TestEqual(TEXT("FilterWalkableGrids"), Filtered, ExpectedFiltered);
+    TestEqual(TEXT("FilterWalkableGrids excluding occupied"), FilteredUnoccupied, ExpectedUnoccupied);
+
+    // 非纯函数：输出引脚不会让函数被重复执行
+    const UFunction* BatchFunction = GridManager->FindFunction(TEXT("BatchQueryGrids"));
+    TestTrue(TEXT("BatchQueryGrids is not BlueprintPure"), BatchFunction && !BatchFunction->HasAnyFunctionFlags(FUNC_BlueprintPure));
+    const UFunction* FilterFunction = GridManager->FindFunction(TEXT("FilterWalkableGrids"));
+    TestTrue(TEXT("FilterWalkableGrids is not BlueprintPure"), FilterFunction && !FilterFunction->HasAnyFunctionFlags(FUNC_BlueprintPure));
+    return true;
+}
+
+// 基准：范围指示器每帧查询 21x21 区域，逐格反射调用三个函数 vs 一次 BatchQueryGrids；同时对比 C++ 逐格与批量接口
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridBatchQueryBenchmark, "GridTactics.Perf.BatchQuery",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FGridBatchQueryBenchmark::RunTest(const FString& Parameters)
+{
+    using namespace GridBatchQueryTests;
+
+    const FIntPoint Size(128, 128);
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.2f, 1, 9));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    FRandomStream Random(9);
+    for (int32 Index = 0; Index < 200; ++Index)
+    {
+        TestWorld.SpawnOccupant(FIntPoint(Random.RandHelper(Size.X), Random.RandHelper(Size.Y)));
+    }
+
+    const TArray<FIntPoint> Grids = MakeQueryGrids(FIntPoint(64, 64), 10);
+    const int32 NumIterations = 200;
+    int32 Checksum = 0;
+
+    // 逐格反射调用（蓝图逐格循环的调用路径）
+    double StartTime = FPlatformTime::Seconds();
+    {
+        FReflectedCall ValidCall(GridManager, TEXT("IsGridValid"));
+        FReflectedCall WalkableCall(GridManager, TEXT("IsGridWalkable"));
+        FReflectedCall ActorCall(GridManager, TEXT("GetActorAtGrid"));
+        for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+        {
+            for (const FIntPoint& Grid : Grids)
+            {
+                ValidCall.Param<FIntPoint>(TEXT("Grid")) = Grid;
+                ValidCall.Invoke();
+                WalkableCall.Param<FIntPoint>(TEXT("Grid")) = Grid;
+                WalkableCall.Invoke();
+                ActorCall.Param<FIntPoint>(TEXT("Grid")) = Grid;
+                ActorCall.Invoke();
+                Checksum += ValidCall.ReturnBool() + WalkableCall.ReturnBool();
+            }
+        }
+    }
+    const double ReflectedPerCellMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+
+    // 一次反射调用批量接口
+    StartTime = FPlatformTime::Seconds();
+    {
+        FReflectedCall BatchCall(GridManager, TEXT("BatchQueryGrids"));
+        for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+        {
+            BatchCall.Param<TArray<FIntPoint>>(TEXT("Grids")) = Grids;
+            BatchCall.Invoke();
+            Checksum += BatchCall.Param<TArray<bool>>(TEXT("OutValid")).Num();
+        }
+    }
+    const double ReflectedBatchMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+
+    // C++ 逐格
+    StartTime = FPlatformTime::Seconds();
+    for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+    {
+        for (const FIntPoint& Grid : Grids)
+        {
+            Checksum += GridManager->IsGridValid(Grid) + GridManager->IsGridWalkable(Grid) + (GridManager->GetActorAtGrid(Grid) != nullptr);
+        }
+    }
+    const double NativePerCellMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+
+    // C++ 批量（位数组输出）
+    StartTime = FPlatformTime::Seconds();
+    {
+        TBitArray<> ValidBits, WalkableBits;
+        TArray<AActor*> Actors;
+        for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+        {
+            GridManager->BatchIsGridValid(Grids, ValidBits);
+            GridManager->BatchIsGridWalkable(Grids, WalkableBits);
+            GridManager->BatchGetActorAtGrid(Grids, Actors);
+            Checksum += ValidBits.CountSetBits() + Actors.Num();
+        }
+    }
+    const double NativeBatchMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+
+    AddInfo(FString::Printf(TEXT("%d cells per query: reflected per-cell %.4f ms, reflected batch %.4f ms, native per-cell %.4f ms, native batch %.4f ms (checksum %d)"),
+        Grids.Num(), ReflectedPerCellMs, ReflectedBatchMs, NativePerCellMs, NativeBatchMs, Checksum));
+    return true;
+}
+
+#endif
\ No newline at end of file
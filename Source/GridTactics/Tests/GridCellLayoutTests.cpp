@@ -0,0 +1,319 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridBitboard.h"
+#include "GridTactics/GridMovement/GridChunk.h"
+#include "GridTactics/GridMovement/GridMorton.h"
+#include "HAL/PlatformTime.h"
+
+namespace GridCellLayoutTests
+{
+    // 与编译开关无关的布局对照：同一张 uint8 层按区块（32x32）存放两份，区块内分别按行优先和 Z 序排列
+    struct FLayoutMirror
+    {
+        static constexpr int32 ChunkLog2 = FGridCellChunk::SizeLog2;
+        static constexpr int32 ChunkMask = FGridCellChunk::LocalMask;
+        static constexpr int32 ChunkCells = FGridCellChunk::NumCells;
+
+        int32 ChunksPerRow = 0;
+        TArray<uint8> RowMajor;
+        TArray<uint8> Morton;
+
+        FLayoutMirror(int32 MapSize, int32 Seed)
+        {
+            ChunksPerRow = MapSize >> ChunkLog2;
+            RowMajor.SetNumUninitialized(MapSize * MapSize);
+            Morton.SetNumUninitialized(MapSize * MapSize);
+            FRandomStream Random(Seed);
+            for (int32 Y = 0; Y < MapSize; ++Y)
+            {
+                for (int32 X = 0; X < MapSize; ++X)
+                {
+                    const uint8 Value = (uint8)Random.RandRange(1, 9);
+                    const int32 ChunkBase = GetChunkIndex(FIntPoint(X, Y)) * ChunkCells;
+                    RowMajor[ChunkBase + ((Y & ChunkMask) << ChunkLog2) + (X & ChunkMask)] = Value;
+                    Morton[ChunkBase + (int32)FGridMorton::EncodeLocal(X & ChunkMask, Y & ChunkMask)] = Value;
+                }
+            }
+        }
+
+        int32 GetChunkIndex(FIntPoint Grid) const
+        {
+            return (Grid.Y >> ChunkLog2) * ChunksPerRow + (Grid.X >> ChunkLog2);
+        }
+
+        // 行优先，区块内同一行的格子连续读取（ReadLayerRect 的读法）
+        int64 SumRowSpans(FIntPoint Min, FIntPoint Max) const
+        {
+            int64 Sum = 0;
+            for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+            {
+                for (int32 SpanStart = Min.X; SpanStart <= Max.X; )
+                {
+                    const int32 SpanEnd = FMath::Min(Max.X, SpanStart | ChunkMask);
+                    const uint8* Row = RowMajor.GetData() + GetChunkIndex(FIntPoint(SpanStart, Y)) * ChunkCells
+                        + ((Y & ChunkMask) << ChunkLog2) + (SpanStart & ChunkMask);
+                    for (int32 Offset = 0; Offset <= SpanEnd - SpanStart; ++Offset)
+                    {
+                        Sum += Row[Offset];
+                    }
+                    SpanStart = SpanEnd + 1;
+                }
+            }
+            return Sum;
+        }
+
+        // 行优先，逐格换算下标（GetActorsInRect 等逐格访问者的读法）
+        int64 SumRowMajorCells(FIntPoint Min, FIntPoint Max) const
+        {
+            int64 Sum = 0;
+            for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+            {
+                for (int32 X = Min.X; X <= Max.X; ++X)
+                {
+                    Sum += RowMajor[GetChunkIndex(FIntPoint(X, Y)) * ChunkCells + ((Y & ChunkMask) << ChunkLog2) + (X & ChunkMask)];
+                }
+            }
+            return Sum;
+        }
+
+        // Z 序遍历，逐格查表编码
+        int64 SumMortonCells(FIntPoint Min, FIntPoint Max) const
+        {
+            int64 Sum = 0;
+            FGridMorton::ForEachInRect(Min, Max, [this, &Sum](FIntPoint Grid)
+            {
+                Sum += Morton[GetChunkIndex(Grid) * ChunkCells + (int32)FGridMorton::EncodeLocal(Grid.X & ChunkMask, Grid.Y & ChunkMask)];
+            });
+            return Sum;
+        }
+    };
+
+    // 在 [0, MapSize) 内随机放置 Extent x Extent 的矩形
+    TArray<TPair<FIntPoint, FIntPoint>> MakeRects(int32 MapSize, int32 Extent, int32 NumRects, int32 Seed)
+    {
+        FRandomStream Random(Seed);
+        TArray<TPair<FIntPoint, FIntPoint>> Rects;
+        for (int32 Index = 0; Index < NumRects; ++Index)
+        {
+            const FIntPoint Min(Random.RandHelper(MapSize - Extent), Random.RandHelper(MapSize - Extent));
+            Rects.Emplace(Min, Min + FIntPoint(Extent - 1, Extent - 1));
+        }
+        return Rects;
+    }
+
+    template<typename FunctorType>
+    double TimeMicroseconds(int32 NumQueries, FunctorType&& Body)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        Body();
+        return (FPlatformTime::Seconds() - StartTime) * 1000000.0 / FMath::Max(NumQueries, 1);
+    }
+}
+
+// Morton 编解码与 Z 序矩形遍历的正确性：往返一致、查表与位运算一致、矩形内每格恰好访问一次
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridMortonEncodingTest, "GridTactics.CellLayout.Morton",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridMortonEncodingTest::RunTest(const FString& Parameters)
+{
+    for (uint32 Y = 0; Y < 32; ++Y)
+    {
+        for (uint32 X = 0; X < 32; ++X)
+        {
+            const uint32 Code = FGridMorton::Encode(X, Y);
+            if (FGridMorton::EncodeLocal(X, Y) != Code || FGridMorton::DecodeX(Code) != X || FGridMorton::DecodeY(Code) != Y)
+            {
+                AddError(FString::Printf(TEXT("Morton round trip failed at (%u, %u)"), X, Y));
+                return false;
+            }
+        }
+    }
+    TestEqual(TEXT("Large coordinate round trip"), (int32)FGridMorton::DecodeX(FGridMorton::Encode(40000, 1234)), 40000);
+    TestEqual(TEXT("Large coordinate round trip"), (int32)FGridMorton::DecodeY(FGridMorton::Encode(40000, 1234)), 1234);
+
+    // 区块内下标在当前布局下是 [0, NumCells) 上的双射
+    TBitArray<> Seen(false, FGridCellChunk::NumCells);
+    for (int32 Y = 0; Y < FGridCellChunk::Size; ++Y)
+    {
+        for (int32 X = 0; X < FGridCellChunk::Size; ++X)
+        {
+            const int32 LocalIndex = FGridCellChunk::GetLocalIndex(FIntPoint(X, Y));
+            TestFalse(TEXT("Local index is unique"), Seen[LocalIndex]);
+            Seen[LocalIndex] = true;
+            TestEqual(TEXT("Local coord round trip"), FGridCellChunk::GetLocalCoord(LocalIndex), FIntPoint(X, Y));
+        }
+    }
+
+    // Z 序遍历（含负坐标与跨区块的矩形）与逐行遍历访问同一组格子
+    FRandomStream Random(12);
+    for (int32 Query = 0; Query < 200; ++Query)
+    {
+        const FIntPoint Min(Random.RandRange(-80, 80), Random.RandRange(-80, 80));
+        const FIntPoint Max = Min + FIntPoint(Random.RandHelper(40), Random.RandHelper(40));
+        TSet<FIntPoint> Visited;
+        int32 NumVisits = 0;
+        FGridMorton::ForEachInRect(Min, Max, [&](FIntPoint Grid)
+        {
+            ++NumVisits;
+            Visited.Add(Grid);
+            if (Grid.X < Min.X || Grid.Y < Min.Y || Grid.X > Max.X || Grid.Y > Max.Y)
+            {
+                AddError(FString::Printf(TEXT("%s is outside %s - %s"), *Grid.ToString(), *Min.ToString(), *Max.ToString()));
+            }
+        });
+        const int32 Expected = (Max.X - Min.X + 1) * (Max.Y - Min.Y + 1);
+        TestEqual(TEXT("Each cell is visited once"), NumVisits, Expected);
+        TestEqual(TEXT("All cells are visited"), Visited.Num(), Expected);
+    }
+    return true;
+}
+
+// 基准：行优先与 Morton 布局在邻域查询上的耗时
+// 第一部分在 GridManager 上跑现有查询（结果对应编译时选择的布局，切换 GRIDTACTICS_MORTON_CELL_LAYOUT 后重跑即可对比）；
+// 第二部分在同一进程里对两种布局读取相同的矩形，不依赖编译开关
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridCellLayoutBenchmark, "GridTactics.Perf.CellLayout",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FGridCellLayoutBenchmark::RunTest(const FString& Parameters)
+{
+    using namespace GridCellLayoutTests;
+
+    const TCHAR* LayoutName = FGridCellChunk::bMortonLayout ? TEXT("Morton") : TEXT("row-major");
+    const int32 NumQueries = 4096;
+
+    {
+        const FIntPoint Size(512, 512);
+        FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.2f, 5, 12));
+        AGridManager* GridManager = TestWorld.GetGridManager();
+
+        FRandomStream Random(12);
+        TArray<FIntPoint> Centers;
+        while (Centers.Num() < NumQueries)
+        {
+            const FIntPoint Grid(Random.RandRange(8, Size.X - 9), Random.RandRange(8, Size.Y - 9));
+            if (FGridTestWorld::IsWalkableChar(TestWorld.GetCellChar(Grid)))
+            {
+                Centers.Add(Grid);
+            }
+        }
+        for (int32 Index = 0; Index < 2000; ++Index)
+        {
+            TestWorld.SpawnOccupant(Centers[Index]);
+        }
+
+        int64 Checksum = 0;
+        TArray<AActor*> Actors;
+        const double ActorsInRectUs = TimeMicroseconds(NumQueries, [&]()
+        {
+            for (const FIntPoint& Center : Centers)
+            {
+                GridManager->GetActorsInRect(Center - FIntPoint(4, 4), Center + FIntPoint(4, 4), Actors);
+                Checksum += Actors.Num();
+            }
+        });
+
+        TArray<int32> Values;
+        const double ReadLayerRectUs = TimeMicroseconds(NumQueries, [&]()
+        {
+            for (const FIntPoint& Center : Centers)
+            {
+                GridManager->ReadLayerRect(EGridCellLayer::MoveCost, Center - FIntPoint(8, 8), Center + FIntPoint(7, 7), Values);
+                Checksum += Values[0];
+            }
+        });
+
+        // 技能模板：位图取出命中格，再逐格读高度层（伤害/地形效果的常见用法）
+        TArray<FIntPoint> Pattern;
+        for (int32 Forward = 1; Forward <= 4; ++Forward)
+        {
+            for (int32 Side = -Forward / 2; Side <= Forward / 2; ++Side)
+            {
+                Pattern.Add(FIntPoint(Forward, Side));
+            }
+        }
+        const FGridPatternMask Mask = FGridPatternMask::Build(Pattern);
+        TArray<FIntPoint> Hits;
+        const double PatternUs = TimeMicroseconds(NumQueries, [&]()
+        {
+            for (const FIntPoint& Center : Centers)
+            {
+                GridManager->GetWalkableGridsInPattern(Center, Mask, Hits, true);
+                for (const FIntPoint& Hit : Hits)
+                {
+                    Checksum += GridManager->GetGridLayerValue(Hit, EGridCellLayer::Height);
+                }
+            }
+        });
+
+        // 风筝候选：半径 4 的菱形内逐格检查有效性、可行走、占位与移动消耗（BTTask_CalculateKitingPosition 的检查）
+        const double KitingUs = TimeMicroseconds(NumQueries, [&]()
+        {
+            for (const FIntPoint& Center : Centers)
+            {
+                for (int32 DY = -4; DY <= 4; ++DY)
+                {
+                    for (int32 DX = FMath::Abs(DY) - 4; DX <= 4 - FMath::Abs(DY); ++DX)
+                    {
+                        const FIntPoint Grid = Center + FIntPoint(DX, DY);
+                        if (GridManager->IsGridValid(Grid) && GridManager->IsGridWalkable(Grid) && !GridManager->GetActorAtGrid(Grid))
+                        {
+                            Checksum += GridManager->GetGridLayerValue(Grid, EGridCellLayer::MoveCost);
+                        }
+                    }
+                }
+            }
+        });
+
+        TestTrue(TEXT("Workloads touched cells"), Checksum > 0);
+        AddInfo(FString::Printf(TEXT("GridManager, %s layout, %dx%d, %d queries: GetActorsInRect 9x9 %.3f us, ReadLayerRect 16x16 %.3f us, pattern %.3f us, kiting radius 4 %.3f us per query"),
+            LayoutName, Size.X, Size.Y, NumQueries, ActorsInRectUs, ReadLayerRectUs, PatternUs, KitingUs));
+    }
+
+    {
+        const int32 MapSize = 1024;
+        const FLayoutMirror Mirror(MapSize, 7);
+        const int32 Extents[] = { 5, 9, 16, 32 };
+        for (const int32 Extent : Extents)
+        {
+            const TArray<TPair<FIntPoint, FIntPoint>> Rects = MakeRects(MapSize, Extent, NumQueries, Extent);
+            int64 SpanSum = 0;
+            int64 RowSum = 0;
+            int64 MortonSum = 0;
+            const double SpanUs = TimeMicroseconds(Rects.Num(), [&]()
+            {
+                for (const TPair<FIntPoint, FIntPoint>& Rect : Rects)
+                {
+                    SpanSum += Mirror.SumRowSpans(Rect.Key, Rect.Value);
+                }
+            });
+            const double RowUs = TimeMicroseconds(Rects.Num(), [&]()
+            {
+                for (const TPair<FIntPoint, FIntPoint>& Rect : Rects)
+                {
+                    RowSum += Mirror.SumRowMajorCells(Rect.Key, Rect.Value);
+                }
+            });
+            const double MortonUs = TimeMicroseconds(Rects.Num(), [&]()
+            {
+                for (const TPair<FIntPoint, FIntPoint>& Rect : Rects)
+                {
+                    MortonSum += Mirror.SumMortonCells(Rect.Key, Rect.Value);
+                }
+            });
+            TestEqual(TEXT("Row-major and Morton read the same cells"), MortonSum, RowSum);
+            TestEqual(TEXT("Row spans and per-cell reads agree"), SpanSum, RowSum);
+            AddInfo(FString::Printf(TEXT("Layout mirror %dx%d, %dx%d rects: row-major spans %.3f us, row-major per cell %.3f us, Morton Z-order %.3f us per rect"),
+                MapSize, MapSize, Extent, Extent, SpanUs, RowUs, MortonUs));
+        }
+    }
+    return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,156 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+// 格子存储的逐格查询与源地图一致（包括包围盒外一圈与跨区块的坐标）
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridCellStoreQueryTest, "GridTactics.CellStore.QueriesMatchSourceMap",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridCellStoreQueryTest::RunTest(const FString& Parameters)
+{
+    // 70 x 40 跨越 3 x 2 个区块，留出空洞与整块为空的区域
+    const FIntPoint Size(70, 40);
+    FGridTestWorld TestWorld(Size, [](FIntPoint Grid)
+    {
+        if (Grid.X >= 40 && Grid.Y >= 32)
+        {
+            return TEXT('.');
+        }
+        switch ((Grid.X * 7 + Grid.Y * 13) % 11)
+        {
+        case 0: return TEXT('#');
+        case 1: return TEXT('~');
+        case 2: return TEXT('.');
+        default: return (TCHAR)(TEXT('1') + (Grid.X + Grid.Y) % 5);
+        }
+    });
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    TestEqual(TEXT("Bounds min"), GridManager->GetGridBoundsMin(), FIntPoint::ZeroValue);
+    TestEqual(TEXT("Bounds size"), GridManager->GetGridBoundsSize(), Size);
+
+    int32 MismatchCount = 0;
+    for (int32 Y = -1; Y <= Size.Y; ++Y)
+    {
+        for (int32 X = -1; X <= Size.X; ++X)
+        {
+            const FIntPoint Grid(X, Y);
+            const TCHAR Char = TestWorld.GetCellChar(Grid);
+            const bool bValid = Char != TEXT('.');
+            const bool bWalkable = FGridTestWorld::IsWalkableChar(Char);
+            const EGridCellType ExpectedType = bWalkable ? EGridCellType::Walkable
+                : (Char == TEXT('~') ? EGridCellType::Water : EGridCellType::Blocked);
+            const int32 ExpectedMoveCost = bWalkable ? Char - TEXT('0') : (bValid ? 1 : 0);
+
+            if (GridManager->IsGridValid(Grid) != bValid
+                || GridManager->IsGridWalkable(Grid) != bWalkable
+                || GridManager->GetGridCellType(Grid) != ExpectedType
+                || GridManager->GetGridLayerValue(Grid, EGridCellLayer::MoveCost) != ExpectedMoveCost
+                || GridManager->GetWalkableBoard().TestBit(Grid) != bWalkable)
+            {
+                if (++MismatchCount <= 8)
+                {
+                    AddError(FString::Printf(TEXT("Cell %s ('%c') does not match the source map"), *Grid.ToString(), Char));
+                }
+            }
+        }
+    }
+    TestEqual(TEXT("Mismatched cells"), MismatchCount, 0);
+
+    // 运行时修改格子类型后查询立即反映，未加载的坐标不可修改
+    const FIntPoint Changed(3, 4);
+    const EGridCellType NewType = GridManager->IsGridWalkable(Changed) ? EGridCellType::Blocked : EGridCellType::Walkable;
+    if (GridManager->IsGridValid(Changed))
+    {
+        TestTrue(TEXT("SetGridCellType on a loaded cell"), GridManager->SetGridCellType(Changed, NewType));
+        TestEqual(TEXT("Changed cell type"), GridManager->GetGridCellType(Changed), NewType);
+        TestEqual(TEXT("Changed cell walkability"), GridManager->IsGridWalkable(Changed), NewType == EGridCellType::Walkable);
+    }
+    TestFalse(TEXT("SetGridCellType outside the bounds"), GridManager->SetGridCellType(FIntPoint(-5, -5), EGridCellType::Walkable));
+    TestFalse(TEXT("SetGridCellType on an empty cell"), GridManager->SetGridCellType(FIntPoint(60, 35), EGridCellType::Walkable));
+
+    return true;
+}
+
+// 随项目发布的关卡（Content/Maps 下）：关闭 bMergeCellProxies 后重建格子存储，与旧的场景查询（GridCell 扫描 + 物理重叠）逐格一致
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridCellStoreShippedMapsTest, "GridTactics.CellStore.MatchesWorldOnShippedMaps",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGridCellStoreShippedMapsTest::RunTest(const FString& Parameters)
+{
+    TArray<FString> Files;
+    FPackageName::FindPackagesInDirectory(Files, FPaths::ProjectContentDir() / TEXT("Maps"));
+
+    const FBoolProperty* MergeProperty = CastFieldChecked<FBoolProperty>(AGridManager::StaticClass()->FindPropertyByName(TEXT("bMergeCellProxies")));
+    int32 NumValidatedMaps = 0;
+    for (const FString& File : Files)
+    {
+        FString MapName;
+        if (FPaths::GetExtension(File, true) != FPackageName::GetMapPackageExtension()
+            || !FPackageName::TryConvertFilenameToLongPackageName(File, MapName))
+        {
+            continue;
+        }
+
+        UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+        UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+        if (!TestNotNull(*FString::Printf(TEXT("%s loads"), *MapName), World))
+        {
+            continue;
+        }
+
+        // 编辑器里已经打开的关卡直接使用；否则按游戏世界初始化，注册组件以便物理重叠查询能命中 GridCell
+        const bool bInitializeHere = !World->bIsWorldInitialized;
+        const bool bWasDirty = Package->IsDirty();
+        if (bInitializeHere)
+        {
+            World->WorldType = EWorldType::Game;
+            FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+            WorldContext.SetCurrentWorld(World);
+            World->InitWorld();
+            World->UpdateWorldComponents(true, false);
+        }
+
+        for (AActor* Actor : World->PersistentLevel->Actors)
+        {
+            AGridManager* GridManager = Cast<AGridManager>(Actor);
+            if (!GridManager)
+            {
+                continue;
+            }
+
+            // 保留场景中的 GridCell，旧的查询才有可对比的数据
+            const bool bMergeCellProxies = MergeProperty->GetPropertyValue_InContainer(GridManager);
+            MergeProperty->SetPropertyValue_InContainer(GridManager, false);
+            GridManager->RebuildCellStore();
+            TestEqual(*FString::Printf(TEXT("%s cell store mismatches"), *MapName), GridManager->ValidateCellStoreAgainstWorld(), 0);
+            MergeProperty->SetPropertyValue_InContainer(GridManager, bMergeCellProxies);
+            ++NumValidatedMaps;
+        }
+
+        if (bInitializeHere)
+        {
+            GEngine->DestroyWorldContext(World);
+            World->DestroyWorld(false);
+        }
+        Package->SetDirtyFlag(bWasDirty);
+    }
+
+    TestTrue(TEXT("At least one shipped map has a GridManager"), NumValidatedMaps > 0);
+    return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,229 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridFieldOfView.h"
+#include "GridTactics/GridMovement/GridTopology.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/UnrealType.h"
+
+// 对称性：任意两个透光格子 A、B（半径内）A 看得到 B 当且仅当 B 看得到 A；空地图下半径内全部可见
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridFieldOfViewSymmetryTest, "GridTactics.FieldOfView.Symmetry",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridFieldOfViewSymmetryTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(24, 24);
+    const int32 Radius = 7;
+
+    // 空地图：欧氏距离 <= Radius（与 Reveal 的判定一致）的格子全部可见
+    {
+        const FIntPoint Origin(12, 12);
+        FGridBitboard Visible;
+        FGridFieldOfView::Compute(Origin, Radius, [](FIntPoint) { return false; }, Visible);
+        for (int32 DY = -Radius; DY <= Radius; ++DY)
+        {
+            for (int32 DX = -Radius; DX <= Radius; ++DX)
+            {
+                const bool bInRange = DX * DX + DY * DY <= Radius * Radius + Radius;
+                if (Visible.TestBit(Origin + FIntPoint(DX, DY)) != bInRange)
+                {
+                    AddError(FString::Printf(TEXT("Open map: offset (%d, %d) visibility should be %d"), DX, DY, bInRange));
+                }
+            }
+        }
+    }
+
+    for (int32 Seed = 1; Seed <= 4; ++Seed)
+    {
+        FRandomStream Random(Seed);
+        TBitArray<> Walls(false, Size.X * Size.Y);
+        for (int32 Index = 0; Index < Walls.Num(); ++Index)
+        {
+            Walls[Index] = Random.FRand() < 0.25f;
+        }
+        auto IsOpaque = [&Walls, Size](FIntPoint Grid)
+        {
+            return Grid.X < 0 || Grid.Y < 0 || Grid.X >= Size.X || Grid.Y >= Size.Y || Walls[Grid.Y * Size.X + Grid.X];
+        };
+
+        // 每个透光格子一张视野
+        TMap<FIntPoint, FGridBitboard> Views;
+        for (int32 Y = 0; Y < Size.Y; ++Y)
+        {
+            for (int32 X = 0; X < Size.X; ++X)
+            {
+                if (!IsOpaque(FIntPoint(X, Y)))
+                {
+                    FGridFieldOfView::Compute(FIntPoint(X, Y), Radius, IsOpaque, Views.Add(FIntPoint(X, Y)));
+                }
+            }
+        }
+
+        int32 AsymmetricPairs = 0;
+        for (const TPair<FIntPoint, FGridBitboard>& From : Views)
+        {
+            TestTrue(TEXT("Origin is visible"), From.Value.TestBit(From.Key));
+            for (const TPair<FIntPoint, FGridBitboard>& To : Views)
+            {
+                if (From.Value.TestBit(To.Key) != To.Value.TestBit(From.Key) && ++AsymmetricPairs <= 8)
+                {
+                    AddError(FString::Printf(TEXT("Seed %d: %s -> %s is not symmetric"), Seed, *From.Key.ToString(), *To.Key.ToString()));
+                }
+            }
+        }
+        TestEqual(FString::Printf(TEXT("Seed %d asymmetric pairs"), Seed), AsymmetricPairs, 0);
+    }
+    return true;
+}
+
+// GridManager 的视野缓存：墙体本身可见但不透光，格子类型变化后缓存失效
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridFieldOfViewCacheTest, "GridTactics.FieldOfView.CacheInvalidation",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridFieldOfViewCacheTest::RunTest(const FString& Parameters)
+{
+    const TArray<FString> Rows = {
+        TEXT("111111111"),
+        TEXT("111111111"),
+        TEXT("111111111"),
+        TEXT("111111111"),
+        TEXT("111111111"),
+    };
+    FGridTestWorld TestWorld(Rows);
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    const FIntPoint Origin(1, 2);
+    const FIntPoint Wall(3, 2);
+    const FIntPoint Behind(5, 2);
+    const int32 Radius = 6;
+
+    TestTrue(TEXT("Open row is visible"), GridManager->IsGridInFieldOfView(Origin, Radius, Behind));
+
+    GridManager->SetGridCellType(Wall, EGridCellType::Blocked);
+    TestTrue(TEXT("Wall itself is visible"), GridManager->IsGridInFieldOfView(Origin, Radius, Wall));
+    TestFalse(TEXT("Cell behind the wall is hidden after the change"), GridManager->IsGridInFieldOfView(Origin, Radius, Behind));
+    TestFalse(TEXT("Hidden both ways"), GridManager->IsGridInFieldOfView(Behind, Radius, Origin));
+
+    GridManager->SetGridCellType(Wall, EGridCellType::Walkable);
+    TestTrue(TEXT("Visible again once the wall is removed"), GridManager->IsGridInFieldOfView(Origin, Radius, Behind));
+    TestFalse(TEXT("Target outside the radius"), GridManager->IsGridInFieldOfView(Origin, 2, FIntPoint(8, 2)));
+    return true;
+}
+
+// 同一帧查询的视野远超上限时，缓存按最近最少使用淘汰，始终不超过 MaxCachedFieldsOfView；反复使用的视野取到的结果始终正确
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridFieldOfViewEvictionTest, "GridTactics.FieldOfView.CacheEviction",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridFieldOfViewEvictionTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(32, 32);
+    FGridTestWorld TestWorld(Size, [](FIntPoint Grid) { return Grid == FIntPoint(10, 12) ? TEXT('#') : TEXT('1'); });
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    // 调小上限以便少量查询就触发淘汰
+    const FIntProperty* MaxProperty = CastFieldChecked<FIntProperty>(AGridManager::StaticClass()->FindPropertyByName(TEXT("MaxCachedFieldsOfView")));
+    const int32 MaxCachedFieldsOfView = 16;
+    MaxProperty->SetPropertyValue_InContainer(GridManager, MaxCachedFieldsOfView);
+
+    const FIntPoint HotOrigin(10, 10);
+    const int32 Radius = 6;
+    for (int32 Index = 0; Index < MaxCachedFieldsOfView * 8; ++Index)
+    {
+        const FIntPoint Origin(Index % Size.X, Index / Size.X);
+        TestTrue(TEXT("Origin sees itself"), GridManager->GetFieldOfView(Origin, Radius).TestBit(Origin));
+        if (GridManager->GetNumCachedFieldsOfView() > MaxCachedFieldsOfView)
+        {
+            AddError(FString::Printf(TEXT("Cache holds %d fields of view after %d origins (max %d)"),
+                GridManager->GetNumCachedFieldsOfView(), Index + 1, MaxCachedFieldsOfView));
+            break;
+        }
+
+        // 墙在 HotOrigin 正下方两格：墙本身可见，墙后不可见
+        if (Index % 2 == 0)
+        {
+            const FGridBitboard& Hot = GridManager->GetFieldOfView(HotOrigin, Radius);
+            TestTrue(TEXT("Hot origin sees the wall"), Hot.TestBit(FIntPoint(10, 12)));
+            TestFalse(TEXT("Hot origin does not see behind the wall"), Hot.TestBit(FIntPoint(10, 14)));
+            TestTrue(TEXT("Hot origin sees open cells"), Hot.TestBit(FIntPoint(14, 10)));
+        }
+    }
+    return true;
+}
+
+// 基准：256x256 随机地图上 200 个单位每帧移动一步并刷新视野（含看不看得到英雄的判定），每帧另有少量格子类型变化
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridFieldOfViewBenchmark, "GridTactics.Perf.FieldOfView",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FGridFieldOfViewBenchmark::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(256, 256);
+    const int32 NumUnits = 200;
+    const int32 NumFrames = 120;
+    const int32 EditsPerFrame = 4;
+    const int32 Radius = 8;
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.15f, 1, 14));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    FRandomStream Random(14);
+    auto RandomWalkable = [&]()
+    {
+        FIntPoint Grid;
+        do
+        {
+            Grid = FIntPoint(Random.RandHelper(Size.X), Random.RandHelper(Size.Y));
+        }
+        while (!GridManager->IsGridWalkable(Grid));
+        return Grid;
+    };
+
+    TArray<FIntPoint> Units;
+    for (int32 Index = 0; Index < NumUnits; ++Index)
+    {
+        Units.Add(RandomWalkable());
+    }
+    FIntPoint Hero = RandomWalkable();
+
+    double TotalSeconds = 0.0;
+    double WorstSeconds = 0.0;
+    int32 NumSeeingHero = 0;
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        // 移动不计入耗时：每个单位（和英雄）随机走一步，走不通就原地不动
+        for (FIntPoint& Unit : Units)
+        {
+            const FIntPoint Next = Unit + FGridTopology4::GetDirection(Random.RandHelper(4));
+            Unit = GridManager->IsGridWalkable(Next) ? Next : Unit;
+        }
+        const FIntPoint NextHero = Hero + FGridTopology4::GetDirection(Random.RandHelper(4));
+        Hero = GridManager->IsGridWalkable(NextHero) ? NextHero : Hero;
+
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 Edit = 0; Edit < EditsPerFrame; ++Edit)
+        {
+            const FIntPoint Grid(Random.RandHelper(Size.X), Random.RandHelper(Size.Y));
+            GridManager->SetGridCellType(Grid, GridManager->IsGridWalkable(Grid) ? EGridCellType::Blocked : EGridCellType::Walkable);
+        }
+        for (const FIntPoint& Unit : Units)
+        {
+            GridManager->GetFieldOfView(Unit, Radius);
+            NumSeeingHero += GridManager->IsGridInFieldOfView(Unit, Radius, Hero) ? 1 : 0;
+        }
+        const double FrameSeconds = FPlatformTime::Seconds() - StartTime;
+        TotalSeconds += FrameSeconds;
+        WorstSeconds = FMath::Max(WorstSeconds, FrameSeconds);
+    }
+    const FIntProperty* MaxProperty = CastFieldChecked<FIntProperty>(AGridManager::StaticClass()->FindPropertyByName(TEXT("MaxCachedFieldsOfView")));
+    TestTrue(TEXT("Cache stays within its limit"), GridManager->GetNumCachedFieldsOfView() <= MaxProperty->GetPropertyValue_InContainer(GridManager));
+
+    AddInfo(FString::Printf(TEXT("%d units, radius %d, %d edits per frame on %dx%d: %.3f ms per frame average, %.3f ms worst (%d hero sightings over %d frames)"),
+        NumUnits, Radius, EditsPerFrame, Size.X, Size.Y, TotalSeconds * 1000.0 / NumFrames, WorstSeconds * 1000.0, NumSeeingHero, NumFrames));
+    return true;
+}
+
+#endif
\ No newline at end of file
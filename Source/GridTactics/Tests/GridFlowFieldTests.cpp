@@ -0,0 +1,56 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridFlowField.h"
+#include "UObject/UnrealType.h"
+
+// 同一帧请求的终点数远超上限时，缓存按最近最少使用淘汰，始终不超过 MaxCachedFlowFields；交替使用的终点取到的场始终正确
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridFlowFieldCacheTest, "GridTactics.FlowField.CacheEviction",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridFlowFieldCacheTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(16, 16);
+    FGridTestWorld TestWorld(Size, [](FIntPoint) { return TEXT('1'); });
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    const FIntProperty* MaxProperty = CastFieldChecked<FIntProperty>(AGridManager::StaticClass()->FindPropertyByName(TEXT("MaxCachedFlowFields")));
+    const int32 MaxCachedFlowFields = MaxProperty->GetPropertyValue_InContainer(GridManager);
+
+    const FIntPoint HotGoal(0, 0);
+    GridManager->GetFlowField(HotGoal);
+
+    for (int32 Index = 1; Index <= MaxCachedFlowFields * 4; ++Index)
+    {
+        const FIntPoint Goal(Index % Size.X, Index / Size.X);
+        const FGridFlowField& Field = GridManager->GetFlowField(Goal);
+        TestEqual(TEXT("Field goal"), Field.GetGoal(), Goal);
+        TestEqual(TEXT("Field reaches the whole open map"), Field.GetReachedCount(), Size.X * Size.Y);
+        if (GridManager->GetNumCachedFlowFields() > MaxCachedFlowFields)
+        {
+            AddError(FString::Printf(TEXT("Cache holds %d fields after %d goals (max %d)"), GridManager->GetNumCachedFlowFields(), Index + 1, MaxCachedFlowFields));
+            break;
+        }
+
+        // 每隔一个终点再用一次 HotGoal，使它始终是最近用过的两个之一，不会被淘汰
+        if (Index % 2 == 0)
+        {
+            const FGridFlowField& HotField = GridManager->GetFlowField(HotGoal);
+            TestEqual(TEXT("Hot goal field"), HotField.GetGoal(), HotGoal);
+            TestEqual(TEXT("Hot goal distance"), HotField.GetIntegration(FIntPoint(2, 1)), 3);
+        }
+    }
+
+    // 淘汰复用了旧场的数组，重建后的结果仍要正确
+    TestEqual(TEXT("Distance on a recycled field"), GridManager->GetFlowFieldDistance(FIntPoint(Size.X - 1, Size.Y - 1), FIntPoint(3, 2)), (Size.X - 1 - 3) + (Size.Y - 1 - 2));
+    TestTrue(TEXT("Cache stays within the limit"), GridManager->GetNumCachedFlowFields() <= MaxCachedFlowFields);
+    return true;
+}
+
+#endif
\ No newline at end of file
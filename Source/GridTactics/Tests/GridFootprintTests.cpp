@@ -0,0 +1,74 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridTopology.h"
+
+// 多格占地的平移距离（前沿通道取最小）与逐格用 CanFootprintStandAt / GetActorInFootprint 前进的结果一致
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridFootprintObstacleDistanceTest, "GridTactics.Footprint.ObstacleDistanceMatchesStepping",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridFootprintObstacleDistanceTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(32, 32);
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.12f, 1, 5));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    FRandomStream Random(11);
+    for (int32 Index = 0; Index < 12; ++Index)
+    {
+        TestWorld.SpawnOccupant(FIntPoint(Random.RandHelper(Size.X), Random.RandHelper(Size.Y)));
+    }
+
+    int32 MismatchCount = 0;
+    for (int32 FootprintSize = 1; FootprintSize <= 3; ++FootprintSize)
+    {
+        for (int32 Y = 0; Y < Size.Y; ++Y)
+        {
+            for (int32 X = 0; X < Size.X; ++X)
+            {
+                const FIntPoint Anchor(X, Y);
+                if (!GridManager->CanFootprintStandAt(Anchor, FootprintSize))
+                {
+                    continue;
+                }
+
+                for (int32 DirectionIndex = 0; DirectionIndex < FGridTopology4::NumDirections; ++DirectionIndex)
+                {
+                    const FIntPoint Direction = FGridTopology4::GetDirection(DirectionIndex);
+                    for (const bool bIncludeOccupants : { false, true })
+                    {
+                        // 起点区域内有角色时跳过：调用方是区域内的角色自己，前沿之后的格子才需要检查
+                        if (bIncludeOccupants && GridManager->GetActorInFootprint(Anchor, FootprintSize))
+                        {
+                            continue;
+                        }
+
+                        int32 Expected = 0;
+                        for (FIntPoint Next = Anchor + Direction; GridManager->CanFootprintStandAt(Next, FootprintSize)
+                            && !(bIncludeOccupants && GridManager->GetActorInFootprint(Next, FootprintSize)); Next += Direction)
+                        {
+                            ++Expected;
+                        }
+
+                        const int32 Actual = GridManager->GetFootprintObstacleDistance(Anchor, Direction, FootprintSize, bIncludeOccupants);
+                        if (Actual != Expected && ++MismatchCount <= 8)
+                        {
+                            AddError(FString::Printf(TEXT("K=%d anchor %s dir %s occupants %d: %d, expected %d"),
+                                FootprintSize, *Anchor.ToString(), *Direction.ToString(), bIncludeOccupants, Actual, Expected));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    TestEqual(TEXT("Mismatched footprint distances"), MismatchCount, 0);
+    return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,284 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridAStar.h"
+#include "GridTactics/GridMovement/GridClusterGraph.h"
+#include "GridTactics/GridMovement/PathPlanner.h"
+#include "HAL/PlatformTime.h"
+
+namespace GridHierarchicalPathTests
+{
+    FGridPathConstraints MakeTerrainOnlyConstraints()
+    {
+        FGridPathConstraints Constraints;
+        Constraints.bUseMoveCost = false;
+        Constraints.bAvoidOccupied = false;
+        return Constraints;
+    }
+
+    TBitArray<> MakeWalkableBits(const FGridTestWorld& TestWorld)
+    {
+        const FIntPoint Size = TestWorld.GetSize();
+        TBitArray<> Walkable(false, Size.X * Size.Y);
+        for (int32 Index = 0; Index < Size.X * Size.Y; ++Index)
+        {
+            Walkable[Index] = FGridTestWorld::IsWalkableChar(TestWorld.GetCellChar(FIntPoint(Index % Size.X, Index / Size.X)));
+        }
+        return Walkable;
+    }
+
+    TArray<FIntPoint> GetWalkableGrids(FIntPoint Size, const TBitArray<>& Walkable)
+    {
+        TArray<FIntPoint> Grids;
+        for (TConstSetBitIterator<> It(Walkable); It; ++It)
+        {
+            Grids.Add(FIntPoint(It.GetIndex() % Size.X, It.GetIndex() / Size.X));
+        }
+        return Grids;
+    }
+
+    // 逐格路径首尾正确、逐步相邻、都落在可行走格子上
+    bool IsPathConsistent(const TArray<FIntPoint>& Path, FIntPoint Size, const TBitArray<>& Walkable, FIntPoint Start, FIntPoint Goal)
+    {
+        if (Path.Num() == 0 || Path[0] != Start || Path.Last() != Goal)
+        {
+            return false;
+        }
+        for (int32 Index = 1; Index < Path.Num(); ++Index)
+        {
+            const FIntPoint Grid = Path[Index];
+            const FIntPoint Step = Grid - Path[Index - 1];
+            if (FMath::Abs(Step.X) + FMath::Abs(Step.Y) != 1 || !Walkable[Grid.Y * Size.X + Grid.X])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// 分层路径与广度优先的可达性一致、路径合法且不短于最短路：地图尺寸不是簇大小的整数倍，加载后与格子变化后（只重建脏簇）
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridHierarchicalPathTest, "GridTactics.HierarchicalPath.MatchesBreadthFirst",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridHierarchicalPathTest::RunTest(const FString& Parameters)
+{
+    using namespace GridHierarchicalPathTests;
+
+    const FIntPoint Size(100, 84);
+    const int32 NumQueries = 120;
+    const float Densities[] = { 0.2f, 0.35f };
+    const FGridPathConstraints Constraints = MakeTerrainOnlyConstraints();
+
+    for (int32 DensityIndex = 0; DensityIndex < UE_ARRAY_COUNT(Densities); ++DensityIndex)
+    {
+        FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, Densities[DensityIndex], 1, 40 + DensityIndex));
+        AGridManager* GridManager = TestWorld.GetGridManager();
+        TBitArray<> Walkable = MakeWalkableBits(TestWorld);
+        FRandomStream Random(DensityIndex + 11);
+
+        int64 HierarchicalSteps = 0;
+        int64 OptimalSteps = 0;
+        for (int32 Round = 0; Round < 3; ++Round)
+        {
+            for (int32 Change = 0; Round > 0 && Change < 30; ++Change)
+            {
+                const FIntPoint Grid(Random.RandHelper(Size.X), Random.RandHelper(Size.Y));
+                const int32 Index = Grid.Y * Size.X + Grid.X;
+                Walkable[Index] = !Walkable[Index];
+                GridManager->SetGridCellType(Grid, Walkable[Index] ? EGridCellType::Walkable : EGridCellType::Blocked);
+            }
+
+            const TArray<FIntPoint> WalkableGrids = GetWalkableGrids(Size, Walkable);
+            int32 MismatchCount = 0;
+            for (int32 Query = 0; Query < NumQueries; ++Query)
+            {
+                const FIntPoint Start = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+                const FIntPoint Goal = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+
+                const int32 Expected = FGridTestWorld::BreadthFirstDistance(Size, Walkable, Start, Goal);
+                const FGridHierarchicalPath Result = UPathPlanner::FindHierarchicalPath(GridManager, Start, Goal, Constraints, 0);
+                const bool bMatches = Result.bFound
+                    ? Result.IsFullyRefined() && Result.Path.Num() == Result.Cost + 1 && Result.Cost >= Expected
+                        && IsPathConsistent(Result.Path, Size, Walkable, Start, Goal)
+                    : Expected == INDEX_NONE;
+                if (!bMatches && ++MismatchCount <= 8)
+                {
+                    AddError(FString::Printf(TEXT("Density %.2f round %d: %s -> %s HPA* found %d cost %d, BFS %d"),
+                        Densities[DensityIndex], Round, *Start.ToString(), *Goal.ToString(), Result.bFound, Result.Cost, Expected));
+                }
+                if (Result.bFound && Expected != INDEX_NONE)
+                {
+                    HierarchicalSteps += Result.Cost;
+                    OptimalSteps += Expected;
+                }
+            }
+        }
+
+        AddInfo(FString::Printf(TEXT("Density %.2f: HPA* path length %.3fx optimal"),
+            Densities[DensityIndex], OptimalSteps > 0 ? (double)HierarchicalSteps / OptimalSteps : 1.0));
+        TestEqual(TEXT("ValidateHierarchicalPaths"), UPathPlanner::ValidateHierarchicalPaths(GridManager, 32, DensityIndex), 0);
+    }
+    return true;
+}
+
+// 逐段细化与一次全部细化的结果相同；细化按约束避开角色；抽象搜索受 MaxExpandedNodes 限制，且节点数组按节点数分配
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridHierarchicalRefinementTest, "GridTactics.HierarchicalPath.Refinement",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridHierarchicalRefinementTest::RunTest(const FString& Parameters)
+{
+    using namespace GridHierarchicalPathTests;
+
+    const FIntPoint Size(80, 80);
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.15f, 1, 77));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+    const TBitArray<> Walkable = MakeWalkableBits(TestWorld);
+    const TArray<FIntPoint> WalkableGrids = GetWalkableGrids(Size, Walkable);
+    FGridPathConstraints Constraints = MakeTerrainOnlyConstraints();
+
+    // 找一对相距较远且可达的格子
+    FRandomStream Random(3);
+    FIntPoint Start, Goal;
+    FGridHierarchicalPath FullPath;
+    for (int32 Attempt = 0; Attempt < 1000 && (!FullPath.bFound || FullPath.AbstractPath.Num() < 6); ++Attempt)
+    {
+        Start = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+        Goal = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+        FullPath = UPathPlanner::FindHierarchicalPath(GridManager, Start, Goal, Constraints, 0);
+    }
+    if (!TestTrue(TEXT("Found a long hierarchical path"), FullPath.bFound && FullPath.AbstractPath.Num() >= 6))
+    {
+        return false;
+    }
+
+    // 逐段细化
+    FGridHierarchicalPath LazyPath = UPathPlanner::FindHierarchicalPath(GridManager, Start, Goal, Constraints, 1);
+    TestTrue(TEXT("Only the first segment is refined"), LazyPath.bFound && LazyPath.NextSegment == 1);
+    int32 NumRefineCalls = 0;
+    while (LazyPath.bFound && !LazyPath.IsFullyRefined())
+    {
+        UPathPlanner::RefineHierarchicalPath(GridManager, LazyPath, Constraints, 1);
+        ++NumRefineCalls;
+    }
+    TestEqual(TEXT("One refine call per remaining segment"), NumRefineCalls, FullPath.AbstractPath.Num() - 2);
+    TestEqual(TEXT("Lazy refinement matches full refinement"), LazyPath.Path, FullPath.Path);
+
+    // 抽象搜索的节点数组只按节点图大小分配
+    const FGridClusterGraph& ClusterGraph = GridManager->GetClusterGraph();
+    TestTrue(TEXT("Abstract search pool is sized by node count"),
+        ClusterGraph.GetSearchAllocatedSize() < (SIZE_T)Size.X * Size.Y * sizeof(int32));
+
+    // 扩展数受限时找不到路径
+    Constraints.MaxExpandedNodes = 1;
+    TestFalse(TEXT("MaxExpandedNodes limits the abstract search"),
+        UPathPlanner::FindHierarchicalPath(GridManager, Start, Goal, Constraints, 0).bFound);
+    Constraints.MaxExpandedNodes = 0;
+
+    // 在逐格路径上（非抽象节点、非终点）放一个角色，避让占位时细化出的路径绕开它
+    FIntPoint Blocker = FIntPoint(INDEX_NONE, INDEX_NONE);
+    for (int32 Index = 1; Index < FullPath.Path.Num() - 1; ++Index)
+    {
+        if (!FullPath.AbstractPath.Contains(FullPath.Path[Index]))
+        {
+            Blocker = FullPath.Path[Index];
+            break;
+        }
+    }
+    if (TestTrue(TEXT("Found a cell to block"), Blocker.X != INDEX_NONE))
+    {
+        TestWorld.SpawnOccupant(Blocker);
+        Constraints.bAvoidOccupied = true;
+        const FGridHierarchicalPath AvoidingPath = UPathPlanner::FindHierarchicalPath(GridManager, Start, Goal, Constraints, 0);
+        if (AvoidingPath.bFound)
+        {
+            TestFalse(TEXT("Refined path avoids the occupant"), AvoidingPath.Path.Contains(Blocker));
+            TestTrue(TEXT("Refined path is consistent"), IsPathConsistent(AvoidingPath.Path, Size, Walkable, Start, Goal));
+        }
+        Constraints.bAvoidOccupied = false;
+        TestTrue(TEXT("Ignoring occupants keeps the original path"),
+            UPathPlanner::FindHierarchicalPath(GridManager, Start, Goal, Constraints, 0).Path == FullPath.Path);
+    }
+    return true;
+}
+
+// 基准：1024x1024 随机地图上分层寻路与平面 A* 的单次查询耗时、建图耗时与内存
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridHierarchicalPathBenchmark, "GridTactics.Perf.HierarchicalPath",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FGridHierarchicalPathBenchmark::RunTest(const FString& Parameters)
+{
+    using namespace GridHierarchicalPathTests;
+
+    const FIntPoint Size(1024, 1024);
+    const int32 NumQueries = 64;
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.2f, 1, 1024));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+    const TArray<FIntPoint> WalkableGrids = GetWalkableGrids(Size, MakeWalkableBits(TestWorld));
+    const FGridPathConstraints Constraints = MakeTerrainOnlyConstraints();
+
+    double StartTime = FPlatformTime::Seconds();
+    const FGridClusterGraph& ClusterGraph = GridManager->GetClusterGraph();
+    const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+    auto GetEnterCost = [GridManager](FIntPoint Grid)
+    {
+        return GridManager->IsGridWalkable(Grid) ? 1 : 0;
+    };
+
+    FRandomStream Random(5);
+    double HierarchicalSeconds = 0.0;
+    double FirstSegmentSeconds = 0.0;
+    double FlatSeconds = 0.0;
+    int64 HierarchicalSteps = 0;
+    int64 FlatSteps = 0;
+    int32 MismatchCount = 0;
+    for (int32 Query = 0; Query < NumQueries; ++Query)
+    {
+        const FIntPoint Start = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+        const FIntPoint Goal = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+
+        StartTime = FPlatformTime::Seconds();
+        const FGridHierarchicalPath Hierarchical = UPathPlanner::FindHierarchicalPath(GridManager, Start, Goal, Constraints, 0);
+        HierarchicalSeconds += FPlatformTime::Seconds() - StartTime;
+
+        // 行为树的用法：只细化第一段就能走出下一步
+        StartTime = FPlatformTime::Seconds();
+        UPathPlanner::FindHierarchicalPath(GridManager, Start, Goal, Constraints, 1);
+        FirstSegmentSeconds += FPlatformTime::Seconds() - StartTime;
+
+        TArray<FIntPoint> FlatPath;
+        int32 FlatCost = 0;
+        StartTime = FPlatformTime::Seconds();
+        const bool bFlatFound = FGridAStar::Get().FindPath(GridManager->GetGridBoundsMin(), GridManager->GetGridBoundsSize(),
+            Start, Goal, GetEnterCost, FlatPath, FlatCost);
+        FlatSeconds += FPlatformTime::Seconds() - StartTime;
+
+        if (Hierarchical.bFound != bFlatFound)
+        {
+            ++MismatchCount;
+        }
+        else if (bFlatFound)
+        {
+            HierarchicalSteps += Hierarchical.Cost;
+            FlatSteps += FlatCost;
+        }
+    }
+    TestEqual(TEXT("Reachability matches flat A*"), MismatchCount, 0);
+
+    AddInfo(FString::Printf(TEXT("%dx%d, %d queries: HPA* full %.3f ms, HPA* first segment %.3f ms, flat A* %.3f ms per query; path length %.3fx optimal"),
+        Size.X, Size.Y, NumQueries, HierarchicalSeconds * 1000.0 / NumQueries, FirstSegmentSeconds * 1000.0 / NumQueries,
+        FlatSeconds * 1000.0 / NumQueries, FlatSteps > 0 ? (double)HierarchicalSteps / FlatSteps : 1.0));
+    AddInfo(FString::Printf(TEXT("Graph build %.2f ms, %d clusters, %d nodes; graph %llu bytes + abstract search pool %llu bytes vs flat A* node pool %llu bytes"),
+        BuildMs, ClusterGraph.GetNumClusters(), ClusterGraph.GetNumNodes(), (uint64)ClusterGraph.GetAllocatedSize(),
+        (uint64)ClusterGraph.GetSearchAllocatedSize(), (uint64)FGridAStar::Get().GetAllocatedSize()));
+    return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,151 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/PathPlanner.h"
+
+namespace GridJumpPointTests
+{
+    // 展开后的路径首尾正确、逐步相邻、都落在可行走格子上，且步数等于代价
+    bool IsPathConsistent(const FGridPathResult& Result, FIntPoint Size, const TBitArray<>& Walkable, FIntPoint Start, FIntPoint Goal)
+    {
+        if (Result.Path.Num() != Result.Cost + 1 || Result.Path[0] != Start || Result.Path.Last() != Goal)
+        {
+            return false;
+        }
+        for (int32 Index = 1; Index < Result.Path.Num(); ++Index)
+        {
+            const FIntPoint Grid = Result.Path[Index];
+            const FIntPoint Step = Grid - Result.Path[Index - 1];
+            if (FMath::Abs(Step.X) + FMath::Abs(Step.Y) != 1 || !Walkable[Grid.Y * Size.X + Grid.X])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// JPS+ 与广度优先的路径长度一致：多种障碍密度，加载后与格子类型变化后（只重算脏行列）
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridJumpPointMatchesBreadthFirstTest, "GridTactics.JumpPoint.MatchesBreadthFirst",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridJumpPointMatchesBreadthFirstTest::RunTest(const FString& Parameters)
+{
+    using namespace GridJumpPointTests;
+
+    const FIntPoint Size(56, 44);
+    const int32 NumQueries = 150;
+    const float Densities[] = { 0.1f, 0.25f, 0.4f };
+
+    for (int32 DensityIndex = 0; DensityIndex < UE_ARRAY_COUNT(Densities); ++DensityIndex)
+    {
+        FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, Densities[DensityIndex], 1, 22 + DensityIndex));
+        AGridManager* GridManager = TestWorld.GetGridManager();
+        FRandomStream Random(DensityIndex + 1);
+
+        TBitArray<> Walkable(false, Size.X * Size.Y);
+        for (int32 Y = 0; Y < Size.Y; ++Y)
+        {
+            for (int32 X = 0; X < Size.X; ++X)
+            {
+                Walkable[Y * Size.X + X] = FGridTestWorld::IsWalkableChar(TestWorld.GetCellChar(FIntPoint(X, Y)));
+            }
+        }
+
+        for (int32 Round = 0; Round < 4; ++Round)
+        {
+            // 第一轮是加载后的表，之后每轮先翻转一批格子
+            for (int32 Change = 0; Round > 0 && Change < 20; ++Change)
+            {
+                const FIntPoint Grid(Random.RandHelper(Size.X), Random.RandHelper(Size.Y));
+                const int32 Index = Grid.Y * Size.X + Grid.X;
+                Walkable[Index] = !Walkable[Index];
+                GridManager->SetGridCellType(Grid, Walkable[Index] ? EGridCellType::Walkable : EGridCellType::Blocked);
+            }
+
+            TArray<FIntPoint> WalkableGrids;
+            for (int32 Index = 0; Index < Size.X * Size.Y; ++Index)
+            {
+                if (Walkable[Index])
+                {
+                    WalkableGrids.Add(FIntPoint(Index % Size.X, Index / Size.X));
+                }
+            }
+
+            int32 MismatchCount = 0;
+            for (int32 Query = 0; Query < NumQueries; ++Query)
+            {
+                const FIntPoint Start = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+                const FIntPoint Goal = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+
+                const int32 Expected = FGridTestWorld::BreadthFirstDistance(Size, Walkable, Start, Goal);
+                const FGridPathResult Result = UPathPlanner::FindPathJPS(GridManager, Start, Goal);
+                const bool bMatches = Result.bFound
+                    ? Result.Cost == Expected && IsPathConsistent(Result, Size, Walkable, Start, Goal)
+                    : Expected == INDEX_NONE;
+                if (!bMatches && ++MismatchCount <= 8)
+                {
+                    AddError(FString::Printf(TEXT("Density %.2f round %d: %s -> %s JPS+ found %d cost %d, BFS %d"),
+                        Densities[DensityIndex], Round, *Start.ToString(), *Goal.ToString(), Result.bFound, Result.Cost, Expected));
+                }
+            }
+        }
+
+        TestEqual(TEXT("ValidateJumpPointSearch"), UPathPlanner::ValidateJumpPointSearch(GridManager, 64, DensityIndex), 0);
+    }
+    return true;
+}
+
+// FindPath 在地图移动消耗全为 1 且不避让角色时改走 JPS+，出现移动消耗大于 1 的格子后退回 A*
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridJumpPointDispatchTest, "GridTactics.JumpPoint.FindPathDispatch",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridJumpPointDispatchTest::RunTest(const FString& Parameters)
+{
+    const TArray<FString> Rows = {
+        TEXT("1111111111111111"),
+        TEXT("1#######1######1"),
+        TEXT("1111111111111111"),
+    };
+    FGridTestWorld TestWorld(Rows);
+    AGridManager* GridManager = TestWorld.GetGridManager();
+    const FIntPoint Start(0, 1);
+    const FIntPoint Goal(15, 1);
+
+    FGridPathConstraints Constraints;
+    Constraints.bUseMoveCost = true;
+    Constraints.bAvoidOccupied = false;
+
+    TestTrue(TEXT("Loaded map has uniform move cost"), GridManager->HasUniformMoveCost());
+    const FGridPathResult JumpResult = UPathPlanner::FindPathJPS(GridManager, Start, Goal);
+    const FGridPathResult UniformResult = UPathPlanner::FindPath(GridManager, Start, Goal, Constraints);
+    TestTrue(TEXT("Uniform path found"), UniformResult.bFound);
+    TestEqual(TEXT("Uniform cost"), UniformResult.Cost, 17);
+    TestEqual(TEXT("Uniform FindPath expands the same nodes as JPS+"), UniformResult.ExpandedNodes, JumpResult.ExpandedNodes);
+
+    // 加权一格后按移动消耗寻路必须绕开它
+    TestTrue(TEXT("Set move cost"), GridManager->SetGridLayerValue(FIntPoint(8, 0), EGridCellLayer::MoveCost, 9));
+    TestFalse(TEXT("Weighted map is not uniform"), GridManager->HasUniformMoveCost());
+    const FGridPathResult WeightedResult = UPathPlanner::FindPath(GridManager, Start, Goal, Constraints);
+    TestEqual(TEXT("Weighted cost takes the other row"), WeightedResult.Cost, 17);
+    TestFalse(TEXT("Weighted path avoids the weighted cell"), WeightedResult.Path.Contains(FIntPoint(8, 0)));
+
+    // 恢复为 1 后计数归零
+    TestTrue(TEXT("Reset move cost"), GridManager->SetGridLayerValue(FIntPoint(8, 0), EGridCellLayer::MoveCost, 1));
+    TestTrue(TEXT("Uniform again"), GridManager->HasUniformMoveCost());
+
+    // 重建格子存储时按烘焙数据重新统计
+    TestTrue(TEXT("Set move cost again"), GridManager->SetGridLayerValue(FIntPoint(3, 2), EGridCellLayer::MoveCost, 4));
+    TestFalse(TEXT("Weighted again"), GridManager->HasUniformMoveCost());
+    GridManager->RebuildCellStore();
+    TestTrue(TEXT("Rebuild restores baked move costs"), GridManager->HasUniformMoveCost());
+    return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,380 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridTopology.h"
+#include "GridTactics/GridMovement/PathPlanner.h"
+
+namespace GridObstacleDistanceTests
+{
+    // 独立的参照：在测试自己维护的可行走/占位表上逐格前进
+    struct FReference
+    {
+        FIntPoint Size;
+        TBitArray<> Walkable;
+        TBitArray<> Occupied;
+
+        bool IsOpen(FIntPoint Grid, bool bIncludeOccupants) const
+        {
+            if (Grid.X < 0 || Grid.Y < 0 || Grid.X >= Size.X || Grid.Y >= Size.Y)
+            {
+                return false;
+            }
+            const int32 Index = Grid.Y * Size.X + Grid.X;
+            return Walkable[Index] && !(bIncludeOccupants && Occupied[Index]);
+        }
+
+        int32 Distance(FIntPoint Grid, FIntPoint Direction, bool bIncludeOccupants) const
+        {
+            int32 Steps = 0;
+            for (FIntPoint Next = Grid + Direction; IsOpen(Next, bIncludeOccupants); Next += Direction)
+            {
+                ++Steps;
+            }
+            return Steps;
+        }
+    };
+
+    int32 CountMismatches(FAutomationTestBase& Test, const AGridManager* GridManager, const FReference& Reference, const TCHAR* Phase)
+    {
+        int32 MismatchCount = 0;
+        for (int32 Y = 0; Y < Reference.Size.Y; ++Y)
+        {
+            for (int32 X = 0; X < Reference.Size.X; ++X)
+            {
+                for (int32 DirectionIndex = 0; DirectionIndex < FGridTopology4::NumDirections; ++DirectionIndex)
+                {
+                    const FIntPoint Direction = FGridTopology4::GetDirection(DirectionIndex);
+                    for (const bool bIncludeOccupants : { false, true })
+                    {
+                        const int32 Expected = Reference.Distance(FIntPoint(X, Y), Direction, bIncludeOccupants);
+                        const int32 Actual = GridManager->GetObstacleDistance(FIntPoint(X, Y), Direction, bIncludeOccupants);
+                        if (Actual != Expected && ++MismatchCount <= 8)
+                        {
+                            Test.AddError(FString::Printf(TEXT("%s: (%d, %d) dir %s occupants %d: %d, expected %d"),
+                                Phase, X, Y, *Direction.ToString(), bIncludeOccupants, Actual, Expected));
+                        }
+                    }
+                }
+            }
+        }
+        return MismatchCount;
+    }
+
+    // 旧的逐格规划（不使用障碍距离表），作为 PlanDashPath / PlanKnockbackPath 的参照
+    AActor* FindActorInFootprint(const AGridManager* GridManager, FIntPoint Anchor, int32 FootprintSize, const AActor* IgnoreActor)
+    {
+        for (int32 DY = 0; DY < FootprintSize; ++DY)
+        {
+            for (int32 DX = 0; DX < FootprintSize; ++DX)
+            {
+                AActor* Actor = GridManager->GetActorAtGrid(Anchor + FIntPoint(DX, DY));
+                if (Actor && Actor != IgnoreActor)
+                {
+                    return Actor;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    FPathValidationResult SteppingKnockback(const AGridManager* GridManager, FIntPoint StartGrid, FIntPoint Direction, int32 Distance, AActor* IgnoreActor)
+    {
+        FPathValidationResult Result;
+        const int32 FootprintSize = GridManager->GetActorFootprintSize(IgnoreActor);
+        FIntPoint CurrentGrid = StartGrid;
+        Result.ValidPath.Add(CurrentGrid);
+        for (int32 Step = 1; Step <= Distance; ++Step)
+        {
+            const FIntPoint NextGrid = CurrentGrid + Direction;
+            if (!GridManager->IsGridValid(NextGrid))
+            {
+                Result.BlockReason = EKnockbackBlockReason::OutOfBounds;
+                Result.BlockedAtGrid = NextGrid;
+                break;
+            }
+            if (!GridManager->CanFootprintStandAt(NextGrid, FootprintSize))
+            {
+                Result.BlockReason = EKnockbackBlockReason::StaticObstacle;
+                Result.BlockedAtGrid = NextGrid;
+                break;
+            }
+            if (AActor* ActorAtGrid = FindActorInFootprint(GridManager, NextGrid, FootprintSize, IgnoreActor))
+            {
+                Result.Collisions.AddDefaulted_GetRef().HitActor = ActorAtGrid;
+                Result.BlockReason = EKnockbackBlockReason::AnotherActor;
+                Result.BlockedAtGrid = NextGrid;
+                break;
+            }
+            Result.ValidPath.Add(NextGrid);
+            CurrentGrid = NextGrid;
+        }
+        Result.bIsValid = Result.ValidPath.Num() > 1;
+        return Result;
+    }
+
+    FPathValidationResult SteppingDash(const AGridManager* GridManager, FIntPoint StartGrid, FIntPoint Direction, int32 MaxDistance,
+        bool bCanCollide, bool bStopOnCollision, int32 KnockbackDistance, AActor* IgnoreActor)
+    {
+        FPathValidationResult Result;
+        const int32 FootprintSize = GridManager->GetActorFootprintSize(IgnoreActor);
+        FIntPoint CurrentGrid = StartGrid;
+        Result.ValidPath.Add(CurrentGrid);
+        for (int32 Step = 1; Step <= MaxDistance; ++Step)
+        {
+            const FIntPoint NextGrid = CurrentGrid + Direction;
+            if (!GridManager->IsGridValid(NextGrid))
+            {
+                Result.BlockReason = EKnockbackBlockReason::OutOfBounds;
+                Result.BlockedAtGrid = NextGrid;
+                break;
+            }
+            if (!GridManager->CanFootprintStandAt(NextGrid, FootprintSize))
+            {
+                Result.BlockReason = EKnockbackBlockReason::StaticObstacle;
+                Result.BlockedAtGrid = NextGrid;
+                break;
+            }
+            AActor* ActorAtGrid = FindActorInFootprint(GridManager, NextGrid, FootprintSize, IgnoreActor);
+            if (!ActorAtGrid)
+            {
+                Result.ValidPath.Add(NextGrid);
+                CurrentGrid = NextGrid;
+                continue;
+            }
+            if (!bCanCollide)
+            {
+                Result.BlockReason = EKnockbackBlockReason::AnotherActor;
+                Result.BlockedAtGrid = NextGrid;
+                break;
+            }
+
+            Result.Collisions.AddDefaulted_GetRef().HitActor = ActorAtGrid;
+            if (bStopOnCollision)
+            {
+                // 被撞的多格角色从自身占地区域的最小角开始击退
+                FIntPoint KnockbackStart = NextGrid;
+                FIntPoint Anchor;
+                int32 HitFootprintSize;
+                if (GridManager->GetActorFootprint(ActorAtGrid, Anchor, HitFootprintSize) && HitFootprintSize > 1)
+                {
+                    KnockbackStart = Anchor;
+                }
+                if (SteppingKnockback(GridManager, KnockbackStart, Direction, KnockbackDistance, ActorAtGrid).bIsValid)
+                {
+                    Result.ValidPath.Add(NextGrid);
+                    CurrentGrid = NextGrid;
+                }
+                Result.BlockReason = EKnockbackBlockReason::AnotherActor;
+                Result.BlockedAtGrid = NextGrid;
+                break;
+            }
+        }
+        Result.bIsValid = Result.ValidPath.Num() > 1;
+        return Result;
+    }
+
+    bool MatchesStepping(FAutomationTestBase& Test, const TCHAR* What, const FPathValidationResult& Actual, const FPathValidationResult& Expected)
+    {
+        if (Actual.ValidPath == Expected.ValidPath && Actual.BlockReason == Expected.BlockReason && Actual.BlockedAtGrid == Expected.BlockedAtGrid
+            && Actual.bIsValid == Expected.bIsValid && Actual.Collisions.Num() == Expected.Collisions.Num()
+            && (Actual.Collisions.IsEmpty() || Actual.Collisions.Last().HitActor == Expected.Collisions.Last().HitActor))
+        {
+            return true;
+        }
+        Test.AddError(FString::Printf(TEXT("%s: path %d -> %s reason %d at %s, expected path %d -> %s reason %d at %s"), What,
+            Actual.ValidPath.Num(), *Actual.ValidPath.Last().ToString(), (int32)Actual.BlockReason, *Actual.BlockedAtGrid.ToString(),
+            Expected.ValidPath.Num(), *Expected.ValidPath.Last().ToString(), (int32)Expected.BlockReason, *Expected.BlockedAtGrid.ToString()));
+        return false;
+    }
+
+    // 规划击退时会逐次输出阻挡警告，这里不把它们当作测试失败
+    class FPlannerTestBase : public FAutomationTestBase
+    {
+    public:
+        using FAutomationTestBase::FAutomationTestBase;
+        virtual bool SuppressLogWarnings() override { return true; }
+    };
+
+    // 找一个地形可站立且没有其他角色的锚点
+    bool FindFreeAnchor(const AGridManager* GridManager, FRandomStream& Random, FIntPoint Size, int32 FootprintSize, const AActor* IgnoreActor, FIntPoint& OutAnchor)
+    {
+        for (int32 Attempt = 0; Attempt < 64; ++Attempt)
+        {
+            const FIntPoint Anchor(Random.RandHelper(Size.X), Random.RandHelper(Size.Y));
+            if (GridManager->CanFootprintStandAt(Anchor, FootprintSize) && !FindActorInFootprint(GridManager, Anchor, FootprintSize, IgnoreActor))
+            {
+                OutAnchor = Anchor;
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+// 障碍距离表与逐格前进的结果一致：加载后、格子类型变化后、角色移动后（只重算脏行列）
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridObstacleDistanceTest, "GridTactics.ObstacleDistance.MatchesStepping",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridObstacleDistanceTest::RunTest(const FString& Parameters)
+{
+    using namespace GridObstacleDistanceTests;
+
+    const FIntPoint Size(40, 36);
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.3f, 1, 18));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    FReference Reference{ Size, TBitArray<>(false, Size.X * Size.Y), TBitArray<>(false, Size.X * Size.Y) };
+    TArray<FIntPoint> WalkableGrids;
+    for (int32 Y = 0; Y < Size.Y; ++Y)
+    {
+        for (int32 X = 0; X < Size.X; ++X)
+        {
+            if (FGridTestWorld::IsWalkableChar(TestWorld.GetCellChar(FIntPoint(X, Y))))
+            {
+                Reference.Walkable[Y * Size.X + X] = true;
+                WalkableGrids.Add(FIntPoint(X, Y));
+            }
+        }
+    }
+    TestEqual(TEXT("After load"), CountMismatches(*this, GridManager, Reference, TEXT("Load")), 0);
+
+    // 放置角色
+    FRandomStream Random(7);
+    TArray<TPair<AActor*, FIntPoint>> Occupants;
+    for (int32 Index = 0; Index < 30; ++Index)
+    {
+        const FIntPoint Grid = WalkableGrids[Random.RandHelper(WalkableGrids.Num())];
+        Occupants.Emplace(TestWorld.SpawnOccupant(Grid), Grid);
+        Reference.Occupied[Grid.Y * Size.X + Grid.X] = true;
+    }
+    TestEqual(TEXT("After placing occupants"), CountMismatches(*this, GridManager, Reference, TEXT("Occupants")), 0);
+
+    // 交替修改地形与移动角色，每轮都查询一次，覆盖增量更新路径
+    for (int32 Round = 0; Round < 6; ++Round)
+    {
+        for (int32 Change = 0; Change < 12; ++Change)
+        {
+            const FIntPoint Grid(Random.RandHelper(Size.X), Random.RandHelper(Size.Y));
+            const int32 Index = Grid.Y * Size.X + Grid.X;
+            const bool bWalkable = !Reference.Walkable[Index];
+            GridManager->SetGridCellType(Grid, bWalkable ? EGridCellType::Walkable : EGridCellType::Blocked);
+            Reference.Walkable[Index] = bWalkable;
+        }
+
+        for (TPair<AActor*, FIntPoint>& Occupant : Occupants)
+        {
+            if (Random.FRand() < 0.5f)
+            {
+                continue;
+            }
+            const FIntPoint NewGrid(Random.RandHelper(Size.X), Random.RandHelper(Size.Y));
+            GridManager->UpdateActorOccupancy(Occupant.Key, NewGrid);
+            Occupant.Value = NewGrid;
+        }
+        Reference.Occupied.Init(false, Size.X * Size.Y);
+        for (const TPair<AActor*, FIntPoint>& Occupant : Occupants)
+        {
+            Reference.Occupied[Occupant.Value.Y * Size.X + Occupant.Value.X] = true;
+        }
+
+        TestEqual(FString::Printf(TEXT("Round %d"), Round),
+            CountMismatches(*this, GridManager, Reference, *FString::Printf(TEXT("Round %d"), Round)), 0);
+    }
+
+    TestEqual(TEXT("ValidateObstacleDistances"), GridManager->ValidateObstacleDistances(), 0);
+    return true;
+}
+
+// 冲刺 / 击退的障碍距离快速路径与逐格规划一致：1x1 与多格角色、随机方向和距离，地形与角色位置在轮次之间变化
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FGridDisplacementPlanTest, GridObstacleDistanceTests::FPlannerTestBase,
+    "GridTactics.ObstacleDistance.DisplacementMatchesStepping",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridDisplacementPlanTest::RunTest(const FString& Parameters)
+{
+    using namespace GridObstacleDistanceTests;
+
+    const FIntPoint Size(48, 40);
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.15f, 1, 23));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+    FRandomStream Random(29);
+
+    // 待移动的角色与路上的障碍角色都混合 1x1 与多格占地
+    TArray<AActor*> Actors;
+    for (int32 Index = 0; Index < 40; ++Index)
+    {
+        const int32 FootprintSize = Index % 4 == 0 ? 1 + Index / 4 % 3 : 1;
+        FIntPoint Anchor;
+        if (FindFreeAnchor(GridManager, Random, Size, FootprintSize, nullptr, Anchor))
+        {
+            Actors.Add(TestWorld.SpawnOccupant(Anchor, FootprintSize));
+        }
+    }
+
+    int32 MismatchCount = 0;
+    for (int32 Round = 0; Round < 5; ++Round)
+    {
+        for (int32 Trial = 0; Trial < 200; ++Trial)
+        {
+            AActor* Mover = Actors[Random.RandHelper(Actors.Num())];
+            FIntPoint StartGrid;
+            int32 FootprintSize;
+            GridManager->GetActorFootprint(Mover, StartGrid, FootprintSize);
+            const FIntPoint Direction = FGridTopology4::GetDirection(Random.RandHelper(FGridTopology4::NumDirections));
+            const int32 Distance = Random.RandRange(1, 16);
+
+            const FString Where = FString::Printf(TEXT("Round %d from %s size %d dir %s distance %d"),
+                Round, *StartGrid.ToString(), FootprintSize, *Direction.ToString(), Distance);
+
+            if (!MatchesStepping(*this, *FString::Printf(TEXT("%s knockback"), *Where),
+                UPathPlanner::PlanKnockbackPath(GridManager, StartGrid, Direction, Distance, Mover),
+                SteppingKnockback(GridManager, StartGrid, Direction, Distance, Mover)))
+            {
+                ++MismatchCount;
+            }
+
+            const bool bCanCollide = Random.FRand() < 0.7f;
+            const bool bStopOnCollision = Random.FRand() < 0.7f;
+            const int32 KnockbackDistance = Random.RandRange(1, 4);
+            if (!MatchesStepping(*this, *FString::Printf(TEXT("%s dash collide %d stop %d"), *Where, bCanCollide, bStopOnCollision),
+                UPathPlanner::PlanDashPath(GridManager, StartGrid, Direction, Distance, bCanCollide, bStopOnCollision, KnockbackDistance, Mover),
+                SteppingDash(GridManager, StartGrid, Direction, Distance, bCanCollide, bStopOnCollision, KnockbackDistance, Mover)))
+            {
+                ++MismatchCount;
+            }
+
+            if (MismatchCount > 8)
+            {
+                return false;
+            }
+        }
+
+        // 修改地形并移动一半角色，覆盖障碍距离表的增量更新
+        for (int32 Change = 0; Change < 16; ++Change)
+        {
+            const FIntPoint Grid(Random.RandHelper(Size.X), Random.RandHelper(Size.Y));
+            GridManager->SetGridCellType(Grid, GridManager->IsGridWalkable(Grid) ? EGridCellType::Blocked : EGridCellType::Walkable);
+        }
+        for (AActor* Actor : Actors)
+        {
+            FIntPoint Anchor;
+            int32 FootprintSize;
+            GridManager->GetActorFootprint(Actor, Anchor, FootprintSize);
+            if (Random.FRand() < 0.5f && FindFreeAnchor(GridManager, Random, Size, FootprintSize, Actor, Anchor))
+            {
+                GridManager->UpdateActorOccupancy(Actor, Anchor, FootprintSize);
+            }
+        }
+    }
+
+    TestEqual(TEXT("Mismatching plans"), MismatchCount, 0);
+    return true;
+}
+
+#endif
\ No newline at end of file
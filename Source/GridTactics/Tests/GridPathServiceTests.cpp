@@ -0,0 +1,175 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridPathService.h"
+#include "GridTactics/GridMovement/PathPlanner.h"
+
+namespace GridPathServiceTests
+{
+    // 地形逐格的期望值：移动消耗与净空，规则与 FGridPathTerrainBuilder 的说明一致
+    struct FExpectedTerrain
+    {
+        TArray<int32> MoveCosts;
+        TArray<int32> Clearance;
+
+        FExpectedTerrain(const AGridManager* GridManager, FIntPoint Size)
+        {
+            for (int32 Y = 0; Y < Size.Y; ++Y)
+            {
+                for (int32 X = 0; X < Size.X; ++X)
+                {
+                    const FIntPoint Grid(X, Y);
+                    MoveCosts.Add(GridManager->GetWalkableBoard().TestBit(Grid)
+                        ? FMath::Clamp(GridManager->GetGridLayerValue(Grid, EGridCellLayer::MoveCost), 1, MAX_uint8)
+                        : 0);
+                    Clearance.Add(GridManager->GetGridClearance(Grid));
+                }
+            }
+        }
+    };
+
+    // 返回不一致的格子数（只报告前几个）
+    int32 CountMismatches(FAutomationTestBase& Test, const TCHAR* What, const FGridPathSnapshot::FTerrain& Terrain,
+        const FExpectedTerrain& Expected, FIntPoint Size)
+    {
+        int32 NumMismatches = 0;
+        for (int32 Y = 0; Y < Size.Y; ++Y)
+        {
+            for (int32 X = 0; X < Size.X; ++X)
+            {
+                const FIntPoint Grid(X, Y);
+                int32 LocalIndex = 0;
+                const FGridPathSnapshot::FTerrainTile* Tile = Terrain.FindTile(Grid, LocalIndex);
+                const int32 Index = Y * Size.X + X;
+                if (!Tile || Tile->MoveCosts[LocalIndex] != Expected.MoveCosts[Index] || Tile->Clearance[LocalIndex] != Expected.Clearance[Index])
+                {
+                    if (++NumMismatches <= 8)
+                    {
+                        Test.AddError(FString::Printf(TEXT("%s: terrain at %s does not match"), What, *Grid.ToString()));
+                    }
+                }
+            }
+        }
+        return NumMismatches;
+    }
+}
+
+// 增量地形：修补只动变化格子所在的块（写时复制），旧地形保持不变，分多次 Update 完成前仍发布旧地形
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridPathTerrainBuilderTest, "GridTactics.PathService.IncrementalTerrain",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridPathTerrainBuilderTest::RunTest(const FString& Parameters)
+{
+    using namespace GridPathServiceTests;
+
+    // 不是块边长整数倍的尺寸，覆盖边缘的不完整块
+    const FIntPoint Size(80, 70);
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.2f, 3, 11));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    FGridPathTerrainBuilder Builder;
+    TestTrue(TEXT("Initial build completes without a deadline"), Builder.Update(GridManager, MAX_dbl));
+    const TSharedPtr<const FGridPathSnapshot::FTerrain> OldTerrain = Builder.GetTerrain();
+    if (!TestTrue(TEXT("Initial terrain"), OldTerrain.IsValid()))
+    {
+        return false;
+    }
+    const FExpectedTerrain OldExpected(GridManager, Size);
+    TestEqual(TEXT("Initial terrain mismatches"), CountMismatches(*this, TEXT("Initial"), *OldTerrain, OldExpected, Size), 0);
+    TestTrue(TEXT("Unchanged version is already current"), Builder.Update(GridManager, 0.0) && Builder.GetTerrain() == OldTerrain);
+
+    // 只改左上角一个块里的格子：翻转可行走性并修改移动消耗
+    TArray<FIntPoint> Changed = { FIntPoint(3, 4), FIntPoint(10, 10), FIntPoint(20, 5), FIntPoint(20, 5) };
+    for (const FIntPoint& Grid : Changed)
+    {
+        const bool bWalkable = GridManager->IsGridWalkable(Grid);
+        GridManager->SetGridCellType(Grid, bWalkable ? EGridCellType::Blocked : EGridCellType::Walkable);
+    }
+    GridManager->SetGridLayerValue(FIntPoint(12, 12), EGridCellLayer::MoveCost, 7);
+
+    // 截止时间已过：每次 Update 只推进一项，完成前继续发布旧地形
+    int32 NumUpdates = 1;
+    while (!Builder.Update(GridManager, 0.0))
+    {
+        TestTrue(TEXT("Old terrain is published while patching"), Builder.GetTerrain() == OldTerrain);
+        if (++NumUpdates > 64)
+        {
+            AddError(TEXT("Incremental update did not finish"));
+            return false;
+        }
+    }
+    TestTrue(TEXT("Patch is spread over several budgeted updates"), NumUpdates > 1);
+
+    const TSharedPtr<const FGridPathSnapshot::FTerrain> NewTerrain = Builder.GetTerrain();
+    TestTrue(TEXT("New terrain published"), NewTerrain.IsValid() && NewTerrain != OldTerrain);
+    TestEqual(TEXT("New terrain version"), NewTerrain->GridVersion, GridManager->GetGridVersion());
+    TestEqual(TEXT("New terrain mismatches"), CountMismatches(*this, TEXT("New"), *NewTerrain, FExpectedTerrain(GridManager, Size), Size), 0);
+    TestEqual(TEXT("Old terrain is untouched"), CountMismatches(*this, TEXT("Old"), *OldTerrain, OldExpected, Size), 0);
+
+    // 变化只在第一个块内（净空影响范围也不越界），其余块与旧地形共享
+    int32 LocalIndex = 0;
+    TestTrue(TEXT("Changed tile is copied"), NewTerrain->FindTile(FIntPoint(10, 10), LocalIndex) != OldTerrain->FindTile(FIntPoint(10, 10), LocalIndex));
+    TestTrue(TEXT("Unchanged tile is shared"), NewTerrain->FindTile(FIntPoint(70, 60), LocalIndex) == OldTerrain->FindTile(FIntPoint(70, 60), LocalIndex));
+    return true;
+}
+
+// 快照求解与同步 FindPath 共用进入代价规则：同一地图、同一占位下结果一致
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridPathSnapshotMatchesFindPathTest, "GridTactics.PathService.MatchesFindPath",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridPathSnapshotMatchesFindPathTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(40, 40);
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.25f, 4, 5));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    FRandomStream Random(5);
+    auto RandomWalkable = [&]()
+    {
+        FIntPoint Grid;
+        do
+        {
+            Grid = FIntPoint(Random.RandHelper(Size.X), Random.RandHelper(Size.Y));
+        }
+        while (!FGridTestWorld::IsWalkableChar(TestWorld.GetCellChar(Grid)));
+        return Grid;
+    };
+    for (int32 Index = 0; Index < 12; ++Index)
+    {
+        TestWorld.SpawnOccupant(RandomWalkable());
+    }
+
+    FGridPathTerrainBuilder Builder;
+    Builder.Update(GridManager, MAX_dbl);
+    FGridPathSnapshot Snapshot;
+    Snapshot.Terrain = Builder.GetTerrain();
+    Snapshot.Occupancy = GridManager->GetOccupancyBoard();
+
+    for (int32 Query = 0; Query < 64; ++Query)
+    {
+        const FIntPoint Start = RandomWalkable();
+        const FIntPoint Goal = RandomWalkable();
+        FGridPathConstraints Constraints;
+        Constraints.bUseMoveCost = Query % 2 == 0;
+        Constraints.bAvoidOccupied = Query % 3 != 0;
+        Constraints.bAllowOccupiedGoal = Query % 4 != 0;
+
+        // 统一代价且不避让时 FindPath 走 JPS+，代价仍应与快照上的 A* 相同
+        const FGridPathResult Sync = UPathPlanner::FindPath(GridManager, Start, Goal, Constraints);
+        const FGridPathResult Async = UGridPathService::SolveOnSnapshot(Snapshot, Start, Goal, Constraints, 1, FIntPoint::ZeroValue, 0);
+        if (Sync.bFound != Async.bFound || (Sync.bFound && Sync.Cost != Async.Cost))
+        {
+            AddError(FString::Printf(TEXT("%s -> %s: FindPath (%d, %d) vs snapshot (%d, %d)"), *Start.ToString(), *Goal.ToString(),
+                Sync.bFound, Sync.Cost, Async.bFound, Async.Cost));
+        }
+    }
+    return true;
+}
+
+#endif
\ No newline at end of file
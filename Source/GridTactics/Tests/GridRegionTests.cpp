@@ -0,0 +1,123 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridTopology.h"
+
+namespace GridRegionTests
+{
+    // 独立的参照：在 Walkable 上做四方向广度优先，给每个连通块一个从 1 开始的编号
+    TArray<int32> LabelComponents(FIntPoint Size, const TBitArray<>& Walkable)
+    {
+        TArray<int32> Components;
+        Components.SetNumZeroed(Size.X * Size.Y);
+        TArray<FIntPoint> Queue;
+        int32 NumComponents = 0;
+        for (int32 Start = 0; Start < Components.Num(); ++Start)
+        {
+            if (!Walkable[Start] || Components[Start] != 0)
+            {
+                continue;
+            }
+
+            Components[Start] = ++NumComponents;
+            Queue.Reset();
+            Queue.Add(FIntPoint(Start % Size.X, Start / Size.X));
+            for (int32 Head = 0; Head < Queue.Num(); ++Head)
+            {
+                FGridTopology4::ForEachNeighbor(Queue[Head], [&](FIntPoint Neighbor, int32)
+                {
+                    if (Neighbor.X < 0 || Neighbor.Y < 0 || Neighbor.X >= Size.X || Neighbor.Y >= Size.Y)
+                    {
+                        return;
+                    }
+                    const int32 Index = Neighbor.Y * Size.X + Neighbor.X;
+                    if (Walkable[Index] && Components[Index] == 0)
+                    {
+                        Components[Index] = NumComponents;
+                        Queue.Add(Neighbor);
+                    }
+                });
+            }
+        }
+        return Components;
+    }
+
+    // 区域编号与参照的连通块一一对应，不可行走的格子编号为 0
+    int32 CountMismatches(FAutomationTestBase& Test, const AGridManager* GridManager, FIntPoint Size, const TArray<int32>& Components, int32 Round)
+    {
+        TMap<int32, int32> LabelOfComponent;
+        TMap<int32, int32> ComponentOfLabel;
+        int32 MismatchCount = 0;
+        for (int32 Index = 0; Index < Components.Num(); ++Index)
+        {
+            const FIntPoint Grid(Index % Size.X, Index / Size.X);
+            const int32 Label = GridManager->GetRegionLabel(Grid);
+            const int32 Component = Components[Index];
+            const bool bMatches = Component == 0
+                ? Label == 0
+                : Label != 0 && LabelOfComponent.FindOrAdd(Component, Label) == Label && ComponentOfLabel.FindOrAdd(Label, Component) == Component;
+            if (!bMatches && ++MismatchCount <= 8)
+            {
+                Test.AddError(FString::Printf(TEXT("Round %d: %s has region %d, reference component %d"), Round, *Grid.ToString(), Label, Component));
+            }
+        }
+        return MismatchCount;
+    }
+}
+
+// 逐格编辑地形后的增量区域编号与广度优先的连通块一致，且编号在长时间编辑后被回收，不随编辑次数增长
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridRegionLabelTest, "GridTactics.Regions.IncrementalLabelsMatchComponents",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridRegionLabelTest::RunTest(const FString& Parameters)
+{
+    using namespace GridRegionTests;
+
+    const FIntPoint Size(48, 48);
+    FGridTestWorld TestWorld(FGridTestWorld::MakeRandomRows(Size, 0.3f, 1, 31));
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    TBitArray<> Walkable(false, Size.X * Size.Y);
+    for (int32 Index = 0; Index < Walkable.Num(); ++Index)
+    {
+        Walkable[Index] = FGridTestWorld::IsWalkableChar(TestWorld.GetCellChar(FIntPoint(Index % Size.X, Index / Size.X)));
+    }
+    TestEqual(TEXT("After load"), CountMismatches(*this, GridManager, Size, LabelComponents(Size, Walkable), 0), 0);
+
+    // 随机开关格子，使区域反复分裂与合并；编辑次数远多于压缩阈值的下限
+    FRandomStream Random(37);
+    int32 MaxNumLabels = 0;
+    int32 MaxNumComponents = 0;
+    for (int32 Round = 1; Round <= 12; ++Round)
+    {
+        for (int32 Edit = 0; Edit < 500; ++Edit)
+        {
+            const FIntPoint Grid(Random.RandHelper(Size.X), Random.RandHelper(Size.Y));
+            const int32 Index = Grid.Y * Size.X + Grid.X;
+            const bool bWalkable = !Walkable[Index];
+            GridManager->SetGridCellType(Grid, bWalkable ? EGridCellType::Walkable : EGridCellType::Blocked);
+            Walkable[Index] = bWalkable;
+            MaxNumLabels = FMath::Max(MaxNumLabels, GridManager->GetNumRegionLabels());
+        }
+
+        const TArray<int32> Components = LabelComponents(Size, Walkable);
+        MaxNumComponents = FMath::Max(MaxNumComponents, FMath::Max(Components));
+        if (CountMismatches(*this, GridManager, Size, Components, Round) > 0)
+        {
+            return false;
+        }
+    }
+
+    // 压缩阈值为区域数的 4 倍（至少 1024）；检查点之间区域数还会波动，这里放宽到 8 倍
+    AddInfo(FString::Printf(TEXT("Peak region labels: %d, peak regions: %d"), MaxNumLabels, MaxNumComponents));
+    TestTrue(TEXT("Region labels are recycled"), MaxNumLabels <= FMath::Max(1024, MaxNumComponents * 8));
+    return true;
+}
+
+#endif
\ No newline at end of file
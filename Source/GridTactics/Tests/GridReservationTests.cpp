@@ -0,0 +1,132 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GridTestWorld.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "Async/ParallelFor.h"
+#include <atomic>
+
+// 多个工作线程同时抢占/释放同一批格子：任意时刻每格至多一个持有者，抢占结束后每格恰好一个持有者
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridReservationStressTest, "GridTactics.Reservation.ParallelStress",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridReservationStressTest::RunTest(const FString& Parameters)
+{
+    // 两个区块宽，覆盖跨区块的槽位查找
+    const FIntPoint Size(48, 16);
+    FGridTestWorld TestWorld(Size, [](FIntPoint) { return TEXT('1'); });
+    AGridManager* GridManager = TestWorld.GetGridManager();
+
+    const int32 NumRequesters = 16;
+    TArray<AActor*> Requesters;
+    for (int32 Index = 0; Index < NumRequesters; ++Index)
+    {
+        Requesters.Add(TestWorld.GetWorld()->SpawnActor<AActor>());
+    }
+
+    const int32 NumCells = Size.X * Size.Y;
+    auto CellAt = [Size](int32 Index) { return FIntPoint(Index % Size.X, Index / Size.X); };
+
+    // 1. 抢占：每个请求者从不同的起点扫描全部格子，每格只应有一次成功
+    TArray<std::atomic<int32>> ReserveWins;
+    ReserveWins.SetNum(NumCells);
+    for (std::atomic<int32>& Wins : ReserveWins)
+    {
+        Wins.store(0);
+    }
+    ParallelFor(NumRequesters, [&](int32 RequesterIndex)
+    {
+        for (int32 Step = 0; Step < NumCells; ++Step)
+        {
+            const int32 CellIndex = (Step * 7 + RequesterIndex * 97) % NumCells;
+            if (GridManager->ReserveGrid(Requesters[RequesterIndex], CellAt(CellIndex)))
+            {
+                ReserveWins[CellIndex].fetch_add(1);
+            }
+        }
+    });
+
+    int32 BadCells = 0;
+    for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+    {
+        const AActor* Owner = GridManager->GetGridReservation(CellAt(CellIndex));
+        if ((ReserveWins[CellIndex].load() != 1 || !Owner || !Requesters.Contains(Owner)) && ++BadCells <= 8)
+        {
+            AddError(FString::Printf(TEXT("Cell %s: %d successful reservations, owner %s"),
+                *CellAt(CellIndex).ToString(), ReserveWins[CellIndex].load(), *GetNameSafe(Owner)));
+        }
+    }
+    TestEqual(TEXT("Cells without exactly one owner after reserving"), BadCells, 0);
+
+    // 2. 释放：所有请求者同时尝试释放全部格子，只有持有者能成功
+    TArray<std::atomic<int32>> ReleaseWins;
+    ReleaseWins.SetNum(NumCells);
+    for (std::atomic<int32>& Wins : ReleaseWins)
+    {
+        Wins.store(0);
+    }
+    ParallelFor(NumRequesters, [&](int32 RequesterIndex)
+    {
+        for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+        {
+            if (GridManager->ReleaseGridIfOwner(Requesters[RequesterIndex], CellAt(CellIndex)))
+            {
+                ReleaseWins[CellIndex].fetch_add(1);
+            }
+        }
+    });
+
+    BadCells = 0;
+    for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+    {
+        if ((ReleaseWins[CellIndex].load() != 1 || GridManager->GetGridReservation(CellAt(CellIndex))) && ++BadCells <= 8)
+        {
+            AddError(FString::Printf(TEXT("Cell %s: %d successful releases"), *CellAt(CellIndex).ToString(), ReleaseWins[CellIndex].load()));
+        }
+    }
+    TestEqual(TEXT("Cells not released exactly once"), BadCells, 0);
+
+    // 3. 抢占与释放交替：持有者计数在抢到后加一、释放前减一，任何时刻都不能超过 1
+    TArray<std::atomic<int32>> Holders;
+    Holders.SetNum(NumCells);
+    for (std::atomic<int32>& Count : Holders)
+    {
+        Count.store(0);
+    }
+    std::atomic<int32> Violations(0);
+    ParallelFor(NumRequesters, [&](int32 RequesterIndex)
+    {
+        FRandomStream Random(RequesterIndex + 1);
+        AActor* Requester = Requesters[RequesterIndex];
+        for (int32 Iteration = 0; Iteration < 20000; ++Iteration)
+        {
+            // 集中在少量格子上制造冲突
+            const int32 CellIndex = Random.RandHelper(64);
+            if (GridManager->ReserveGrid(Requester, CellAt(CellIndex)))
+            {
+                if (Holders[CellIndex].fetch_add(1) != 0)
+                {
+                    Violations.fetch_add(1);
+                }
+                Holders[CellIndex].fetch_sub(1);
+                if (!GridManager->ReleaseGridIfOwner(Requester, CellAt(CellIndex)))
+                {
+                    Violations.fetch_add(1);
+                }
+            }
+        }
+    });
+    TestEqual(TEXT("Concurrent holders or lost reservations"), Violations.load(), 0);
+
+    for (int32 CellIndex = 0; CellIndex < 64; ++CellIndex)
+    {
+        TestNull(TEXT("Churned cell is free afterwards"), GridManager->GetGridReservation(CellAt(CellIndex)));
+    }
+    return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "UObject/Package.h"
+#include "GridTactics/GridMovement/GridManager.h"
+#include "GridTactics/GridMovement/GridMapAsset.h"
+#include "GridTactics/GridMovement/GridTopology.h"
+
+FGridTestWorld::FGridTestWorld(TConstArrayView<FString> Rows)
+{
+    Size = FIntPoint(Rows.Num() > 0 ? Rows[0].Len() : 0, Rows.Num());
+    Chars.Reserve(Size.X * Size.Y);
+    for (const FString& Row : Rows)
+    {
+        check(Row.Len() == Size.X);
+        Chars.Append(*Row, Row.Len());
+    }
+    CreateWorld();
+}
+
+FGridTestWorld::FGridTestWorld(FIntPoint InSize, TFunctionRef<TCHAR(FIntPoint Grid)> CellAt)
+    : Size(InSize)
+{
+    Chars.Reserve(Size.X * Size.Y);
+    for (int32 Y = 0; Y < Size.Y; ++Y)
+    {
+        for (int32 X = 0; X < Size.X; ++X)
+        {
+            Chars.Add(CellAt(FIntPoint(X, Y)));
+        }
+    }
+    CreateWorld();
+}
+
+FGridTestWorld::~FGridTestWorld()
+{
+    if (World)
+    {
+        GEngine->DestroyWorldContext(World);
+        World->DestroyWorld(false);
+    }
+}
+
+void FGridTestWorld::CreateWorld()
+{
+    World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("GridTacticsTestWorld"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    const int32 NumCells = Size.X * Size.Y;
+    TArray<FGridCellRecord> Cells;
+    TArray<FGridCellAttributes> Attributes;
+    Cells.SetNum(NumCells);
+    Attributes.SetNum(NumCells);
+    for (int32 Index = 0; Index < NumCells; ++Index)
+    {
+        const TCHAR Char = Chars[Index];
+        FGridCellRecord& Cell = Cells[Index];
+        if (Char == TEXT('.'))
+        {
+            continue;
+        }
+
+        Cell.Flags |= EGridCellFlags::Valid;
+        if (IsWalkableChar(Char))
+        {
+            Cell.Type = EGridCellType::Walkable;
+            Cell.Flags |= EGridCellFlags::Walkable;
+            Attributes[Index].MoveCost = (uint8)(Char - TEXT('0'));
+        }
+        else
+        {
+            Cell.Type = Char == TEXT('~') ? EGridCellType::Water : EGridCellType::Blocked;
+        }
+    }
+
+    // 与烘焙流程一致：格子经由 GridMapAsset 读入，不依赖关卡中的 GridCell
+    MapAsset = NewObject<UGridMapAsset>(GetTransientPackage());
+    MapAsset->SetCells(FIntPoint::ZeroValue, Size, Cells, Attributes);
+
+    GridManager = World->SpawnActor<AGridManager>();
+    GridManager->SetGridMapAsset(MapAsset);
+    GridManager->RebuildCellStore();
+}
+
+TCHAR FGridTestWorld::GetCellChar(FIntPoint Grid) const
+{
+    if (Grid.X < 0 || Grid.Y < 0 || Grid.X >= Size.X || Grid.Y >= Size.Y)
+    {
+        return TEXT('.');
+    }
+    return Chars[Grid.Y * Size.X + Grid.X];
+}
+
+AActor* FGridTestWorld::SpawnOccupant(FIntPoint Grid, int32 FootprintSize)
+{
+    AActor* Actor = World->SpawnActor<AActor>();
+    GridManager->UpdateActorOccupancy(Actor, Grid, FootprintSize);
+    return Actor;
+}
+
+TArray<FString> FGridTestWorld::MakeRandomRows(FIntPoint InSize, float Density, int32 MaxMoveCost, int32 Seed)
+{
+    FRandomStream Random(Seed);
+    TArray<FString> Rows;
+    Rows.Reserve(InSize.Y);
+    for (int32 Y = 0; Y < InSize.Y; ++Y)
+    {
+        FString& Row = Rows.AddDefaulted_GetRef();
+        Row.Reserve(InSize.X);
+        for (int32 X = 0; X < InSize.X; ++X)
+        {
+            Row.AppendChar(Random.FRand() < Density
+                ? TEXT('#')
+                : (TCHAR)(TEXT('0') + Random.RandRange(1, FMath::Clamp(MaxMoveCost, 1, 9))));
+        }
+    }
+    return Rows;
+}
+
+int32 FGridTestWorld::BreadthFirstDistance(FIntPoint InSize, const TBitArray<>& Walkable, FIntPoint Start, FIntPoint Goal)
+{
+    TArray<int32> Distances;
+    Distances.Init(INDEX_NONE, InSize.X * InSize.Y);
+    TArray<FIntPoint> Frontier;
+    Frontier.Add(Start);
+    Distances[Start.Y * InSize.X + Start.X] = 0;
+    for (int32 Head = 0; Head < Frontier.Num(); ++Head)
+    {
+        const FIntPoint Grid = Frontier[Head];
+        const int32 Distance = Distances[Grid.Y * InSize.X + Grid.X];
+        if (Grid == Goal)
+        {
+            return Distance;
+        }
+        FGridTopology4::ForEachNeighbor(Grid, [&](FIntPoint Next, int32)
+        {
+            if (Next.X < 0 || Next.Y < 0 || Next.X >= InSize.X || Next.Y >= InSize.Y)
+            {
+                return;
+            }
+            const int32 NextIndex = Next.Y * InSize.X + Next.X;
+            if (Walkable[NextIndex] && Distances[NextIndex] == INDEX_NONE)
+            {
+                Distances[NextIndex] = Distance + 1;
+                Frontier.Add(Next);
+            }
+        });
+    }
+    return INDEX_NONE;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,60 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class UWorld;
+class AGridManager;
+class UGridMapAsset;
+
+/**
+ * 自动化测试用的临时世界：按字符地图烘焙一个 GridMapAsset，交给新生成的 GridManager 读入
+ * 字符含义：'.' 无格子，'#' 阻挡，'~' 水面（不可行走），'1'~'9' 可行走且移动消耗为该数字
+ * 地图左上角为格子 (0, 0)，X 向右、Y 向下
+ */
+class FGridTestWorld
+{
+public:
+    // 每行一个 Y，所有行等长
+    explicit FGridTestWorld(TConstArrayView<FString> Rows);
+
+    // Size.X x Size.Y 的地图，逐格由 CellAt 给出字符
+    FGridTestWorld(FIntPoint Size, TFunctionRef<TCHAR(FIntPoint Grid)> CellAt);
+
+    ~FGridTestWorld();
+
+    FGridTestWorld(const FGridTestWorld&) = delete;
+    FGridTestWorld& operator=(const FGridTestWorld&) = delete;
+
+    UWorld* GetWorld() const { return World; }
+    AGridManager* GetGridManager() const { return GridManager; }
+    FIntPoint GetSize() const { return Size; }
+
+    // 地图中的原始字符，地图外返回 '.'
+    TCHAR GetCellChar(FIntPoint Grid) const;
+
+    // 生成一个占据 Grid（FootprintSize > 1 时为锚点）的空角色并登记到占位索引
+    AActor* SpawnOccupant(FIntPoint Grid, int32 FootprintSize = 1);
+
+    // 随机地图：Density 为阻挡格比例，可行走格的移动消耗在 [1, MaxMoveCost] 内随机
+    static TArray<FString> MakeRandomRows(FIntPoint Size, float Density, int32 MaxMoveCost, int32 Seed);
+
+    static bool IsWalkableChar(TCHAR Char) { return Char >= TEXT('1') && Char <= TEXT('9'); }
+
+    // 寻路测试的独立参照：在 Walkable（Size 范围内行优先）上做四方向广度优先，返回最短步数，不可达返回 INDEX_NONE
+    static int32 BreadthFirstDistance(FIntPoint Size, const TBitArray<>& Walkable, FIntPoint Start, FIntPoint Goal);
+
+private:
+    void CreateWorld();
+
+    UWorld* World = nullptr;
+    AGridManager* GridManager = nullptr;
+    UGridMapAsset* MapAsset = nullptr;
+    FIntPoint Size = FIntPoint::ZeroValue;
+    TArray<TCHAR> Chars;
+};
+
+#endif
\ No newline at end of file